@@ -0,0 +1,294 @@
+import UIKit
+import CryptoKit
+import Collections
+
+/// A disk cache of decoded thumbnails, stored as raw bitmaps that are memory-mapped
+/// back into `CGImage` without being copied or decoded again.
+///
+/// It sits behind ``MemoryCache``: thumbnails evicted from memory, or lost on relaunch,
+/// can be displayed again without going through ``ImageDecoder``. The files are grouped
+/// in directories by the size of the thumbnail. The least recently used files are
+/// removed once the cache exceeds its byte budget, and files unused for longer than
+/// the maximum age are removed as they are found.
+///
+/// - note: The type is thread-safe because its state and file operations are confined
+/// to a serial queue. Its methods are `async` so that callers never wait on the disk.
+public final class DiskImageCache: @unchecked Sendable {
+
+    /// A shared thumbnail cache used by the entire system.
+    public static let shared = DiskImageCache(
+        directory: FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask)[0]
+            .appendingPathComponent("org.automattic.ImageDownloader.Bitmaps", isDirectory: true)
+    )
+
+    private struct Entry {
+        let fileURL: URL
+        let cost: Int
+        /// The last access recorded on disk, as the modification date of the file.
+        var accessDate: Date
+    }
+
+    private let directory: URL
+    private let sizeLimit: Int
+    private let maxAge: TimeInterval
+    private let queue = DispatchQueue(label: "org.automattic.DiskImageCache", qos: .utility)
+
+    /// The files in the cache, from the least to the most recently used, keyed by file name.
+    private var entries = OrderedDictionary<String, Entry>()
+    private var totalCost = 0
+    private var isIndexLoaded = false
+
+    /// How stale the access date of a file gets before it is updated on disk.
+    private static let accessDateResolution: TimeInterval = 3600
+
+    /// Temporary files older than this are left over by interrupted writes.
+    private static let temporaryFileMaxAge: TimeInterval = 60
+
+    /// - parameters:
+    ///   - directory: The directory the bitmaps are stored in.
+    ///   - sizeLimit: The maximum size of the cache in bytes. By default, 128 MB.
+    ///   - maxAge: How long a bitmap is kept without being used. By default, 7 days.
+    public init(directory: URL, sizeLimit: Int = 128_000_000, maxAge: TimeInterval = 7 * 86400) {
+        self.directory = directory
+        self.sizeLimit = sizeLimit
+        self.maxAge = maxAge
+    }
+
+    // MARK: - Images
+
+    /// Returns the thumbnail stored for the given key, mapping its bitmap into memory.
+    public func image(forKey key: String, size: ImageSize) async -> UIImage? {
+        await perform { $0.cachedImage(forKey: key, size: size) }
+    }
+
+    /// Stores the bitmap of the given thumbnail. Animated images aren't stored.
+    public func setImage(_ image: UIImage, forKey key: String, size: ImageSize) async {
+        guard !(image is AnimatedImage), image.cgImage != nil else {
+            return
+        }
+        await perform { $0.store(image, forKey: key, size: size) }
+    }
+
+    public func removeImage(forKey key: String, size: ImageSize) async {
+        await perform { $0.removeFile(at: $0.makeFileURL(forKey: key, size: size)) }
+    }
+
+    /// Removes every bitmap, e.g. when the user logs out.
+    public func removeAllImages() async {
+        await perform { cache in
+            cache.entries.removeAll()
+            cache.totalCost = 0
+            cache.isIndexLoaded = true
+            try? FileManager.default.removeItem(at: cache.directory)
+        }
+    }
+
+    // MARK: - Private (Queue)
+
+    private func perform<T: Sendable>(_ work: @escaping @Sendable (DiskImageCache) -> T) async -> T {
+        await withCheckedContinuation { continuation in
+            queue.async {
+                continuation.resume(returning: work(self))
+            }
+        }
+    }
+
+    private func cachedImage(forKey key: String, size: ImageSize) -> UIImage? {
+        let fileURL = makeFileURL(forKey: key, size: size)
+        loadIndexIfNeeded()
+        guard var entry = entries.removeValue(forKey: fileURL.lastPathComponent) else {
+            return nil
+        }
+        let now = Date()
+        guard now.timeIntervalSince(entry.accessDate) < maxAge,
+              let image = BitmapFile.read(from: fileURL) else {
+            totalCost -= entry.cost
+            try? FileManager.default.removeItem(at: fileURL)
+            return nil
+        }
+        // Record the access on disk so that the order survives relaunches,
+        // but not on every hit: the order only needs to be approximate.
+        if now.timeIntervalSince(entry.accessDate) > Self.accessDateResolution {
+            entry.accessDate = now
+            try? FileManager.default.setAttributes([.modificationDate: now], ofItemAtPath: fileURL.path)
+        }
+        entries[fileURL.lastPathComponent] = entry
+        return image
+    }
+
+    private func store(_ image: UIImage, forKey key: String, size: ImageSize) {
+        loadIndexIfNeeded()
+        let fileURL = makeFileURL(forKey: key, size: size)
+        guard let cgImage = image.cgImage,
+              let cost = BitmapFile.write(cgImage, scale: image.scale, orientation: image.imageOrientation, to: fileURL) else {
+            return
+        }
+        if let previous = entries.removeValue(forKey: fileURL.lastPathComponent) {
+            totalCost -= previous.cost
+        }
+        entries[fileURL.lastPathComponent] = Entry(fileURL: fileURL, cost: cost, accessDate: Date())
+        totalCost += cost
+        evictIfNeeded()
+    }
+
+    /// Groups the thumbnails by the power of two that fits their largest dimension.
+    private func makeFileURL(forKey key: String, size: ImageSize) -> URL {
+        let dimension = max(64, size.width, size.height)
+        let bucket = 1 << (Int.bitWidth - (dimension - 1).leadingZeroBitCount)
+        let name = SHA256.hash(data: Data(key.utf8)).map { String(format: "%02x", $0) }.joined()
+        return directory
+            .appendingPathComponent(String(bucket), isDirectory: true)
+            .appendingPathComponent(name, isDirectory: false)
+    }
+
+    private func removeFile(at fileURL: URL) {
+        if let entry = entries.removeValue(forKey: fileURL.lastPathComponent) {
+            totalCost -= entry.cost
+        }
+        try? FileManager.default.removeItem(at: fileURL)
+    }
+
+    /// Builds the index from the files left by previous launches, ordered by their last access.
+    private func loadIndexIfNeeded() {
+        guard !isIndexLoaded else {
+            return
+        }
+        isIndexLoaded = true
+
+        let keys: [URLResourceKey] = [.isRegularFileKey, .fileSizeKey, .contentModificationDateKey]
+        guard let enumerator = FileManager.default.enumerator(at: directory, includingPropertiesForKeys: keys) else {
+            return
+        }
+        let now = Date()
+        var files: [(url: URL, cost: Int, date: Date)] = []
+        for case let fileURL as URL in enumerator {
+            guard let values = try? fileURL.resourceValues(forKeys: Set(keys)), values.isRegularFile == true else {
+                continue
+            }
+            let date = values.contentModificationDate ?? .distantPast
+            if !fileURL.pathExtension.isEmpty {
+                // Only remove the temporary files of interrupted writes, not the ones
+                // another cache instance for the same directory is still writing.
+                if now.timeIntervalSince(date) > Self.temporaryFileMaxAge {
+                    try? FileManager.default.removeItem(at: fileURL)
+                }
+                continue
+            }
+            guard now.timeIntervalSince(date) < maxAge else {
+                try? FileManager.default.removeItem(at: fileURL)
+                continue
+            }
+            files.append((fileURL, values.fileSize ?? 0, date))
+        }
+        for file in files.sorted(by: { $0.date < $1.date }) {
+            entries[file.url.lastPathComponent] = Entry(fileURL: file.url, cost: file.cost, accessDate: file.date)
+            totalCost += file.cost
+        }
+        evictIfNeeded()
+    }
+
+    private func evictIfNeeded() {
+        while totalCost > sizeLimit, !entries.isEmpty {
+            let entry = entries.removeFirst().value
+            totalCost -= entry.cost
+            try? FileManager.default.removeItem(at: entry.fileURL)
+        }
+    }
+}
+
+/// The file format of ``DiskImageCache``: the pixels of a 32-bit sRGB bitmap, followed by
+/// a fixed-size trailer describing them. Keeping the pixels at the start of the file lets
+/// the mapped file back the `CGImage` directly.
+private enum BitmapFile {
+    static let magic: UInt32 = 0x5750_424D // "WPBM"
+    static let version: UInt32 = 1
+    static let trailerLength = 8 * MemoryLayout<UInt32>.size
+
+    static func read(from fileURL: URL) -> UIImage? {
+        guard let data = try? NSData(contentsOf: fileURL, options: .alwaysMapped),
+              data.length > trailerLength else {
+            return nil
+        }
+        var trailer = [UInt32](repeating: 0, count: 8)
+        trailer.withUnsafeMutableBytes {
+            data.getBytes($0.baseAddress!, range: NSRange(location: data.length - trailerLength, length: trailerLength))
+        }
+        let values = trailer.map(UInt32.init(littleEndian:))
+        let width = Int(values[2]), height = Int(values[3]), bytesPerRow = Int(values[4])
+        guard values[0] == magic,
+              values[1] == version,
+              width > 0, height > 0,
+              bytesPerRow * height + trailerLength == data.length,
+              let orientation = UIImage.Orientation(rawValue: Int(values[7])),
+              case let scale = CGFloat(Float(bitPattern: values[6])), scale > 0,
+              let provider = CGDataProvider(data: data as CFData),
+              let cgImage = CGImage(
+                width: width,
+                height: height,
+                bitsPerComponent: 8,
+                bitsPerPixel: 32,
+                bytesPerRow: bytesPerRow,
+                space: CGColorSpace(name: CGColorSpace.sRGB)!,
+                bitmapInfo: CGBitmapInfo(rawValue: values[5]),
+                provider: provider,
+                decode: nil,
+                shouldInterpolate: true,
+                intent: .defaultIntent
+              ) else {
+            return nil
+        }
+        return UIImage(cgImage: cgImage, scale: scale, orientation: orientation)
+    }
+
+    /// Writes the bitmap atomically and returns the size of the file, or `nil` if it couldn't be written.
+    static func write(_ image: CGImage, scale: CGFloat, orientation: UIImage.Orientation, to fileURL: URL) -> Int? {
+        let isOpaque = [.none, .noneSkipFirst, .noneSkipLast].contains(image.alphaInfo)
+        let alphaInfo: CGImageAlphaInfo = isOpaque ? .noneSkipFirst : .premultipliedFirst
+        let bitmapInfo = CGBitmapInfo.byteOrder32Little.rawValue | alphaInfo.rawValue
+        guard let context = CGContext(
+            data: nil,
+            width: image.width,
+            height: image.height,
+            bitsPerComponent: 8,
+            bytesPerRow: 0,
+            space: CGColorSpace(name: CGColorSpace.sRGB)!,
+            bitmapInfo: bitmapInfo
+        ), let pixels = context.data else {
+            return nil
+        }
+        context.draw(image, in: CGRect(x: 0, y: 0, width: image.width, height: image.height))
+
+        let trailer = [
+            magic,
+            version,
+            UInt32(image.width),
+            UInt32(image.height),
+            UInt32(context.bytesPerRow),
+            bitmapInfo,
+            Float(scale).bitPattern,
+            UInt32(orientation.rawValue)
+        ].map(\.littleEndian)
+
+        let directory = fileURL.deletingLastPathComponent()
+        let temporaryURL = directory.appendingPathComponent(UUID().uuidString + ".tmp")
+        do {
+            try FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+            guard FileManager.default.createFile(atPath: temporaryURL.path, contents: nil) else {
+                return nil
+            }
+            let handle = try FileHandle(forWritingTo: temporaryURL)
+            defer { try? handle.close() }
+            let length = context.bytesPerRow * context.height
+            try handle.write(contentsOf: Data(bytesNoCopy: pixels, count: length, deallocator: .none))
+            try handle.write(contentsOf: trailer.withUnsafeBytes { Data($0) })
+            guard rename(temporaryURL.path, fileURL.path) == 0 else {
+                try? FileManager.default.removeItem(at: temporaryURL)
+                return nil
+            }
+            return length + trailerLength
+        } catch {
+            try? FileManager.default.removeItem(at: temporaryURL)
+            return nil
+        }
+    }
+}
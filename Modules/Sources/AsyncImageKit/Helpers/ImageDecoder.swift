@@ -1,4 +1,5 @@
 import UIKit
+import ImageIO
 
 public enum ImageDecoder {
     /// Returns an image created from the given URL. The image is decompressed.
@@ -36,6 +37,62 @@ private func _makeImage(from data: Data, size: CGSize?) throws -> UIImage {
     return image
 }
 
+/// Decodes downsampled previews of a JPEG image from its partial data using an
+/// incremental `CGImageSource`. Progressive JPEGs are refined with every preview,
+/// and baseline ones are revealed from the top.
+///
+/// - note: The decoder isn't thread-safe and has to be used serially.
+final class ProgressiveImageDecoder: @unchecked Sendable {
+    private let size: CGSize?
+    private let source = CGImageSourceCreateIncremental(nil)
+    private var isJPEG: Bool?
+
+    /// - parameter size: The desired size of the previews in pixels. If `nil`,
+    ///   the previews are decoded at the size of the image.
+    init(size: CGSize?) {
+        self.size = size
+    }
+
+    /// Returns a preview for the data received so far, or `nil` if there isn't
+    /// enough data to display anything yet.
+    ///
+    /// - parameter data: All the data received so far.
+    func makePreview(from data: Data) -> UIImage? {
+        if isJPEG == nil, data.count >= Data.jpegMagicNumbers.count {
+            isJPEG = data.isMatchingMagicNumbers(Data.jpegMagicNumbers)
+        }
+        guard isJPEG == true else {
+            return nil
+        }
+        CGImageSourceUpdateData(source, data as CFData, false)
+        guard [.statusIncomplete, .statusComplete].contains(CGImageSourceGetStatusAtIndex(source, 0)),
+              let properties = CGImageSourceCopyPropertiesAtIndex(source, 0, nil) as? [CFString: Any],
+              let width = properties[kCGImagePropertyPixelWidth] as? Int,
+              let height = properties[kCGImagePropertyPixelHeight] as? Int,
+              width > 0, height > 0 else {
+            return nil
+        }
+        // Orientations 5 to 8 rotate the image by 90°.
+        let orientation = properties[kCGImagePropertyOrientation] as? UInt32 ?? 1
+        var imageSize = orientation >= 5 ? CGSize(width: height, height: width) : CGSize(width: width, height: height)
+        if let size {
+            imageSize = aspectFillSize(imageSize: imageSize, targetSize: size)
+        }
+        // Caps the decoded bitmap to the target size, so the memory used by
+        // the previews doesn't depend on the size of the original image.
+        let options: [CFString: Any] = [
+            kCGImageSourceCreateThumbnailFromImageAlways: true,
+            kCGImageSourceCreateThumbnailWithTransform: true,
+            kCGImageSourceShouldCacheImmediately: true,
+            kCGImageSourceThumbnailMaxPixelSize: max(imageSize.width, imageSize.height)
+        ]
+        guard let image = CGImageSourceCreateThumbnailAtIndex(source, 0, options as CFDictionary) else {
+            return nil
+        }
+        return UIImage(cgImage: image)
+    }
+}
+
 private func aspectFillSize(imageSize: CGSize, targetSize: CGSize) -> CGSize {
     // Scale image to fill the target size but avoid upscaling
     let scale = min(1, max(targetSize.width / imageSize.width, targetSize.height / imageSize.height))
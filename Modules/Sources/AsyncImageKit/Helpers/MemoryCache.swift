@@ -6,26 +6,80 @@ public protocol MemoryCacheProtocol: AnyObject, Sendable {
     func removeAllObjects()
 }
 
-/// - note: The type is thread-safe because it uses thread-safe `NSCache`.
+/// A memory cache with separate byte budgets for decoded images and raw data,
+/// each evicting the least recently used entries first.
+///
+/// Each pool is split into shards with their own lock, so that lookups from
+/// multiple threads rarely contend. A shard can grow past its share of the budget
+/// while the pool as a whole stays within it, so large entries, such as decoded
+/// originals, are cached too. Only entries larger than the budget of the whole
+/// pool are not. On memory warnings, the pools are trimmed to a fraction of
+/// their budget rather than cleared.
+///
+/// - note: The type is thread-safe because every shard is protected by a lock.
 public final class MemoryCache: MemoryCacheProtocol, @unchecked Sendable {
 
     /// A shared image cache used by the entire system.
     public static let shared = MemoryCache()
 
-    private let cache = NSCache<NSString, AnyObject>()
+    /// Usage statistics of a pool of the cache, accumulated since the cache was created.
+    public struct Statistics: Sendable, Equatable {
+        public var hits = 0
+        public var misses = 0
+        public var evictions = 0
+        public var count = 0
+        /// The total cost of the entries in the pool, in bytes.
+        public var totalCost = 0
+        /// The byte budget of the pool.
+        public var costLimit = 0
+    }
+
+    private let images: ShardedLRUCache<UIImage>
+    private let data: ShardedLRUCache<Data>
+
+    /// The fraction of their budget the pools are trimmed to on memory warnings.
+    private let memoryWarningTrimRatio: Double
 
-    private init() {
-        self.cache.totalCostLimit = 256_000_000 // 256 MB
+    /// - parameters:
+    ///   - imageCostLimit: The budget for decoded images in bytes.
+    ///   - dataCostLimit: The budget for raw data in bytes.
+    ///   - memoryWarningTrimRatio: The fraction of their budget the pools are trimmed to on memory warnings.
+    public init(
+        imageCostLimit: Int = 256_000_000, // 256 MB
+        dataCostLimit: Int = 32_000_000, // 32 MB
+        memoryWarningTrimRatio: Double = 0.25
+    ) {
+        self.images = ShardedLRUCache(costLimit: imageCostLimit)
+        self.data = ShardedLRUCache(costLimit: dataCostLimit)
+        self.memoryWarningTrimRatio = memoryWarningTrimRatio
 
         NotificationCenter.default.addObserver(self, selector: #selector(didReceiveMemoryWarning), name: UIApplication.didReceiveMemoryWarningNotification, object: nil)
     }
 
     @objc private func didReceiveMemoryWarning() {
-        cache.removeAllObjects()
+        trim(toRatio: memoryWarningTrimRatio)
     }
 
     public func removeAllObjects() {
-        cache.removeAllObjects()
+        images.removeAll()
+        data.removeAll()
+    }
+
+    /// Evicts the least recently used entries until each pool uses at most
+    /// the given fraction of its budget.
+    public func trim(toRatio ratio: Double) {
+        images.trim(toRatio: ratio)
+        data.trim(toRatio: ratio)
+    }
+
+    /// Usage statistics of the decoded images pool.
+    public var imageStatistics: Statistics {
+        images.statistics
+    }
+
+    /// Usage statistics of the raw data pool.
+    public var dataStatistics: Statistics {
+        data.statistics
     }
 
     // MARK: - UIImage
@@ -44,29 +98,29 @@ public final class MemoryCache: MemoryCacheProtocol, @unchecked Sendable {
     }
 
     public func setImage(_ image: UIImage, forKey key: String) {
-        cache.setObject(image, forKey: key as NSString, cost: image.cost)
+        images.setValue(image, forKey: key, cost: image.cost)
     }
 
     public func getImage(forKey key: String) -> UIImage? {
-        cache.object(forKey: key as NSString) as? UIImage
+        images.value(forKey: key)
     }
 
     public func removeImage(forKey key: String) {
-        cache.removeObject(forKey: key as NSString)
+        images.removeValue(forKey: key)
     }
 
     // MARK: - Data
 
     public func setData(_ data: Data, forKey key: String) {
-        cache.setObject(data as NSData, forKey: key as NSString, cost: data.count)
+        self.data.setValue(data, forKey: key, cost: data.count)
     }
 
     public func geData(forKey key: String) -> Data? {
-        cache.object(forKey: key as NSString) as? Data
+        data.value(forKey: key)
     }
 
     public func removeData(forKey key: String) {
-        cache.removeObject(forKey: key as NSString)
+        data.removeValue(forKey: key)
     }
 }
 
@@ -78,3 +132,250 @@ private extension UIImage {
         return dataCost + imageCost
     }
 }
+
+// MARK: - LRU
+
+/// An LRU cache split into shards by key, each with its own lock and an equal share of the budget.
+///
+/// The budget is enforced across the whole pool: a shard evicts its own entries first
+/// once it's past its share, and the shards that use the most are trimmed next.
+private final class ShardedLRUCache<Value>: @unchecked Sendable {
+    private let shards: [LRUShard<Value>]
+    private let budget: CostBudget
+
+    init(costLimit: Int, shardCount: Int = 8) {
+        let budget = CostBudget(limit: costLimit)
+        let shardCostLimit = max(1, costLimit / shardCount)
+        self.budget = budget
+        self.shards = (0..<shardCount).map { _ in LRUShard(costLimit: shardCostLimit, budget: budget) }
+    }
+
+    private func shard(forKey key: String) -> LRUShard<Value> {
+        shards[Int(UInt(bitPattern: key.hashValue) % UInt(shards.count))]
+    }
+
+    func value(forKey key: String) -> Value? {
+        shard(forKey: key).value(forKey: key)
+    }
+
+    func setValue(_ value: Value, forKey key: String, cost: Int) {
+        // An entry that can never fit is not stored, rather than evicting the whole pool to make room.
+        guard cost <= budget.limit else {
+            removeValue(forKey: key)
+            return
+        }
+        shard(forKey: key).setValue(value, forKey: key, cost: cost)
+        guard budget.isExceeded else {
+            return
+        }
+        // The shard had room in its share, so evict from the ones that borrowed the most.
+        // Only one shard is locked at a time.
+        for shard in shards.sorted(by: { $0.totalCost > $1.totalCost }) where budget.isExceeded {
+            shard.evict(whileExceeding: budget, keepingKey: key)
+        }
+    }
+
+    func removeValue(forKey key: String) {
+        shard(forKey: key).removeValue(forKey: key)
+    }
+
+    func removeAll() {
+        shards.forEach { $0.removeAll() }
+    }
+
+    func trim(toRatio ratio: Double) {
+        shards.forEach { $0.trim(toCost: Int(Double($0.costLimit) * min(1, max(0, ratio)))) }
+    }
+
+    var statistics: MemoryCache.Statistics {
+        shards.reduce(into: MemoryCache.Statistics()) { result, shard in
+            let statistics = shard.statistics
+            result.hits += statistics.hits
+            result.misses += statistics.misses
+            result.evictions += statistics.evictions
+            result.count += statistics.count
+            result.totalCost += statistics.totalCost
+            result.costLimit += statistics.costLimit
+        }
+    }
+}
+
+/// The total cost of the entries of a pool, shared by its shards.
+private final class CostBudget: @unchecked Sendable {
+    let limit: Int
+
+    private let lock = NSLock()
+    private var totalCost = 0
+
+    init(limit: Int) {
+        self.limit = limit
+    }
+
+    func add(_ cost: Int) {
+        lock.withLock { totalCost += cost }
+    }
+
+    var isExceeded: Bool {
+        lock.withLock { totalCost > limit }
+    }
+}
+
+/// A doubly-linked list of entries ordered from the most to the least recently used,
+/// indexed by key for constant time lookups.
+private final class LRUShard<Value>: @unchecked Sendable {
+    final class Node {
+        let key: String
+        var value: Value
+        var cost: Int
+        weak var previous: Node?
+        var next: Node?
+
+        init(key: String, value: Value, cost: Int) {
+            self.key = key
+            self.value = value
+            self.cost = cost
+        }
+    }
+
+    /// The share of the budget of the pool.
+    let costLimit: Int
+
+    private let budget: CostBudget
+    private let lock = NSLock()
+    private var nodes: [String: Node] = [:]
+    private var head: Node?
+    private var tail: Node?
+    private var _totalCost = 0
+    private var hits = 0
+    private var misses = 0
+    private var evictions = 0
+
+    init(costLimit: Int, budget: CostBudget) {
+        self.costLimit = costLimit
+        self.budget = budget
+    }
+
+    var totalCost: Int {
+        lock.withLock { _totalCost }
+    }
+
+    func value(forKey key: String) -> Value? {
+        lock.withLock {
+            guard let node = nodes[key] else {
+                misses += 1
+                return nil
+            }
+            hits += 1
+            moveToFront(node)
+            return node.value
+        }
+    }
+
+    /// Stores the value, evicting the entries of the shard past its share while the pool is over budget.
+    func setValue(_ value: Value, forKey key: String, cost: Int) {
+        lock.withLock {
+            let node: Node
+            if let existing = nodes[key] {
+                node = existing
+                addCost(cost - node.cost)
+                node.value = value
+                node.cost = cost
+                moveToFront(node)
+            } else {
+                node = Node(key: key, value: value, cost: cost)
+                nodes[key] = node
+                addCost(cost)
+                insertAtFront(node)
+            }
+            while _totalCost > costLimit, budget.isExceeded, let tail, tail !== node {
+                remove(tail)
+                evictions += 1
+            }
+        }
+    }
+
+    /// Evicts the least recently used entries while the pool is over budget.
+    func evict(whileExceeding budget: CostBudget, keepingKey key: String) {
+        lock.withLock {
+            while budget.isExceeded, let tail, tail.key != key {
+                remove(tail)
+                evictions += 1
+            }
+        }
+    }
+
+    func removeValue(forKey key: String) {
+        lock.withLock {
+            if let node = nodes[key] {
+                remove(node)
+            }
+        }
+    }
+
+    func removeAll() {
+        lock.withLock {
+            nodes.removeAll()
+            head = nil
+            tail = nil
+            addCost(-_totalCost)
+        }
+    }
+
+    func trim(toCost cost: Int) {
+        lock.withLock {
+            while _totalCost > cost, let node = tail {
+                remove(node)
+                evictions += 1
+            }
+        }
+    }
+
+    var statistics: MemoryCache.Statistics {
+        lock.withLock {
+            MemoryCache.Statistics(hits: hits, misses: misses, evictions: evictions, count: nodes.count, totalCost: _totalCost, costLimit: costLimit)
+        }
+    }
+
+    // MARK: Linked List
+
+    private func insertAtFront(_ node: Node) {
+        node.next = head
+        head?.previous = node
+        head = node
+        if tail == nil {
+            tail = node
+        }
+    }
+
+    private func moveToFront(_ node: Node) {
+        guard head !== node else {
+            return
+        }
+        unlink(node)
+        insertAtFront(node)
+    }
+
+    private func remove(_ node: Node) {
+        unlink(node)
+        nodes[node.key] = nil
+        addCost(-node.cost)
+    }
+
+    private func addCost(_ cost: Int) {
+        _totalCost += cost
+        budget.add(cost)
+    }
+
+    private func unlink(_ node: Node) {
+        node.previous?.next = node.next
+        node.next?.previous = node.previous
+        if head === node {
+            head = node.next
+        }
+        if tail === node {
+            tail = node.previous
+        }
+        node.previous = nil
+        node.next = nil
+    }
+}
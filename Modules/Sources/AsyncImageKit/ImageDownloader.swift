@@ -6,6 +6,8 @@ public final class ImageDownloader {
     public nonisolated static let shared = ImageDownloader()
 
     private nonisolated let cache: MemoryCacheProtocol
+    private nonisolated let diskCache: DiskImageCache?
+    private let scheduler: ImageRequestScheduler
 
     private let urlSession = URLSession {
         $0.urlCache = nil
@@ -21,10 +23,28 @@ public final class ImageDownloader {
 
     private var tasks: [String: ImageDataTask] = [:]
 
-    public nonisolated init(
-        cache: MemoryCacheProtocol = MemoryCache.shared
+    /// The keys of the tasks the active subscriptions belong to.
+    private var subscriptionKeys: [UUID: String] = [:]
+
+    /// - parameters:
+    ///   - cache: The cache for decompressed images.
+    ///   - diskCache: The cache for decoded thumbnails that outlives the memory cache.
+    ///     Pass `nil` to decode thumbnails again once they are evicted from memory.
+    public nonisolated convenience init(
+        cache: MemoryCacheProtocol = MemoryCache.shared,
+        diskCache: DiskImageCache? = DiskImageCache.shared
+    ) {
+        self.init(cache: cache, diskCache: diskCache, scheduler: ImageRequestScheduler())
+    }
+
+    nonisolated init(
+        cache: MemoryCacheProtocol,
+        diskCache: DiskImageCache?,
+        scheduler: ImageRequestScheduler
     ) {
         self.cache = cache
+        self.diskCache = diskCache
+        self.scheduler = scheduler
     }
 
     public func image(from url: URL, host: MediaHostProtocol? = nil, options: ImageRequestOptions = .init()) async throws -> UIImage {
@@ -32,22 +52,86 @@ public final class ImageDownloader {
     }
 
     public func image(for request: ImageRequest) async throws -> UIImage {
+        try await image(for: request, subscriptionID: UUID())
+    }
+
+    /// Loads the image, and delivers downsampled previews of it while its data
+    /// is downloading, if the request enables ``ImageRequestOptions/isProgressiveDecodingEnabled``.
+    ///
+    /// - parameter onPreview: Called from a background thread with every new preview.
+    ///   It isn't called once the image is returned.
+    public func image(for request: ImageRequest, onPreview: @escaping @Sendable (UIImage) -> Void) async throws -> UIImage {
+        try await image(for: request, subscriptionID: UUID(), onPreview: onPreview)
+    }
+
+    /// Loads the image, identifying the download with the given subscription so
+    /// that its priority can be changed with ``setPriority(_:forSubscription:)``.
+    func image(
+        for request: ImageRequest,
+        subscriptionID: UUID,
+        onPreview: (@Sendable (UIImage) -> Void)? = nil
+    ) async throws -> UIImage {
         let options = request.options
         let key = makeKey(for: request.source.url, size: options.size)
         if options.isMemoryCacheEnabled, let image = cache[key] {
             return image
         }
-        let data = try await data(for: request)
+        // Only thumbnails are worth storing on disk: their bitmaps are small,
+        // and decoding them requires downsampling the original image.
+        let thumbnailCache = options.isDiskCacheEnabled ? diskCache : nil
+        if let thumbnailCache, let size = options.size, let image = await thumbnailCache.image(forKey: key, size: size) {
+            if options.isMemoryCacheEnabled {
+                cache[key] = image
+            }
+            return image
+        }
+        let onPartialData = onPreview.map { onPreview in
+            // Only used from the serial queue of the partial data.
+            let decoder = ProgressiveImageDecoder(size: options.size.map(CGSize.init))
+            return { @Sendable (data: Data) in
+                if let preview = decoder.makePreview(from: data) {
+                    onPreview(preview)
+                }
+            }
+        }
+        let data = try await data(for: request, subscriptionID: subscriptionID, onPartialData: onPartialData)
         let image = try await ImageDecoder.makeImage(from: data, size: options.size.map(CGSize.init))
         if options.isMemoryCacheEnabled {
             cache[key] = image
         }
+        if let thumbnailCache, let size = options.size {
+            Task.detached(priority: .background) {
+                await thumbnailCache.setImage(image, forKey: key, size: size)
+            }
+        }
         return image
     }
 
     public func data(for request: ImageRequest) async throws -> Data {
+        try await data(for: request, subscriptionID: UUID())
+    }
+
+    func data(
+        for request: ImageRequest,
+        subscriptionID: UUID,
+        onPartialData: (@Sendable (Data) -> Void)? = nil
+    ) async throws -> Data {
         let urlRequest = try await makeURLRequest(for: request)
-        return try await _data(for: urlRequest, options: request.options)
+        return try await _data(for: urlRequest, options: request.options, subscriptionID: subscriptionID, onPartialData: onPartialData)
+    }
+
+    /// Changes the priority of an image requested with the given subscription.
+    ///
+    /// The download runs with the highest priority among the requests waiting for it,
+    /// so lowering the priority of one request doesn't affect the others.
+    func setPriority(_ priority: ImageRequestPriority, forSubscription subscriptionID: UUID) {
+        guard let key = subscriptionKeys[subscriptionID],
+              let task = tasks[key],
+              task.subscriptions[subscriptionID] != nil else {
+            return
+        }
+        task.subscriptions[subscriptionID] = priority
+        scheduler.setPriority(task.priority ?? priority, forKey: key)
     }
 
     private func makeURLRequest(for request: ImageRequest) async throws -> URLRequest {
@@ -103,18 +187,37 @@ public final class ImageDownloader {
         self.cache.removeAllObjects()
     }
 
+    public func clearDiskCache() async {
+        await diskCache?.removeAllImages()
+    }
+
     // MARK: - Networking
 
-    private func _data(for request: URLRequest, options: ImageRequestOptions) async throws -> Data {
+    private func _data(
+        for request: URLRequest,
+        options: ImageRequestOptions,
+        subscriptionID: UUID,
+        onPartialData: (@Sendable (Data) -> Void)?
+    ) async throws -> Data {
         let requestKey = request.url?.absoluteString ?? ""
-        let task = tasks[requestKey] ?? ImageDataTask(key: requestKey, Task {
-            try await self._data(for: request, options: options, key: requestKey)
-        })
+        let task = tasks[requestKey] ?? makeTask(for: request, options: options, key: requestKey)
         task.downloader = self
 
-        let subscriptionID = UUID()
-        task.subscriptions.insert(subscriptionID)
+        let previousPriority = task.priority
+        task.subscriptions[subscriptionID] = options.priority
         tasks[requestKey] = task
+        if let previousPriority, let priority = task.priority, priority != previousPriority {
+            scheduler.setPriority(priority, forKey: requestKey)
+        }
+
+        subscriptionKeys[subscriptionID] = requestKey
+        if let onPartialData {
+            task.partialData.addObserver(onPartialData, for: subscriptionID)
+        }
+        defer {
+            subscriptionKeys[subscriptionID] = nil
+            task.partialData.removeObserver(for: subscriptionID)
+        }
 
         return try await task.getData(subscriptionID: subscriptionID)
     }
@@ -127,20 +230,67 @@ public final class ImageDownloader {
 
     private func _unsubscribe(_ subscriptionID: UUID, key: String) {
         guard let task = tasks[key],
-              task.subscriptions.remove(subscriptionID) != nil,
-              task.subscriptions.isEmpty else {
+              task.subscriptions.removeValue(forKey: subscriptionID) != nil else {
+            return
+        }
+        guard let priority = task.priority else {
+            task.task.cancel()
+            tasks[key] = nil
             return
         }
-        task.task.cancel()
-        tasks[key] = nil
+        scheduler.setPriority(priority, forKey: key)
+    }
+
+    private func makeTask(for request: URLRequest, options: ImageRequestOptions, key: String) -> ImageDataTask {
+        // Every download streams its data to the broadcaster, so that progressive
+        // requests joining a download started by another request get previews too.
+        let partialData = PartialDataBroadcaster()
+        return ImageDataTask(key: key, partialData: partialData, Task {
+            try await self._data(for: request, options: options, key: key, partialData: partialData)
+        })
     }
 
-    private func _data(for request: URLRequest, options: ImageRequestOptions, key: String) async throws -> Data {
+    private func _data(
+        for request: URLRequest,
+        options: ImageRequestOptions,
+        key: String,
+        partialData: PartialDataBroadcaster
+    ) async throws -> Data {
         defer { tasks[key] = nil }
+        // Joining requests may have raised the priority since the task was created.
+        let ticket = try await scheduler.start(key: key, priority: tasks[key]?.priority ?? options.priority)
         let session = options.isDiskCacheEnabled ? urlSessionWithCache : urlSession
-        let (data, response) = try await session.data(for: request)
-        try validate(response: response)
-        return data
+        do {
+            let (data, response) = try await Self.streamData(for: request, session: session, delegate: ticket.observer, partialData: partialData)
+            try validate(response: response)
+            scheduler.finish(ticket, bytes: data.count)
+            return data
+        } catch {
+            scheduler.finish(ticket, error: error)
+            throw error
+        }
+    }
+
+    /// Downloads the data in the chunks delivered by `URLSession`, and lets the
+    /// observers of the partial data know as it arrives.
+    private nonisolated static func streamData(
+        for request: URLRequest,
+        session: URLSession,
+        delegate: SessionTaskObserver,
+        partialData: PartialDataBroadcaster
+    ) async throws -> (Data, URLResponse) {
+        let streamingDelegate = StreamingDataDelegate(observer: delegate, partialData: partialData)
+        let task = session.dataTask(with: request)
+        task.delegate = streamingDelegate
+        delegate.urlSession(session, didCreateTask: task)
+        return try await withTaskCancellationHandler {
+            try await withCheckedThrowingContinuation { continuation in
+                streamingDelegate.continuation = continuation
+                task.resume()
+            }
+        } onCancel: {
+            task.cancel()
+        }
     }
 
     private func validate(response: URLResponse) throws {
@@ -156,15 +306,22 @@ public final class ImageDownloader {
 @ImageDownloaderActor
 private final class ImageDataTask {
     let key: String
-    var subscriptions = Set<UUID>()
+    var subscriptions: [UUID: ImageRequestPriority] = [:]
+    let partialData: PartialDataBroadcaster
     let task: Task<Data, Error>
     weak var downloader: ImageDownloader?
 
-    init(key: String, _ task: Task<Data, Error>) {
+    init(key: String, partialData: PartialDataBroadcaster, _ task: Task<Data, Error>) {
         self.key = key
+        self.partialData = partialData
         self.task = task
     }
 
+    /// The highest priority of the subscribed requests, or `nil` if there are none.
+    var priority: ImageRequestPriority? {
+        subscriptions.values.max()
+    }
+
     func getData(subscriptionID: UUID) async throws -> Data {
         try await withTaskCancellationHandler {
             try await task.value
@@ -174,6 +331,206 @@ private final class ImageDataTask {
     }
 }
 
+/// The body of a response, accumulated once as it arrives.
+///
+/// The bytes received so far never change, so ``snapshot()`` shares them without
+/// copying, even while more data is appended. When the buffer runs out of room, the
+/// data moves to a larger one, and the snapshots keep the previous buffer alive.
+private final class ResponseBody: @unchecked Sendable {
+    private final class Storage {
+        let bytes: UnsafeMutableRawPointer
+        let capacity: Int
+
+        init(capacity: Int) {
+            self.capacity = capacity
+            self.bytes = .allocate(byteCount: capacity, alignment: 1)
+        }
+
+        deinit {
+            bytes.deallocate()
+        }
+    }
+
+    private let lock = NSLock()
+    private var storage: Storage
+    private var count = 0
+
+    init(expectedLength: Int64) {
+        let capacity = expectedLength > 0 ? min(Int(expectedLength), 64 * 1024 * 1024) : 64 * 1024
+        storage = Storage(capacity: capacity)
+    }
+
+    var length: Int {
+        lock.withLock { count }
+    }
+
+    func append(_ chunk: Data) {
+        lock.withLock {
+            if count + chunk.count > storage.capacity {
+                let newStorage = Storage(capacity: max(storage.capacity * 2, count + chunk.count))
+                newStorage.bytes.copyMemory(from: storage.bytes, byteCount: count)
+                storage = newStorage
+            }
+            chunk.withUnsafeBytes { buffer in
+                if let baseAddress = buffer.baseAddress {
+                    storage.bytes.advanced(by: count).copyMemory(from: baseAddress, byteCount: buffer.count)
+                }
+            }
+            count += chunk.count
+        }
+    }
+
+    /// Returns the data received so far, without copying it.
+    func snapshot() -> Data {
+        let (storage, count) = lock.withLock { (self.storage, self.count) }
+        guard count > 0 else {
+            return Data()
+        }
+        return Data(bytesNoCopy: storage.bytes, count: count, deallocator: .custom { _, _ in
+            withExtendedLifetime(storage) {}
+        })
+    }
+}
+
+/// Delivers the data received so far to the requests that display previews.
+///
+/// The observers are called on a serial queue owned by the broadcaster, off the
+/// thread that receives the data. Observers decode previews, which is slow, so they
+/// are only called once enough data arrived since the previous preview, and no more
+/// than every `minimumPreviewInterval`. The queue also confines the observers:
+/// ``ProgressiveImageDecoder`` isn't thread-safe.
+///
+/// - note: The type is thread-safe because the observers are protected by a lock,
+/// and the rest of its state is confined to the queue.
+private final class PartialDataBroadcaster: @unchecked Sendable {
+    private let lock = NSLock()
+    private var observers: [UUID: @Sendable (Data) -> Void] = [:]
+
+    private let queue = DispatchQueue(label: "org.automattic.ImageDownloader.partialData", target: .global(qos: .userInitiated))
+    private static let minimumPreviewInterval: TimeInterval = 0.15
+
+    // Confined to `queue`.
+    private var body: ResponseBody?
+    private var expectedLength = 0
+    private var previewInterval = 0
+    private var nextPreviewLength = 0
+    private var lastPreviewTime: CFAbsoluteTime = 0
+
+    func addObserver(_ observer: @escaping @Sendable (Data) -> Void, for subscriptionID: UUID) {
+        lock.withLock { observers[subscriptionID] = observer }
+    }
+
+    func removeObserver(for subscriptionID: UUID) {
+        lock.withLock { observers[subscriptionID] = nil }
+    }
+
+    /// Starts following the body of a response. Only successful responses have previews.
+    func start(with response: URLResponse, body: ResponseBody) {
+        let isSuccessful = (response as? HTTPURLResponse).map { (200..<300).contains($0.statusCode) } ?? true
+        let expectedLength = Int(max(0, response.expectedContentLength))
+        queue.async { [self] in
+            self.body = isSuccessful ? body : nil
+            self.expectedLength = expectedLength
+            // Decoding a preview takes time, so only do it a few times per image.
+            previewInterval = max(64 * 1024, expectedLength / 8)
+            nextPreviewLength = previewInterval
+        }
+    }
+
+    /// Lets the observers know that more data was appended to the body.
+    func didReceiveData() {
+        queue.async { [self] in
+            guard let body else {
+                return
+            }
+            let length = body.length
+            let now = CFAbsoluteTimeGetCurrent()
+            guard length >= nextPreviewLength,
+                  expectedLength == 0 || length < expectedLength,
+                  now - lastPreviewTime >= Self.minimumPreviewInterval else {
+                return
+            }
+            let observers = lock.withLock { Array(self.observers.values) }
+            guard !observers.isEmpty else {
+                return
+            }
+            nextPreviewLength = length + previewInterval
+            lastPreviewTime = now
+            let data = body.snapshot()
+            for observer in observers {
+                observer(data)
+            }
+        }
+    }
+
+    /// Stops the previews.
+    func finish() {
+        queue.async { [self] in
+            body = nil
+        }
+    }
+}
+
+/// Receives the data of a download in the chunks delivered by `URLSession`.
+private final class StreamingDataDelegate: NSObject, URLSessionDataDelegate, @unchecked Sendable {
+    private let observer: SessionTaskObserver
+    private let partialData: PartialDataBroadcaster
+    private let lock = NSLock()
+    private var body: ResponseBody?
+    private var response: URLResponse?
+    private var _continuation: CheckedContinuation<(Data, URLResponse), Error>?
+
+    init(observer: SessionTaskObserver, partialData: PartialDataBroadcaster) {
+        self.observer = observer
+        self.partialData = partialData
+    }
+
+    var continuation: CheckedContinuation<(Data, URLResponse), Error>? {
+        get { lock.withLock { _continuation } }
+        set { lock.withLock { _continuation = newValue } }
+    }
+
+    func urlSession(_ session: URLSession, dataTask: URLSessionDataTask, didReceive data: Data) {
+        let (body, newResponse): (ResponseBody, URLResponse?) = lock.withLock {
+            if let body = self.body {
+                return (body, nil)
+            }
+            let response = dataTask.response
+            let body = ResponseBody(expectedLength: response?.expectedContentLength ?? -1)
+            self.body = body
+            self.response = response
+            return (body, response)
+        }
+        body.append(data)
+        if let newResponse {
+            partialData.start(with: newResponse, body: body)
+        }
+        partialData.didReceiveData()
+    }
+
+    func urlSession(_ session: URLSession, task: URLSessionTask, didFinishCollecting metrics: URLSessionTaskMetrics) {
+        observer.urlSession(session, task: task, didFinishCollecting: metrics)
+    }
+
+    func urlSession(_ session: URLSession, task: URLSessionTask, didCompleteWithError error: Error?) {
+        partialData.finish()
+        let (continuation, body, response) = lock.withLock {
+            defer {
+                _continuation = nil
+                self.body = nil
+            }
+            return (_continuation, self.body, self.response ?? task.response)
+        }
+        if let error {
+            continuation?.resume(throwing: error)
+        } else if let response {
+            continuation?.resume(returning: (body?.snapshot() ?? Data(), response))
+        } else {
+            continuation?.resume(throwing: URLError(.badServerResponse))
+        }
+    }
+}
+
 // MARK: - Helpers
 
 @globalActor
@@ -23,44 +23,77 @@ public final class ImagePrefetcher {
         self.maxConcurrentTasks = maxConcurrentTasks
     }
 
-    public nonisolated func startPrefetching(for requests: [ImageRequest]) {
+    /// Starts prefetching the given images, or changes the priority of the ones
+    /// that are already being prefetched.
+    ///
+    /// - parameter priority: The priority of the downloads. Use ``ImageRequestPriority/speculative``
+    ///   for images that are far from being displayed, e.g. when the list is scrolled quickly.
+    public nonisolated func startPrefetching(for requests: [ImageRequest], priority: ImageRequestPriority = .nearVisible) {
         Task { @ImageDownloaderActor in
             for request in requests {
-                startPrefetching(for: request)
+                startPrefetching(for: request, priority: priority)
             }
             performPendingTasks()
         }
     }
 
-    private func startPrefetching(for request: ImageRequest) {
+    private func startPrefetching(for request: ImageRequest, priority: ImageRequestPriority) {
         let key = PrefetchKey(request: request)
-        guard queue[key] == nil else {
+        guard let task = queue[key] else {
+            queue[key] = PrefetchTask(priority: priority)
             return
         }
-        queue[key] = PrefetchTask()
+        setPriority(priority, for: task)
     }
 
-    private func performPendingTasks() {
-        var index = 0
-        func nextPendingTask() -> (PrefetchKey, PrefetchTask)? {
-            while index < queue.count {
-                if queue.elements[index].value.task == nil {
-                    return queue.elements[index]
+    /// Changes the priority of the images that are being prefetched, e.g. as they
+    /// come closer to the visible area, or move away from it.
+    public nonisolated func setPriority(_ priority: ImageRequestPriority, for requests: [ImageRequest]) {
+        Task { @ImageDownloaderActor in
+            for request in requests {
+                if let task = queue[PrefetchKey(request: request)] {
+                    setPriority(priority, for: task)
                 }
-                index += 1
             }
-            return nil
+            performPendingTasks()
+        }
+    }
+
+    private func setPriority(_ priority: ImageRequestPriority, for task: PrefetchTask) {
+        guard task.priority != priority else {
+            return
+        }
+        task.priority = priority
+        if task.task != nil {
+            downloader.setPriority(priority, forSubscription: task.subscriptionID)
         }
+    }
+
+    private func performPendingTasks() {
         while numberOfActiveTasks < maxConcurrentTasks, let (key, task) = nextPendingTask() {
+            let request = key.request.withPriority(task.priority)
+            let subscriptionID = task.subscriptionID
             task.task = Task {
-                await self.actuallyPrefetchImage(for: key.request)
+                await self.actuallyPrefetchImage(for: request, subscriptionID: subscriptionID)
             }
             numberOfActiveTasks += 1
         }
     }
 
-    private func actuallyPrefetchImage(for request: ImageRequest) async {
-        _ = try? await downloader.image(for: request)
+    /// Returns the pending task with the highest priority, the oldest one first.
+    private func nextPendingTask() -> (PrefetchKey, PrefetchTask)? {
+        var next: (PrefetchKey, PrefetchTask)?
+        for (key, task) in queue where task.task == nil {
+            if let (_, current) = next, current.priority >= task.priority {
+                continue
+            }
+            next = (key, task)
+        }
+        return next
+    }
+
+    private func actuallyPrefetchImage(for request: ImageRequest, subscriptionID: UUID) async {
+        _ = try? await downloader.image(for: request, subscriptionID: subscriptionID)
 
         numberOfActiveTasks -= 1
         queue[PrefetchKey(request: request)] = nil
@@ -93,6 +126,7 @@ public final class ImagePrefetcher {
         }
     }
 
+    /// Identifies the image regardless of the priority it's requested with.
     private struct PrefetchKey: Hashable, Sendable {
         let request: ImageRequest
 
@@ -101,12 +135,19 @@ public final class ImagePrefetcher {
         }
 
         static func == (lhs: PrefetchKey, rhs: PrefetchKey) -> Bool {
-            let (lhs, rhs) = (lhs.request, rhs.request)
-            return (lhs.source.url, lhs.options) == (rhs.source.url, rhs.options)
+            var options = lhs.request.options
+            options.priority = rhs.request.options.priority
+            return (lhs.request.source.url, options) == (rhs.request.source.url, rhs.request.options)
         }
     }
 
     private final class PrefetchTask: @unchecked Sendable {
         var task: Task<Void, Error>?
+        var priority: ImageRequestPriority
+        let subscriptionID = UUID()
+
+        init(priority: ImageRequestPriority) {
+            self.priority = priority
+        }
     }
 }
@@ -25,6 +25,18 @@ public final class ImageRequest: Sendable {
         self.source = .urlRequest(urlRequest)
         self.options = options
     }
+
+    init(source: Source, options: ImageRequestOptions) {
+        self.source = source
+        self.options = options
+    }
+
+    /// Returns the same request with the given priority.
+    func withPriority(_ priority: ImageRequestPriority) -> ImageRequest {
+        var options = options
+        options.priority = priority
+        return ImageRequest(source: source, options: options)
+    }
 }
 
 public struct ImageRequestOptions: Hashable, Sendable {
@@ -35,17 +47,53 @@ public struct ImageRequestOptions: Hashable, Sendable {
     public var isMemoryCacheEnabled = true
 
     /// If enabled, uses `URLSession` preconfigured with a custom `URLCache`
-    /// with a relatively high disk capacity. By default, `true`.
+    /// with a relatively high disk capacity, and stores resized thumbnails
+    /// in ``DiskImageCache``. By default, `true`.
     public var isDiskCacheEnabled = true
 
+    /// The priority of the download. By default, ``ImageRequestPriority/visible``.
+    public var priority: ImageRequestPriority = .visible
+
+    /// If enabled, JPEG images are decoded as their data arrives, and downsampled
+    /// previews are delivered before the download completes. Enable it for large
+    /// images, such as the originals of featured images. By default, `false`.
+    public var isProgressiveDecodingEnabled = false
+
     public init(
         size: ImageSize? = nil,
         isMemoryCacheEnabled: Bool = true,
-        isDiskCacheEnabled: Bool = true
+        isDiskCacheEnabled: Bool = true,
+        priority: ImageRequestPriority = .visible,
+        isProgressiveDecodingEnabled: Bool = false
     ) {
         self.size = size
         self.isMemoryCacheEnabled = isMemoryCacheEnabled
         self.isDiskCacheEnabled = isDiskCacheEnabled
+        self.priority = priority
+        self.isProgressiveDecodingEnabled = isProgressiveDecodingEnabled
+    }
+}
+
+/// The priority of an image download. When the number of downloads in flight
+/// is at its limit, the ones with a higher priority start first.
+public enum ImageRequestPriority: Int, Comparable, Sendable {
+    /// Images that may be needed later, such as the ones well ahead of the scroll position.
+    case speculative
+    /// Images about to be displayed, such as the ones of the cells being prefetched.
+    case nearVisible
+    /// Images displayed on screen.
+    case visible
+
+    public static func < (lhs: ImageRequestPriority, rhs: ImageRequestPriority) -> Bool {
+        lhs.rawValue < rhs.rawValue
+    }
+
+    var sessionTaskPriority: Float {
+        switch self {
+        case .speculative: URLSessionTask.lowPriority
+        case .nearVisible: URLSessionTask.defaultPriority
+        case .visible: URLSessionTask.highPriority
+        }
     }
 }
 
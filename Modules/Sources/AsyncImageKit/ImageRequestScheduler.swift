@@ -0,0 +1,286 @@
+import Foundation
+
+/// Limits the number of image downloads in flight, starting the ones with the
+/// highest ``ImageRequestPriority`` first.
+///
+/// The limit adapts to the network (see ``AdaptiveConcurrencyLimit``), and one slot
+/// is kept out of reach of speculative downloads so that images about to be
+/// displayed don't wait behind them.
+@ImageDownloaderActor
+final class ImageRequestScheduler {
+    /// A download admitted by the scheduler, or waiting to be.
+    @ImageDownloaderActor
+    final class Ticket {
+        let key: String
+        fileprivate(set) var priority: ImageRequestPriority
+        fileprivate let sequence: Int
+        fileprivate var continuation: CheckedContinuation<Void, Error>?
+
+        /// Pass it to `URLSession` so that priority changes reach the session task.
+        let observer: SessionTaskObserver
+
+        fileprivate init(key: String, priority: ImageRequestPriority, sequence: Int) {
+            self.key = key
+            self.priority = priority
+            self.sequence = sequence
+            self.observer = SessionTaskObserver(priority: priority.sessionTaskPriority)
+        }
+    }
+
+    private var concurrency: AdaptiveConcurrencyLimit
+    private var pending: [Ticket] = []
+    private var running: [ObjectIdentifier: Ticket] = [:]
+    private var nextSequence = 0
+
+    nonisolated init(concurrency: AdaptiveConcurrencyLimit = AdaptiveConcurrencyLimit()) {
+        self.concurrency = concurrency
+    }
+
+    /// The current maximum number of downloads in flight.
+    var concurrencyLimit: Int {
+        concurrency.limit
+    }
+
+    var runningCount: Int {
+        running.count
+    }
+
+    var pendingCount: Int {
+        pending.count
+    }
+
+    /// Waits until the download with the given key can start.
+    ///
+    /// Call ``finish(_:bytes:error:)`` with the returned ticket once the download completes.
+    /// Throws `CancellationError` if the calling task is cancelled while waiting.
+    func start(key: String, priority: ImageRequestPriority) async throws -> Ticket {
+        let ticket = Ticket(key: key, priority: priority, sequence: nextSequence)
+        nextSequence += 1
+
+        try await withTaskCancellationHandler {
+            try await withCheckedThrowingContinuation { continuation in
+                guard !Task.isCancelled else {
+                    return continuation.resume(throwing: CancellationError())
+                }
+                ticket.continuation = continuation
+                pending.append(ticket)
+                startPendingRequests()
+            }
+        } onCancel: {
+            Task { @ImageDownloaderActor in
+                self.cancelPending(ticket)
+            }
+        }
+        return ticket
+    }
+
+    /// Frees the slot of a download, and adapts the concurrency limit to its outcome.
+    ///
+    /// Only failures that point to an overloaded network or server, such as timeouts,
+    /// `429` or `5xx`, lower the limit. Other failures, e.g. `404`, say nothing about it.
+    ///
+    /// - parameters:
+    ///   - bytes: The number of bytes received, if the download succeeded.
+    ///   - error: The error the download failed with, if any.
+    func finish(_ ticket: Ticket, bytes: Int? = nil, error: Error? = nil) {
+        guard running.removeValue(forKey: ObjectIdentifier(ticket)) != nil else {
+            return
+        }
+        // Responses from `URLCache` say nothing about the network.
+        if !ticket.observer.isLoadedFromCache {
+            if let error {
+                if error.isCongestion {
+                    concurrency.recordFailure()
+                }
+            } else if let bytes, let timing = ticket.observer.timing {
+                concurrency.recordSuccess(bytes: bytes, timeToFirstByte: timing.timeToFirstByte, duration: timing.duration)
+            }
+        }
+        startPendingRequests()
+    }
+
+    /// Changes the priority of the downloads with the given key, whether they are waiting or in flight.
+    func setPriority(_ priority: ImageRequestPriority, forKey key: String) {
+        for ticket in pending where ticket.key == key {
+            ticket.priority = priority
+        }
+        for ticket in running.values where ticket.key == key {
+            ticket.priority = priority
+            ticket.observer.setPriority(priority.sessionTaskPriority)
+        }
+        startPendingRequests()
+    }
+
+    // MARK: - Private
+
+    private func cancelPending(_ ticket: Ticket) {
+        guard let index = pending.firstIndex(where: { $0 === ticket }) else {
+            return
+        }
+        pending.remove(at: index)
+        ticket.continuation?.resume(throwing: CancellationError())
+        ticket.continuation = nil
+    }
+
+    private func startPendingRequests() {
+        while let index = nextPendingIndex() {
+            let ticket = pending.remove(at: index)
+            running[ObjectIdentifier(ticket)] = ticket
+            ticket.observer.setPriority(ticket.priority.sessionTaskPriority)
+            ticket.continuation?.resume()
+            ticket.continuation = nil
+        }
+    }
+
+    /// Returns the index of the pending download to start next, if there is a slot for it.
+    private func nextPendingIndex() -> Int? {
+        let index = pending.indices.min { lhs, rhs in
+            let (lhs, rhs) = (pending[lhs], pending[rhs])
+            if lhs.priority != rhs.priority {
+                return lhs.priority > rhs.priority
+            }
+            return lhs.sequence < rhs.sequence
+        }
+        guard let index else {
+            return nil
+        }
+        let limit = concurrency.limit
+        let availableSlots = pending[index].priority == .speculative ? max(1, limit - 1) : limit
+        return running.count < availableSlots ? index : nil
+    }
+}
+
+/// An additive-increase/multiplicative-decrease (AIMD) limit on the number of concurrent downloads.
+///
+/// The limit grows by one every time a full window of downloads completes without signs of
+/// congestion. It is halved when a download fails because of congestion, or when the time to
+/// first byte degrades well past the best one observed without the throughput improving, which
+/// means that the extra downloads only compete for the same bandwidth.
+///
+/// The time to first byte doesn't depend on the size of the image, unlike the total duration,
+/// so large downloads aren't mistaken for congestion.
+struct AdaptiveConcurrencyLimit: Sendable {
+    let range: ClosedRange<Int>
+
+    /// How many times slower than the best observed time to first byte a response can be
+    /// before the network is considered congested.
+    let latencyTolerance: Double
+
+    private var value: Double
+    private var baselineLatency: TimeInterval?
+
+    /// The smoothed throughput of the downloads, in bytes per second.
+    private(set) var throughput: Double?
+
+    init(initialLimit: Int = 6, range: ClosedRange<Int> = 2...12, latencyTolerance: Double = 2) {
+        self.range = range
+        self.latencyTolerance = latencyTolerance
+        self.value = Double(min(max(initialLimit, range.lowerBound), range.upperBound))
+    }
+
+    var limit: Int {
+        Int(value)
+    }
+
+    /// - parameters:
+    ///   - timeToFirstByte: The time from sending the request to receiving the first byte of the response.
+    ///   - duration: The time from sending the request to receiving the last byte of the response.
+    mutating func recordSuccess(bytes: Int, timeToFirstByte: TimeInterval, duration: TimeInterval) {
+        let latency = max(timeToFirstByte, 0.001)
+        // Let the baseline drift up slowly so that it follows lasting changes of the network.
+        let baseline = min(latency, (baselineLatency ?? latency) * 1.01)
+        baselineLatency = baseline
+
+        let previousThroughput = throughput
+        let sample = Double(bytes) / max(duration, latency)
+        let throughput = previousThroughput.map { 0.8 * $0 + 0.2 * sample } ?? sample
+        self.throughput = throughput
+
+        if latency > baseline * latencyTolerance && throughput <= (previousThroughput ?? .infinity) {
+            decrease()
+        } else {
+            value = min(Double(range.upperBound), value + 1 / value)
+        }
+    }
+
+    mutating func recordFailure() {
+        decrease()
+    }
+
+    private mutating func decrease() {
+        value = max(Double(range.lowerBound), value / 2)
+    }
+}
+
+/// Applies the priority of a download to its `URLSessionTask`, including once the task is created.
+final class SessionTaskObserver: NSObject, URLSessionTaskDelegate, @unchecked Sendable {
+    private let lock = NSLock()
+    private var task: URLSessionTask?
+    private var priority: Float
+    private var _isLoadedFromCache = false
+    private var _timing: Timing?
+
+    struct Timing {
+        let timeToFirstByte: TimeInterval
+        let duration: TimeInterval
+    }
+
+    init(priority: Float) {
+        self.priority = priority
+    }
+
+    func setPriority(_ priority: Float) {
+        lock.withLock {
+            self.priority = priority
+            task?.priority = priority
+        }
+    }
+
+    func urlSession(_ session: URLSession, didCreateTask task: URLSessionTask) {
+        lock.withLock {
+            self.task = task
+            task.priority = priority
+        }
+    }
+
+    func urlSession(_ session: URLSession, task: URLSessionTask, didFinishCollecting metrics: URLSessionTaskMetrics) {
+        let transaction = metrics.transactionMetrics.last
+        var timing: Timing?
+        if let requestStart = transaction?.requestStartDate,
+           let responseStart = transaction?.responseStartDate,
+           let responseEnd = transaction?.responseEndDate {
+            timing = Timing(
+                timeToFirstByte: responseStart.timeIntervalSince(requestStart),
+                duration: responseEnd.timeIntervalSince(requestStart)
+            )
+        }
+        lock.withLock {
+            _isLoadedFromCache = transaction?.resourceFetchType == .localCache
+            _timing = timing
+        }
+    }
+
+    /// Returns `true` if the response was served by `URLCache` rather than the network.
+    var isLoadedFromCache: Bool {
+        lock.withLock { _isLoadedFromCache }
+    }
+
+    /// The timing of the response, once the task collected its metrics.
+    var timing: Timing? {
+        lock.withLock { _timing }
+    }
+}
+
+private extension Error {
+    /// Returns `true` if the error points to an overloaded network or server.
+    var isCongestion: Bool {
+        switch self {
+        case ImageDownloaderError.unacceptableStatusCode(let statusCode?):
+            return statusCode == 429 || (500..<600).contains(statusCode)
+        case let error as URLError:
+            return [.timedOut, .networkConnectionLost, .cannotConnectToHost].contains(error.code)
+        default:
+            return false
+        }
+    }
+}
@@ -111,7 +111,7 @@ public final class AsyncImageView: UIView {
             case .spinner:
                 makeSpinner().startAnimating()
             }
-        case .success(let image):
+        case .preview(let image), .success(let image):
             self.image = image
             imageView.isHidden = false
             backgroundColor = .clear
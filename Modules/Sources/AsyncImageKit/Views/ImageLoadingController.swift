@@ -8,8 +8,15 @@ public final class ImageLoadingController {
 
     public private(set) var task: Task<Void, Never>?
 
+    /// Identifies the current request so that its previews aren't displayed
+    /// once it completes, or once another image is requested.
+    private var previewRequestID: UUID?
+
     public enum State {
         case loading
+        /// A downsampled preview of the image, displayed while it is downloading.
+        /// See ``ImageRequestOptions/isProgressiveDecodingEnabled``.
+        case preview(UIImage)
         case success(UIImage)
         case failure(Error)
     }
@@ -23,31 +30,54 @@ public final class ImageLoadingController {
     public func prepareForReuse() {
         task?.cancel()
         task = nil
+        previewRequestID = nil
     }
 
     /// - parameter completion: Gets called on completion _after_ `onStateChanged`.
     public func setImage(with request: ImageRequest, completion: (@MainActor (Result<UIImage, Error>) -> Void)? = nil) {
         task?.cancel()
+        previewRequestID = nil
 
         if let image = downloader.cachedImage(for: request) {
             onStateChanged(.success(image))
             completion?(.success(image))
         } else {
             onStateChanged(.loading)
+            let onPreview = makePreviewHandler(for: request)
             task = Task { @MainActor [downloader, weak self] in
                 do {
-                    let image = try await downloader.image(for: request)
+                    let image = if let onPreview {
+                        try await downloader.image(for: request, onPreview: onPreview)
+                    } else {
+                        try await downloader.image(for: request)
+                    }
                     // This line guarantees that if you cancel on the main thread,
                     // none of the `onStateChanged` callbacks get called.
                     guard !Task.isCancelled else { return }
+                    self?.previewRequestID = nil
                     self?.onStateChanged(.success(image))
                     completion?(.success(image))
                 } catch {
                     guard !Task.isCancelled else { return }
+                    self?.previewRequestID = nil
                     self?.onStateChanged(.failure(error))
                     completion?(.failure(error))
                 }
             }
         }
     }
+
+    private func makePreviewHandler(for request: ImageRequest) -> (@Sendable (UIImage) -> Void)? {
+        guard request.options.isProgressiveDecodingEnabled else {
+            return nil
+        }
+        let requestID = UUID()
+        previewRequestID = requestID
+        return { [weak self] preview in
+            Task { @MainActor in
+                guard let self, self.previewRequestID == requestID else { return }
+                self.onStateChanged(.preview(preview))
+            }
+        }
+    }
 }
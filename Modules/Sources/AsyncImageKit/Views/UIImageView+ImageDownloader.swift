@@ -45,7 +45,7 @@ public struct ImageViewExtensions {
         switch state {
         case .loading:
             break
-        case .success(let image):
+        case .preview(let image), .success(let image):
             if let gifView = imageView as? GIFImageView {
                 gifView.configure(image: image)
             } else {
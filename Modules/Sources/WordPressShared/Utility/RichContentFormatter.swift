@@ -93,6 +93,104 @@ import WordPressSharedObjC
         return content
     }
 
+    /// Removes forbidden HTML tags and inline style attributes from the content of a
+    /// reader post. Results are cached by post and content version, so the same content
+    /// of a post is only scanned once.
+    ///
+    /// - Parameters:
+    ///     - string: The content string to format.
+    ///     - postID: An identifier of the post, such as its global ID. The content isn't cached without one.
+    ///
+    /// - Returns: The formatted string.
+    ///
+    @objc(sanitizeReaderPostContent:forPostWithID:)
+    public class func sanitizeReaderPostContent(_ string: String, forPostWithID postID: String?) -> String {
+        guard !string.isEmpty else {
+            return string
+        }
+        guard let postID else {
+            return removeForbiddenTagsAndInlineStyles(string)
+        }
+
+        let key = SanitizedContentCache.key(forPostWithID: postID, content: string)
+        if let cached = SanitizedContentCache.shared.object(forKey: key) {
+            return cached as String
+        }
+
+        let content = removeForbiddenTagsAndInlineStyles(string)
+        SanitizedContentCache.shared.setObject(content as NSString, forKey: key, cost: (content as NSString).length * MemoryLayout<unichar>.size)
+        return content
+    }
+
+    /// Sanitizes the content of a batch of reader posts concurrently, off the calling thread,
+    /// so that `sanitizeReaderPostContent` finds the results in the cache when the posts are merged.
+    ///
+    /// - Parameters:
+    ///     - contents: The content strings to format, keyed by the identifier of their post.
+    ///     - completion: Called on a background queue once every string is sanitized.
+    ///
+    @objc public class func prepareReaderPostContents(_ contents: [String: String], completion: @escaping () -> Void) {
+        let contents = Array(contents)
+        DispatchQueue.global(qos: .userInitiated).async {
+            DispatchQueue.concurrentPerform(iterations: contents.count) { index in
+                _ = sanitizeReaderPostContent(contents[index].value, forPostWithID: contents[index].key)
+            }
+            completion()
+        }
+    }
+
+    /// Removes style and script blocks, Gutenberg block comments and inline style attributes
+    /// in a single scan. For well-formed markup the result is the same as calling
+    /// `removeForbiddenTags` followed by `removeInlineStyles`.
+    ///
+    /// - Parameters:
+    ///     - string: The content string to format.
+    ///
+    /// - Returns: The formatted string.
+    ///
+    @objc public class func removeForbiddenTagsAndInlineStyles(_ string: String) -> String {
+        var scanner = ContentScanner(source: Array(string.utf16))
+        let source = scanner.source
+        var output = [UInt16]()
+        output.reserveCapacity(source.count)
+
+        var index = 0
+        while index < source.count {
+            let char = source[index]
+            if char == ContentScanner.lessThan, let end = scanner.endOfForbiddenBlock(at: index) {
+                index = end
+                continue
+            }
+
+            if ContentScanner.isWhitespace(char) {
+                if let end = scanner.endOfStyleAttribute(at: index) {
+                    index = end
+                    continue
+                }
+                // No later whitespace in this run starts a style attribute either, so copy the run as a whole.
+                while index < source.count && ContentScanner.isWhitespace(source[index]) {
+                    output.append(source[index])
+                    index += 1
+                }
+                continue
+            }
+
+            if char == ContentScanner.lowercaseS || char == ContentScanner.uppercaseS,
+               let end = scanner.endOfStyleAttribute(at: index) {
+                index = end
+                continue
+            }
+
+            output.append(char)
+            index += 1
+        }
+
+        guard output.count != source.count else {
+            return string
+        }
+        return String(decoding: output, as: UTF16.self)
+    }
+
     /// Converts DIV tags to P tags and removes duplicate or redundant tags.
     ///
     /// - Parameters:
@@ -358,3 +456,197 @@ import WordPressSharedObjC
         return mString as String
     }
 }
+
+/// Caches the sanitized content of reader posts, keyed by post and content version.
+///
+private enum SanitizedContentCache {
+    static let shared: NSCache<NSString, NSString> = {
+        let cache = NSCache<NSString, NSString>()
+        cache.totalCostLimit = 32 * 1024 * 1024
+        return cache
+    }()
+
+    /// Identifies a version of the content of a post without keeping the original content around.
+    static func key(forPostWithID postID: String, content: String) -> NSString {
+        "\(postID)-\(content.utf16.count)-\(content.hashValue)" as NSString
+    }
+}
+
+/// UTF-16 matching helpers mirroring the forbidden tag and inline style expressions in `RichContentFormatter.RegEx`.
+///
+private struct ContentScanner {
+    static let lessThan = UInt16(ascii: "<")
+    static let greaterThan = UInt16(ascii: ">")
+    static let quote = UInt16(ascii: "\"")
+    static let newLine = UInt16(ascii: "\n")
+    static let lowercaseS = UInt16(ascii: "s")
+    static let uppercaseS = UInt16(ascii: "S")
+
+    static let styleOpen = Array("<style".utf16)
+    static let styleClose = Array("</style>".utf16)
+    static let scriptOpen = Array("<script".utf16)
+    static let scriptClose = Array("</script>".utf16)
+    static let gutenbergCommentOpen = Array("<p><!-- ".utf16)
+    static let gutenbergCommentName = Array("wp:".utf16)
+    static let gutenbergCommentClose = Array(" --></p>".utf16)
+    static let gutenbergSelfClosingCommentClose = Array(" /--></p>".utf16)
+    static let styleAttribute = Array("style=\"".utf16)
+
+    /// The result of the last search for a terminator, such as a closing tag.
+    ///
+    /// A later search from anywhere between the start of the last one and its match finds the same match,
+    /// and a search past the start of a failed one fails too. Reusing the results keeps content with many
+    /// unterminated blocks from being scanned to the end over and over.
+    private struct Search {
+        var start: Int
+        var match: Int?
+
+        func result(from index: Int) -> Int?? {
+            guard index >= start else {
+                return nil
+            }
+            guard let match else {
+                return .some(nil)
+            }
+            return index <= match ? .some(match) : nil
+        }
+    }
+
+    let source: [UInt16]
+    private var searches: [[UInt16]: Search] = [:]
+
+    init(source: [UInt16]) {
+        self.source = source
+    }
+
+    /// Matches `\s` as defined by ICU: `[\t\n\f\r\p{Z}]`.
+    static func isWhitespace(_ char: UInt16) -> Bool {
+        switch char {
+        case 0x09, 0x0A, 0x0C, 0x0D, 0x20, 0xA0, 0x1680, 0x2000...0x200A, 0x2028, 0x2029, 0x202F, 0x205F, 0x3000:
+            return true
+        default:
+            return false
+        }
+    }
+
+    /// Case-insensitively matches a lowercase ASCII pattern at the given index.
+    func hasPrefix(_ pattern: [UInt16], at index: Int) -> Bool {
+        guard index + pattern.count <= source.count else {
+            return false
+        }
+        for offset in 0..<pattern.count {
+            var char = source[index + offset]
+            if char >= 0x41 && char <= 0x5A {
+                char += 0x20
+            }
+            if char != pattern[offset] {
+                return false
+            }
+        }
+        return true
+    }
+
+    func firstIndex(of pattern: [UInt16], from index: Int) -> Int? {
+        var position = index
+        while position + pattern.count <= source.count {
+            if source[position] == pattern[0] && hasPrefix(pattern, at: position) {
+                return position
+            }
+            position += 1
+        }
+        return nil
+    }
+
+    /// Like `firstIndex(of:from:)`, reusing the result of the previous search for the same pattern.
+    private mutating func firstIndexReusingSearches(of pattern: [UInt16], from index: Int) -> Int? {
+        if let result = searches[pattern]?.result(from: index) {
+            return result
+        }
+        let match = firstIndex(of: pattern, from: index)
+        searches[pattern] = Search(start: index, match: match)
+        return match
+    }
+
+    /// Returns the index past a `<style>`, `<script>` or Gutenberg comment block starting at `index`.
+    mutating func endOfForbiddenBlock(at index: Int, includingGutenbergComments: Bool = true) -> Int? {
+        if hasPrefix(Self.styleOpen, at: index) {
+            return endOfBlock(at: index + Self.styleOpen.count, closingTag: Self.styleClose)
+        }
+        if hasPrefix(Self.scriptOpen, at: index) {
+            return endOfBlock(at: index + Self.scriptOpen.count, closingTag: Self.scriptClose)
+        }
+        if includingGutenbergComments && hasPrefix(Self.gutenbergCommentOpen, at: index) {
+            return endOfGutenbergComment(at: index + Self.gutenbergCommentOpen.count)
+        }
+        return nil
+    }
+
+    /// Skips the blocks that the sequential expressions would already have removed by the time
+    /// the next expression runs, so that matches can span them like they do in `RichContentFormatter.RegEx`.
+    mutating func skipRemovedBlocks(from index: Int, includingWhitespace: Bool, includingGutenbergComments: Bool) -> Int {
+        var position = index
+        while position < source.count {
+            if includingWhitespace && Self.isWhitespace(source[position]) {
+                position += 1
+            } else if source[position] == Self.lessThan,
+                      let end = endOfForbiddenBlock(at: position, includingGutenbergComments: includingGutenbergComments) {
+                position = end
+            } else {
+                break
+            }
+        }
+        return position
+    }
+
+    /// Matches `[^>]*?>[\s\S]*?` followed by the closing tag.
+    private mutating func endOfBlock(at index: Int, closingTag: [UInt16]) -> Int? {
+        guard let tagEnd = firstIndexReusingSearches(of: [Self.greaterThan], from: index),
+              let closeStart = firstIndexReusingSearches(of: closingTag, from: tagEnd + 1) else {
+            return nil
+        }
+        return closeStart + closingTag.count
+    }
+
+    /// Matches `/?wp:.+? /?--></p>[\n]?`.
+    mutating func endOfGutenbergComment(at index: Int) -> Int? {
+        var position = index
+        if position < source.count && source[position] == UInt16(ascii: "/") {
+            position += 1
+        }
+        guard hasPrefix(Self.gutenbergCommentName, at: position) else {
+            return nil
+        }
+        position += Self.gutenbergCommentName.count
+
+        // `.+?` needs at least one character and never crosses a line break.
+        guard position < source.count, source[position] != Self.newLine else {
+            return nil
+        }
+        position += 1
+
+        while position < source.count && source[position] != Self.newLine {
+            var closeLength = 0
+            if hasPrefix(Self.gutenbergCommentClose, at: position) {
+                closeLength = Self.gutenbergCommentClose.count
+            } else if hasPrefix(Self.gutenbergSelfClosingCommentClose, at: position) {
+                closeLength = Self.gutenbergSelfClosingCommentClose.count
+            }
+            if closeLength > 0 {
+                let end = skipRemovedBlocks(from: position + closeLength, includingWhitespace: false, includingGutenbergComments: false)
+                return end < source.count && source[end] == Self.newLine ? end + 1 : end
+            }
+            position += 1
+        }
+        return nil
+    }
+
+    /// Matches `\s*style="[^"]*"`.
+    mutating func endOfStyleAttribute(at index: Int) -> Int? {
+        let position = skipRemovedBlocks(from: index, includingWhitespace: true, includingGutenbergComments: true)
+        guard hasPrefix(Self.styleAttribute, at: position),
+              let closingQuote = firstIndexReusingSearches(of: [Self.quote], from: position + Self.styleAttribute.count) else {
+            return nil
+        }
+        return closingQuote + 1
+    }
+}
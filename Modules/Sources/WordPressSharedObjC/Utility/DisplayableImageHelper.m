@@ -1,5 +1,4 @@
 #import "DisplayableImageHelper.h"
-#import "NSString+Util.h"
 
 static const NSInteger FeaturedImageMinimumWidth = 150;
 
@@ -7,6 +6,219 @@ static NSString * const AttachmentsDictionaryKeyWidth = @"width";
 static NSString * const AttachmentsDictionaryKeyURL = @"URL";
 static NSString * const AttachmentsDictionaryKeyMimeType = @"mime_type";
 
+#pragma mark - Content Scanning
+
+/// The attributes of an img tag or a gallery shortcode, as ranges of the scanned content.
+/// Missing attributes have a location of NSNotFound.
+typedef struct {
+    NSRange src;
+    NSRange className;
+    NSRange width;
+    NSRange ids;
+} DisplayableImageAttributes;
+
+/// An img tag found in the content.
+typedef struct {
+    NSRange src;
+    NSRange className;
+    NSInteger width;
+} DisplayableImageTag;
+
+static inline BOOL DisplayableImageIsSpace(unichar c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+}
+
+static inline unichar DisplayableImageLowercase(unichar c)
+{
+    return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+/// Returns YES if the characters in `range` are the ASCII `token`, ignoring case.
+static BOOL DisplayableImageRangeEquals(const unichar *chars, NSRange range, const char *token)
+{
+    size_t tokenLength = strlen(token);
+    if (range.length != tokenLength) {
+        return NO;
+    }
+    for (NSUInteger i = 0; i < tokenLength; i++) {
+        if (DisplayableImageLowercase(chars[range.location + i]) != (unichar)token[i]) {
+            return NO;
+        }
+    }
+    return YES;
+}
+
+/// Returns YES if `token` is found at `index` ignoring case, and is followed by whitespace or `terminator`.
+static BOOL DisplayableImageHasTagName(const unichar *chars, NSUInteger length, NSUInteger index, const char *token, unichar terminator)
+{
+    NSUInteger end = index + strlen(token);
+    if (end >= length || !DisplayableImageRangeEquals(chars, NSMakeRange(index, end - index), token)) {
+        return NO;
+    }
+    return DisplayableImageIsSpace(chars[end]) || chars[end] == terminator || chars[end] == '/';
+}
+
+/// Parses the leading digits of the characters in `range`, ignoring leading whitespace.
+static long long DisplayableImageIntegerValue(const unichar *chars, NSRange range)
+{
+    NSUInteger i = range.location;
+    NSUInteger end = NSMaxRange(range);
+    while (i < end && DisplayableImageIsSpace(chars[i])) {
+        i++;
+    }
+    long long value = 0;
+    for (NSUInteger digits = 0; i < end && chars[i] >= '0' && chars[i] <= '9' && digits < 18; i++, digits++) {
+        value = value * 10 + (chars[i] - '0');
+    }
+    return value;
+}
+
+/// Scans the attributes of a tag starting at `index` up to `terminator`, keeping the first value of each
+/// attribute of interest. Returns the index following the terminator, or `length` if the tag isn't closed.
+static NSUInteger DisplayableImageScanAttributes(const unichar *chars, NSUInteger length, NSUInteger index, unichar terminator, DisplayableImageAttributes *attributes)
+{
+    NSRange notFound = NSMakeRange(NSNotFound, 0);
+    *attributes = (DisplayableImageAttributes){ notFound, notFound, notFound, notFound };
+
+    NSUInteger i = index;
+    while (i < length) {
+        unichar c = chars[i];
+        if (c == terminator) {
+            return i + 1;
+        }
+        if (DisplayableImageIsSpace(c) || c == '/' || c == '=') {
+            i++;
+            continue;
+        }
+
+        NSUInteger nameStart = i;
+        while (i < length && !DisplayableImageIsSpace(chars[i]) && chars[i] != '=' && chars[i] != terminator && chars[i] != '/') {
+            i++;
+        }
+        NSRange name = NSMakeRange(nameStart, i - nameStart);
+
+        while (i < length && DisplayableImageIsSpace(chars[i])) {
+            i++;
+        }
+        if (i >= length || chars[i] != '=') {
+            // An attribute without a value.
+            continue;
+        }
+        i++;
+        while (i < length && DisplayableImageIsSpace(chars[i])) {
+            i++;
+        }
+
+        NSRange value;
+        if (i < length && (chars[i] == '"' || chars[i] == '\'')) {
+            unichar quote = chars[i++];
+            NSUInteger valueStart = i;
+            while (i < length && chars[i] != quote) {
+                i++;
+            }
+            value = NSMakeRange(valueStart, i - valueStart);
+            if (i < length) {
+                i++;
+            }
+        } else {
+            NSUInteger valueStart = i;
+            while (i < length && !DisplayableImageIsSpace(chars[i]) && chars[i] != terminator) {
+                i++;
+            }
+            value = NSMakeRange(valueStart, i - valueStart);
+        }
+
+        if (attributes->src.location == NSNotFound && DisplayableImageRangeEquals(chars, name, "src")) {
+            attributes->src = value;
+        } else if (attributes->className.location == NSNotFound && DisplayableImageRangeEquals(chars, name, "class")) {
+            attributes->className = value;
+        } else if (attributes->width.location == NSNotFound && DisplayableImageRangeEquals(chars, name, "width")) {
+            attributes->width = value;
+        } else if (attributes->ids.location == NSNotFound && DisplayableImageRangeEquals(chars, name, "ids")) {
+            attributes->ids = value;
+        }
+    }
+    return length;
+}
+
+/// Adds the comma separated ids in `range` to `ids`, skipping empty entries.
+static void DisplayableImageAddGalleryIds(const unichar *chars, NSRange range, NSMutableSet *ids)
+{
+    NSUInteger i = range.location;
+    NSUInteger end = NSMaxRange(range);
+    while (i < end) {
+        NSUInteger idStart = i;
+        while (i < end && chars[i] != ',') {
+            i++;
+        }
+        NSRange idRange = NSMakeRange(idStart, i - idStart);
+        long long value = DisplayableImageIntegerValue(chars, idRange);
+        if (value > 0) {
+            [ids addObject:[NSNumber numberWithUnsignedLongLong:value]];
+        }
+        i++;
+    }
+}
+
+/// Returns the value of the `w` query parameter of the src in `range`, or 0.
+/// HTML-escaped separators (`&amp;`) are supported.
+static NSInteger DisplayableImageQueryWidth(const unichar *chars, NSRange range)
+{
+    NSUInteger i = range.location;
+    NSUInteger end = NSMaxRange(range);
+    while (i < end && chars[i] != '?') {
+        i++;
+    }
+    while (i < end && chars[i] != '#') {
+        // Skip the separator, then read a `name=value` pair.
+        i++;
+        if (i + 4 <= end && DisplayableImageRangeEquals(chars, NSMakeRange(i, 4), "amp;")) {
+            i += 4;
+        }
+        NSUInteger nameStart = i;
+        while (i < end && chars[i] != '=' && chars[i] != '&' && chars[i] != '#') {
+            i++;
+        }
+        NSRange name = NSMakeRange(nameStart, i - nameStart);
+        NSUInteger valueStart = i < end && chars[i] == '=' ? i + 1 : i;
+        while (i < end && chars[i] != '&' && chars[i] != '#') {
+            i++;
+        }
+        if (name.length == 1 && chars[name.location] == 'w') {
+            return (NSInteger)DisplayableImageIntegerValue(chars, NSMakeRange(valueStart, i - valueStart));
+        }
+    }
+    return 0;
+}
+
+#pragma mark - Attachment Sorting
+
+typedef struct {
+    NSInteger width;
+    NSUInteger index;
+} DisplayableImageAttachmentWidth;
+
+static int DisplayableImageCompareAttachmentWidths(const void *a, const void *b)
+{
+    const DisplayableImageAttachmentWidth *lhs = a;
+    const DisplayableImageAttachmentWidth *rhs = b;
+    // Widest first, keeping the original order of attachments of the same width.
+    if (lhs->width != rhs->width) {
+        return lhs->width > rhs->width ? -1 : 1;
+    }
+    return lhs->index < rhs->index ? -1 : (lhs->index > rhs->index ? 1 : 0);
+}
+
+@interface DisplayableImageContent ()
+@property (nonatomic, copy, readwrite) NSString *imageToDisplay;
+@property (nonatomic, copy, readwrite) NSArray<NSString *> *imageSources;
+@property (nonatomic, copy, readwrite) NSSet<NSNumber *> *galleryAttachmentIds;
+@end
+
+@implementation DisplayableImageContent
+@end
+
 @implementation DisplayableImageHelper
 
 + (NSInteger)widthOfAttachment:(NSDictionary *)attachment {
@@ -16,8 +228,12 @@ static NSString * const AttachmentsDictionaryKeyMimeType = @"mime_type";
         NSNumber *number = (NSNumber *)obj;
         result = [number integerValue];
     } else if ([obj isKindOfClass:NSString.class]) {
-        NSNumberFormatter *numberFormatter = [[NSNumberFormatter alloc] init];
-        numberFormatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
+        static NSNumberFormatter *numberFormatter;
+        static dispatch_once_t onceToken;
+        dispatch_once(&onceToken, ^{
+            numberFormatter = [[NSNumberFormatter alloc] init];
+            numberFormatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
+        });
         NSNumber *number= [numberFormatter numberFromString:(NSString *)obj];
         result = [number integerValue];
     }
@@ -65,43 +281,95 @@ static NSString * const AttachmentsDictionaryKeyMimeType = @"mime_type";
 
 + (NSArray *)sortAttachmentsArray:(NSArray *)attachments
 {
-    return [attachments sortedArrayUsingComparator:^NSComparisonResult(NSDictionary *attachmentA, NSDictionary *attachmentB) {        
-        NSInteger widthA = [self widthOfAttachment:attachmentA];
-        NSInteger widthB = [self widthOfAttachment:attachmentB];
-
-        if (widthA < widthB) {
-            return NSOrderedDescending;
-        } else if (widthA > widthB) {
-            return NSOrderedAscending;
-        } else {
-            return NSOrderedSame;
-        }
-    }];
+    // Read each width once rather than on every comparison.
+    NSUInteger count = [attachments count];
+    if (count < 2) {
+        return attachments;
+    }
+    DisplayableImageAttachmentWidth *widths = malloc(count * sizeof(DisplayableImageAttachmentWidth));
+    for (NSUInteger i = 0; i < count; i++) {
+        widths[i] = (DisplayableImageAttachmentWidth){ [self widthOfAttachment:attachments[i]], i };
+    }
+    qsort(widths, count, sizeof(DisplayableImageAttachmentWidth), DisplayableImageCompareAttachmentWidths);
+
+    NSMutableArray *sorted = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++) {
+        [sorted addObject:attachments[widths[i].index]];
+    }
+    free(widths);
+    return sorted;
 }
 
-+ (NSString *)searchPostContentForImageToDisplay:(NSString *)content
++ (DisplayableImageContent *)scanPostContent:(NSString *)content
 {
-    NSString *imageSrc = @"";
-    // If there is no image tag in the content, just bail.
-    if (!content || [content rangeOfString:@"<img"].location == NSNotFound) {
-        return imageSrc;
+    NSUInteger length = [content length];
+    NSMutableData *tagsData = [NSMutableData data];
+    NSMutableSet *galleryIds = [NSMutableSet set];
+
+    const unichar *chars = length > 0 ? CFStringGetCharactersPtr((__bridge CFStringRef)content) : NULL;
+    unichar *buffer = NULL;
+    if (length > 0 && !chars) {
+        buffer = malloc(length * sizeof(unichar));
+        [content getCharacters:buffer range:NSMakeRange(0, length)];
+        chars = buffer;
     }
 
-    // Get all the things
-    static NSRegularExpression *regex;
-    static dispatch_once_t onceToken;
-    dispatch_once(&onceToken, ^{
-        NSError *error;
-        NSString *imgPattern = @"<img(\\s+.*?)(?:src\\s*=\\s*(?:'|\")(.*?)(?:'|\"))(.*?)>";
-        regex = [NSRegularExpression regularExpressionWithPattern:imgPattern options:NSRegularExpressionCaseInsensitive error:&error];
-    });
+    // A single pass over the content, tokenizing img tags and gallery shortcodes as they come.
+    NSUInteger i = 0;
+    while (i < length) {
+        unichar c = chars[i];
+        if (c == '<' && DisplayableImageHasTagName(chars, length, i + 1, "img", '>')) {
+            DisplayableImageAttributes attributes;
+            i = DisplayableImageScanAttributes(chars, length, i + 4, '>', &attributes);
+            if (attributes.src.location != NSNotFound && attributes.src.length > 0) {
+                DisplayableImageTag tag = {
+                    attributes.src,
+                    attributes.className,
+                    attributes.width.location != NSNotFound ? (NSInteger)DisplayableImageIntegerValue(chars, attributes.width) : 0
+                };
+                [tagsData appendBytes:&tag length:sizeof(DisplayableImageTag)];
+            }
+        } else if (c == '[' && DisplayableImageHasTagName(chars, length, i + 1, "gallery", ']')) {
+            DisplayableImageAttributes attributes;
+            i = DisplayableImageScanAttributes(chars, length, i + 8, ']', &attributes);
+            if (attributes.ids.location != NSNotFound) {
+                DisplayableImageAddGalleryIds(chars, attributes.ids, galleryIds);
+            }
+        } else {
+            i++;
+        }
+    }
 
-    // Find all the image tags in the content passed.
-    NSArray *matches = [regex matchesInString:content options:0 range:NSMakeRange(0, [content length])];
+    const DisplayableImageTag *tags = tagsData.bytes;
+    NSUInteger tagCount = tagsData.length / sizeof(DisplayableImageTag);
+    NSMutableArray<NSString *> *sources = [NSMutableArray arrayWithCapacity:tagCount];
+    for (NSUInteger t = 0; t < tagCount; t++) {
+        [sources addObject:[content substringWithRange:tags[t].src]];
+    }
 
-    for (NSTextCheckingResult *match in matches) {
-        NSString *tag = [content substringWithRange:match.range];
-        NSString *src = [self extractSrcFromImgTag:tag];
+    DisplayableImageContent *result = [DisplayableImageContent new];
+    result.imageSources = sources;
+    result.galleryAttachmentIds = galleryIds;
+    result.imageToDisplay = [self imageToDisplayFromTags:tags sources:sources characters:chars content:content];
+
+    free(buffer);
+    return result;
+}
+
+/**
+ Choose the image to feature among the scanned img tags.
+
+ @details The first image wider than `FeaturedImageMinimumWidth`, per its width attribute or its
+ `w` query parameter, wins. Otherwise the first full, large or medium sized image is used, in that order.
+ */
++ (NSString *)imageToDisplayFromTags:(const DisplayableImageTag *)tags
+                             sources:(NSArray<NSString *> *)sources
+                          characters:(const unichar *)chars
+                             content:(NSString *)content
+{
+    NSUInteger count = [sources count];
+    for (NSUInteger t = 0; t < count; t++) {
+        NSString *src = sources[t];
 
         // Ignore WordPress emoji images
         if ([src rangeOfString:@"/images/core/emoji/"].location != NSNotFound ||
@@ -115,167 +383,35 @@ static NSString * const AttachmentsDictionaryKeyMimeType = @"mime_type";
             continue;
         }
 
-        // Check the tag for a good width
-        NSInteger width = MAX([self widthFromElementAttribute:tag], [self widthFromQueryString:src]);
+        NSInteger width = MAX(tags[t].width, DisplayableImageQueryWidth(chars, tags[t].src));
         if (width > FeaturedImageMinimumWidth) {
-            imageSrc = src;
-            break;
+            return src;
         }
     }
-    if (imageSrc.length == 0) {
-        imageSrc = [self searchContentBySizeClassForImageToFeature:content];
-    }
-
-    return imageSrc;
-}
-
-+ (NSSet *)searchPostContentForAttachmentIdsInGalleries:(NSString *)content
-{
-    NSMutableSet *resultSet = [NSMutableSet set];
-    // If there is no gallery shortcode in the content, just bail.
-    if (!content || [content rangeOfString:@"[gallery "].location == NSNotFound) {
-        return resultSet;
-    }
-
-    // Get all the things
-    static NSRegularExpression *regexGallery;
-    static dispatch_once_t onceTokenRegexGallery;
-    dispatch_once(&onceTokenRegexGallery, ^{
-        NSError *error;
-        NSString *galleryPattern = @"\\[gallery[^]]+ids=\"([0-9,]*)\"[^]]*\\]";
-        regexGallery = [NSRegularExpression regularExpressionWithPattern:galleryPattern options:NSRegularExpressionCaseInsensitive error:&error];
-    });
 
-    // Find all the gallery shortcodes in the content passed.
-    NSArray *matches = [regexGallery matchesInString:content options:0 range:NSMakeRange(0, [content length])];
-
-    for (NSTextCheckingResult *match in matches) {
-        if (match.numberOfRanges < 2) {
-            continue;
-        }
-        NSString *tag = [content substringWithRange:[match rangeAtIndex:1]];
-        NSSet *tagIds = [self idsFromGallery:tag];
-        [resultSet unionSet:tagIds];
-    }
-    return resultSet;
-}
-
-/**
- Extract the path to an image from an image tag.
- 
- @param tag An image tag.
- @return The value of the src param.
- */
-+ (NSString *)extractSrcFromImgTag:(NSString *)tag
-{
-    static NSRegularExpression *regex;
-    static dispatch_once_t onceToken;
-    dispatch_once(&onceToken, ^{
-        NSError *error;
-        NSString *srcPattern = @"src\\s*=\\s*(?:'|\")(.*?)(?:'|\")";
-        regex = [NSRegularExpression regularExpressionWithPattern:srcPattern options:NSRegularExpressionCaseInsensitive error:&error];
-    });
-
-    NSRange srcRng = [regex rangeOfFirstMatchInString:tag options:0 range:NSMakeRange(0, [tag length])];
-    NSString *src = [tag substringWithRange:srcRng];
-    NSCharacterSet *charSet = [NSCharacterSet characterSetWithCharactersInString:@"\"'="];
-    NSRange quoteRng = [src rangeOfCharacterFromSet:charSet];
-    src = [src substringFromIndex:quoteRng.location];
-    src = [src stringByTrimmingCharactersInSet:charSet];
-    return src;
-}
-
-/**
- Search the passed string for an image that is a good candidate to feature.
- @param content The content string to search.
- @return The url path for the image or an empty string.
- */
-+ (NSString *)searchContentBySizeClassForImageToFeature:(NSString *)content
-{
-    NSString *str = @"";
-    // If there is no image tag in the content, just bail.
-    if (!content || [content rangeOfString:@"<img"].location == NSNotFound) {
-        return str;
-    }
-    // If there is not a large or full sized image, just bail.
-    NSString *className = @"size-full";
-    NSRange range = [content rangeOfString:className];
-    if (range.location == NSNotFound) {
-        className = @"size-large";
-        range = [content rangeOfString:className];
-        if (range.location == NSNotFound) {
-            className = @"size-medium";
-            range = [content rangeOfString:className];
-            if (range.location == NSNotFound) {
-                return str;
+    for (NSString *className in @[@"size-full", @"size-large", @"size-medium"]) {
+        for (NSUInteger t = 0; t < count; t++) {
+            NSRange classRange = tags[t].className;
+            if (classRange.location == NSNotFound) {
+                continue;
+            }
+            if ([content rangeOfString:className options:NSLiteralSearch range:classRange].location != NSNotFound) {
+                return [[sources[t] componentsSeparatedByString:@"?"] firstObject];
             }
         }
     }
-    // find the start of the image
-    range = [content rangeOfString:@"<img" options:NSBackwardsSearch | NSCaseInsensitiveSearch range:NSMakeRange(0, range.location)];
-    if (range.location == NSNotFound) {
-        return str;
-    }
-    // Build the regex once and keep it around for subsequent calls.
-    static NSRegularExpression *regex;
-    static dispatch_once_t onceToken;
-    dispatch_once(&onceToken, ^{
-        NSError *error;
-        NSString *pattern = @"src=\"\\S+\"";
-        regex = [NSRegularExpression regularExpressionWithPattern:pattern options:NSRegularExpressionCaseInsensitive error:&error];
-    });
-    NSInteger length = [content length] - range.location;
-    range = [regex rangeOfFirstMatchInString:content options:0 range:NSMakeRange(range.location, length)];
-    if (range.location == NSNotFound) {
-        return str;
-    }
-    range = NSMakeRange(range.location+5, range.length-6);
-    str = [content substringWithRange:range];
-    str = [[str componentsSeparatedByString:@"?"] objectAtIndex:0];
-    return str;
-}
-
-+ (NSInteger)widthFromElementAttribute:(NSString *)tag
-{
-    NSRange rng = [tag rangeOfString:@"width=\""];
-    if (rng.location == NSNotFound) {
-        return 0;
-    }
-    NSInteger startingIdx = rng.location + rng.length;
-    rng = [tag rangeOfString:@"\"" options:NSCaseInsensitiveSearch range:NSMakeRange(startingIdx, [tag length] - startingIdx)];
-    if (rng.location == NSNotFound) {
-        return 0;
-    }
 
-    NSString *widthStr = [tag substringWithRange:NSMakeRange(startingIdx, rng.location - startingIdx)];
-    return [widthStr integerValue];
+    return @"";
 }
 
-+ (NSInteger)widthFromQueryString:(NSString *)src
++ (NSString *)searchPostContentForImageToDisplay:(NSString *)content
 {
-    NSURL *url = [NSURL URLWithString:src];
-    NSString *query = [url query];
-    NSRange rng = [query rangeOfString:@"w="];
-    if (rng.location == NSNotFound) {
-        return 0;
-    }
-
-    NSString *str = [query substringFromIndex:rng.location + rng.length];
-    NSString *widthStr = [[str componentsSeparatedByString:@"&"] firstObject];
-
-    return [widthStr integerValue];
+    return [self scanPostContent:content].imageToDisplay;
 }
 
-+ (NSSet *)idsFromGallery:(NSString *)idsStr
++ (NSSet *)searchPostContentForAttachmentIdsInGalleries:(NSString *)content
 {
-    NSArray * imageIds = [idsStr componentsSeparatedByString:@","];
-    NSMutableSet *result = [NSMutableSet set];
-    for (NSString *imageIdStr in imageIds) {
-        NSNumber *numberId = [imageIdStr numericValue];
-        if (numberId) {
-            [result addObject:numberId];
-        }
-    }
-    return result;
+    return [self scanPostContent:content].galleryAttachmentIds;
 }
+
 @end
@@ -1,9 +1,233 @@
 #import "NSString+Helpers.h"
 #import <CommonCrypto/CommonDigest.h>
 #import "NSString+XMLExtensions.h"
+#import "WPXMLEntityDecoding.h"
 
 static NSString *const Ellipsis =  @"\u2026";
 
+#pragma mark - Plain Text Conversion
+
+static BOOL WPIsWhitespace(unichar c)
+{
+    if (c < 0x80) {
+        return c == ' ' || (c >= '\t' && c <= '\r');
+    }
+    static CFCharacterSetRef whitespace;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        whitespace = CFCharacterSetGetPredefined(kCFCharacterSetWhitespaceAndNewline);
+    });
+    return CFCharacterSetIsCharacterMember(whitespace, c);
+}
+
+/// Returns the index of the first `>` at or after `start`, or `NSNotFound`.
+static NSUInteger WPIndexOfTagEnd(const unichar *chars, NSUInteger length, NSUInteger start)
+{
+    for (NSUInteger i = start; i < length; i++) {
+        if (chars[i] == '>') {
+            return i;
+        }
+    }
+    return NSNotFound;
+}
+
+/// Case-insensitively checks whether `chars` starts with the lowercase ASCII `prefix`.
+static BOOL WPHasPrefix(const unichar *chars, NSUInteger length, const char *prefix)
+{
+    NSUInteger prefixLength = strlen(prefix);
+    if (length < prefixLength) {
+        return NO;
+    }
+    for (NSUInteger i = 0; i < prefixLength; i++) {
+        unichar c = chars[i];
+        if (c >= 'A' && c <= 'Z') {
+            c += 'a' - 'A';
+        }
+        if (c != prefix[i]) {
+            return NO;
+        }
+    }
+    return YES;
+}
+
+/// Case-insensitively checks whether `chars` starts with the tag `name`.
+static BOOL WPHasTagName(const unichar *chars, NSUInteger length, const char *name)
+{
+    if (!WPHasPrefix(chars, length, name)) {
+        return NO;
+    }
+    // The name must not be a prefix of a longer one, e.g. `<styles>`
+    NSUInteger nameLength = strlen(name);
+    if (length == nameLength) {
+        return YES;
+    }
+    unichar next = chars[nameLength];
+    return !((next >= 'a' && next <= 'z') || (next >= 'A' && next <= 'Z') || (next >= '0' && next <= '9'));
+}
+
+/// Returns the index of the first occurrence of the lowercase ASCII `string` in `chars`, or `NSNotFound`.
+static NSUInteger WPIndexOfString(const unichar *chars, NSUInteger length, const char *string)
+{
+    NSUInteger stringLength = strlen(string);
+    for (NSUInteger i = 0; i + stringLength <= length; i++) {
+        if (WPHasPrefix(chars + i, length - i, string)) {
+            return i;
+        }
+    }
+    return NSNotFound;
+}
+
+/// Returns the index of the `<` of the `</name` closing tag at or after `start`, or `length`.
+static NSUInteger WPIndexOfClosingTag(const unichar *chars, NSUInteger length, NSUInteger start, const char *name)
+{
+    for (NSUInteger i = start; i + 1 < length; i++) {
+        if (chars[i] == '<' && chars[i + 1] == '/' && WPHasTagName(chars + i + 2, length - i - 2, name)) {
+            return i;
+        }
+    }
+    return length;
+}
+
+/// Collapses runs of whitespace into a single space as characters are appended.
+/// A run of a single whitespace character is kept as is.
+typedef struct {
+    unichar *output;
+    NSUInteger length;
+    NSUInteger maxLength;
+    unichar pendingWhitespace;
+    NSUInteger pendingWhitespaceCount;
+} WPPlainTextWriter;
+
+static void WPPlainTextWriterFlushWhitespace(WPPlainTextWriter *writer)
+{
+    if (writer->pendingWhitespaceCount > 0 && writer->length < writer->maxLength) {
+        writer->output[writer->length++] = writer->pendingWhitespaceCount == 1 ? writer->pendingWhitespace : ' ';
+    }
+    writer->pendingWhitespaceCount = 0;
+}
+
+static void WPPlainTextWriterAppend(WPPlainTextWriter *writer, unichar c)
+{
+    if (WPIsWhitespace(c)) {
+        writer->pendingWhitespace = c;
+        writer->pendingWhitespaceCount++;
+        return;
+    }
+    WPPlainTextWriterFlushWhitespace(writer);
+    if (writer->length < writer->maxLength) {
+        writer->output[writer->length++] = c;
+    }
+}
+
+static BOOL WPPlainTextWriterIsFull(const WPPlainTextWriter *writer)
+{
+    return writer->length >= writer->maxLength;
+}
+
+#pragma mark - Emoticons
+
+typedef NS_ENUM(NSInteger, WPEmoticonSource) {
+    WPEmoticonSourceNone,
+    WPEmoticonSourceSmilies,
+    WPEmoticonSourceWPComSmileys,
+    WPEmoticonSourceCoreEmoji,
+};
+
+typedef struct {
+    const char *path;
+    WPEmoticonSource source;
+} WPEmoticonPath;
+
+static const WPEmoticonPath WPEmoticonPaths[] = {
+    { "wp-includes/images/smilies/", WPEmoticonSourceSmilies },
+    { "wp-content/mu-plugins/wpcom-smileys/", WPEmoticonSourceWPComSmileys },
+    { "images/core/emoji/", WPEmoticonSourceCoreEmoji },
+};
+
+/// Finds which known emoticon path, if any, the `src` of an image points to.
+/// `nameStart` is set to the index right after the matched path.
+static WPEmoticonSource WPClassifyEmoticonSource(const unichar *src, NSUInteger length, NSUInteger *nameStart)
+{
+    for (NSUInteger i = 0; i < length; i++) {
+        unichar c = src[i];
+        // Every known path starts with either `w` or `i`, skip anything else quickly
+        if (c != 'w' && c != 'i' && c != 'W' && c != 'I') {
+            continue;
+        }
+        for (NSUInteger j = 0; j < sizeof(WPEmoticonPaths) / sizeof(WPEmoticonPath); j++) {
+            if (WPHasPrefix(src + i, length - i, WPEmoticonPaths[j].path)) {
+                *nameStart = i + strlen(WPEmoticonPaths[j].path);
+                return WPEmoticonPaths[j].source;
+            }
+        }
+    }
+    return WPEmoticonSourceNone;
+}
+
+/// Returns the range of the quoted value of the first `attribute=` in the tag, or a range
+/// with `NSNotFound` as its location.
+static NSRange WPRangeOfAttributeValue(const unichar *tag, NSUInteger length, const char *attribute)
+{
+    NSUInteger attributeLength = strlen(attribute);
+    NSUInteger offset = 0;
+    while (offset < length) {
+        NSUInteger index = WPIndexOfString(tag + offset, length - offset, attribute);
+        if (index == NSNotFound) {
+            break;
+        }
+        NSUInteger quote = offset + index + attributeLength;
+        if (quote < length && (tag[quote] == '"' || tag[quote] == '\'')) {
+            for (NSUInteger end = quote + 1; end < length; end++) {
+                if (tag[end] == '"' || tag[end] == '\'') {
+                    return NSMakeRange(quote + 1, end - quote - 1);
+                }
+            }
+            break;
+        }
+        offset = quote;
+    }
+    return NSMakeRange(NSNotFound, 0);
+}
+
+static NSDictionary<NSString *, NSString *> *WPEmoticonReplacements(void)
+{
+    static NSDictionary *replacements;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        replacements = @{
+            @"icon_arrow": @"➡",
+            @"icon_biggrin": @"😃",
+            @"icon_confused": @"😕",
+            @"icon_cool": @"😎",
+            @"icon_cry": @"😭",
+            @"icon_eek": @"😮",
+            @"icon_evil": @"😈",
+            @"icon_exclaim": @"❗",
+            @"icon_idea": @"💡",
+            @"icon_lol": @"😄",
+            @"icon_mad": @"😠",
+            @"icon_mrgreen": @"🐸",
+            @"icon_neutral": @"😐",
+            @"icon_question": @"❓",
+            @"icon_razz": @"😛",
+            @"icon_redface": @"😊",
+            @"icon_rolleyes": @"😒",
+            @"icon_sad": @"😞",
+            @"icon_smile": @"😊",
+            @"icon_surprised": @"😮",
+            @"icon_twisted": @"👿",
+            @"icon_wink": @"😉",
+            // NOTE: There is not a perfect match for the following four with
+            // currently supported emoji. We'll try to get as close as we can.
+            @"frownie":@"😞",
+            @"mrgreen":@"😊",
+            @"rolleyes":@"😒",
+            @"simple-smile":@"😊"
+        };
+    });
+    return replacements;
+}
+
 @implementation NSString (Helpers)
 
 #pragma mark Helpers
@@ -13,40 +237,50 @@ static NSString *const Ellipsis =  @"\u2026";
  */
 + (NSString *)emojiFromCoreEmojiImageTag:(NSString *)tag
 {
-    if ([tag rangeOfString:@"<img"].location == NSNotFound || [tag rangeOfString:@"/images/core/emoji/"].location == NSNotFound) {
-        return nil;
+    NSUInteger length = tag.length;
+    unichar *chars = malloc(length * sizeof(unichar));
+    [tag getCharacters:chars range:NSMakeRange(0, length)];
+    NSString *emoji = nil;
+    if (WPIndexOfString(chars, length, "<img") != NSNotFound) {
+        emoji = [self emojiFromCoreEmojiImageTagCharacters:chars length:length];
     }
+    free(chars);
+    return emoji;
+}
 
-    static NSRegularExpression *altRegex;
-    static NSRegularExpression *filenameRegex;
-    static dispatch_once_t onceToken;
-    dispatch_once(&onceToken, ^{
-        NSError *error;
-        altRegex = [NSRegularExpression regularExpressionWithPattern:@" alt=['\"]([^'\"]+)['\"]" options:NSRegularExpressionCaseInsensitive error:&error];
-        filenameRegex = [NSRegularExpression regularExpressionWithPattern:@"/images/core/emoji/[^/]+/(.+?).png" options:NSRegularExpressionCaseInsensitive error:&error];
-    });
++ (NSString *)emojiFromCoreEmojiImageTagCharacters:(const unichar *)tag length:(NSUInteger)length
+{
+    NSUInteger path = WPIndexOfString(tag, length, "/images/core/emoji/");
+    if (path == NSNotFound) {
+        return nil;
+    }
 
     // Check for the alt tag first as it should be the unicode emoji character.
-    NSRange sourceRange = NSMakeRange(0, [tag length]);
-    NSArray *matches = [altRegex matchesInString:tag options:0 range:sourceRange];
-    if ([matches count] > 0) {
-        NSTextCheckingResult *match = [matches firstObject];
-        if (match.numberOfRanges == 2) {
-            NSRange range = [match rangeAtIndex:1];
-            return [tag substringWithRange:range];
-        }
+    NSRange altRange = WPRangeOfAttributeValue(tag, length, " alt=");
+    if (altRange.location != NSNotFound && altRange.length > 0) {
+        return [NSString stringWithCharacters:tag + altRange.location length:altRange.length];
     }
 
-    matches = [filenameRegex matchesInString:tag options:0 range:sourceRange];
-    if ([matches count] > 0) {
-        NSTextCheckingResult *match = [matches firstObject];
-        if (match.numberOfRanges == 2) {
-            NSRange range = [match rangeAtIndex:1];
-            NSString *filename = [tag substringWithRange:range];
-            return [self emojiCharacterFromCoreEmojiFilename:filename];
+    // Otherwise use the filename: `/images/core/emoji/<version>/<filename>.png`
+    NSUInteger versionStart = path + strlen("/images/core/emoji/");
+    if (versionStart >= length || tag[versionStart] == '/') {
+        return nil;
+    }
+    for (NSUInteger i = versionStart + 1; i < length; i++) {
+        if (tag[i] != '/') {
+            continue;
+        }
+        NSUInteger filenameStart = i + 1;
+        if (filenameStart + 1 >= length) {
+            return nil;
         }
+        NSUInteger extension = WPIndexOfString(tag + filenameStart + 1, length - filenameStart - 1, ".png");
+        if (extension == NSNotFound) {
+            return nil;
+        }
+        NSString *filename = [NSString stringWithCharacters:tag + filenameStart length:extension + 1];
+        return [self emojiCharacterFromCoreEmojiFilename:filename];
     }
-
     return nil;
 }
 
@@ -110,91 +344,194 @@ static NSString *const Ellipsis =  @"\u2026";
 
 - (NSString *)stringByReplacingHTMLEmoticonsWithEmoji
 {
-    NSMutableString *result = [NSMutableString stringWithString:self];
-
-    NSDictionary *replacements = @{
-                                   @"icon_arrow": @"➡",
-                                   @"icon_biggrin": @"😃",
-                                   @"icon_confused": @"😕",
-                                   @"icon_cool": @"😎",
-                                   @"icon_cry": @"😭",
-                                   @"icon_eek": @"😮",
-                                   @"icon_evil": @"😈",
-                                   @"icon_exclaim": @"❗",
-                                   @"icon_idea": @"💡",
-                                   @"icon_lol": @"😄",
-                                   @"icon_mad": @"😠",
-                                   @"icon_mrgreen": @"🐸",
-                                   @"icon_neutral": @"😐",
-                                   @"icon_question": @"❓",
-                                   @"icon_razz": @"😛",
-                                   @"icon_redface": @"😊",
-                                   @"icon_rolleyes": @"😒",
-                                   @"icon_sad": @"😞",
-                                   @"icon_smile": @"😊",
-                                   @"icon_surprised": @"😮",
-                                   @"icon_twisted": @"👿",
-                                   @"icon_wink": @"😉",
-                                   // NOTE: There is not a perfect match for the following four with
-                                   // currently supported emoji. We'll try to get as close as we can.
-                                   @"frownie":@"😞",
-                                   @"mrgreen":@"😊",
-                                   @"rolleyes":@"😒",
-                                   @"simple-smile":@"😊"
-                                   };
-
-    static NSRegularExpression *smiliesRegex;
-    static NSRegularExpression *coreEmojiImgRegex;
-    static NSRegularExpression *wpcomSvgSmilies;
-    static dispatch_once_t onceToken;
-    dispatch_once(&onceToken, ^{
-        NSError *error;
-        smiliesRegex = [NSRegularExpression regularExpressionWithPattern:@"<img[^>]*?src=['\"][^>]*?wp-includes/images/smilies/(.+?)(?:.gif|.png)[^'\"]*['\"][^//]+/?>" options:NSRegularExpressionCaseInsensitive error:&error];
-        coreEmojiImgRegex = [NSRegularExpression regularExpressionWithPattern:@"<img[^>]*?src=['\"][^>]*?images/core/emoji/[^/]+/.+?.png['\"][^//]+/?>" options:NSRegularExpressionCaseInsensitive error:&error];
-        wpcomSvgSmilies = [NSRegularExpression regularExpressionWithPattern:@"<img[^>]*?src=['\"][^>]*?wp-content/mu-plugins/wpcom-smileys/(.+?).svg['\"][^//]+/?>" options:NSRegularExpressionCaseInsensitive error:&error];
+    if ([self rangeOfString:@"<img" options:NSCaseInsensitiveSearch].location == NSNotFound) {
+        return [self copy];
+    }
 
-    });
+    NSUInteger length = self.length;
+    unichar *chars = malloc(length * sizeof(unichar));
+    [self getCharacters:chars range:NSMakeRange(0, length)];
+
+    NSMutableString *result = nil;
+    NSUInteger copiedUpTo = 0;
+    NSUInteger i = 0;
+    while (i < length) {
+        if (chars[i] != '<' || !WPHasPrefix(chars + i, length - i, "<img")) {
+            i++;
+            continue;
+        }
+        NSUInteger tagStart = i;
+        NSUInteger tagEnd = WPIndexOfTagEnd(chars, length, tagStart + 1);
+        if (tagEnd == NSNotFound) {
+            break;
+        }
+        i = tagEnd + 1;
 
-    NSArray *matches = [smiliesRegex matchesInString:result options:0 range:NSMakeRange(0, [result length])];
-    for (NSTextCheckingResult *match in [matches reverseObjectEnumerator]) {
-        NSRange range = [match rangeAtIndex:1];
-        NSString *icon = [result substringWithRange:range];
-        NSString *replacement = [replacements objectForKey:icon];
-        if (replacement) {
-            [result replaceCharactersInRange:[match range] withString:replacement];
+        const unichar *tag = chars + tagStart;
+        NSUInteger tagLength = tagEnd - tagStart + 1;
+        NSString *replacement = [NSString emojiForEmoticonImageTagCharacters:tag length:tagLength];
+        if (!replacement) {
+            continue;
         }
-    }
 
-    matches = [wpcomSvgSmilies matchesInString:result options:0 range:NSMakeRange(0, [result length])];
-    for (NSTextCheckingResult *match in [matches reverseObjectEnumerator]) {
-        NSRange range = [match rangeAtIndex:1];
-        NSString *icon = [result substringWithRange:range];
-        NSString *replacement = [replacements objectForKey:icon];
-        if (replacement) {
-            [result replaceCharactersInRange:[match range] withString:replacement];
+        if (!result) {
+            result = [NSMutableString stringWithCapacity:length];
         }
+        CFStringAppendCharacters((__bridge CFMutableStringRef)result, chars + copiedUpTo, tagStart - copiedUpTo);
+        [result appendString:replacement];
+        copiedUpTo = i;
     }
 
-    matches = [coreEmojiImgRegex matchesInString:result options:0 range:NSMakeRange(0, [result length])];
-    for (NSTextCheckingResult *match in [matches reverseObjectEnumerator]) {
-        NSRange range = [match rangeAtIndex:0];
-        NSString *tag = [result substringWithRange:range];
-        NSString *replacement = [NSString emojiFromCoreEmojiImageTag:tag];
-        if (replacement) {
-            [result replaceCharactersInRange:[match range] withString:replacement];
-        }
+    if (result) {
+        CFStringAppendCharacters((__bridge CFMutableStringRef)result, chars + copiedUpTo, length - copiedUpTo);
     }
+    free(chars);
 
-    return [NSString stringWithString:result];
+    return result ?: [self copy];
 }
 
+/**
+ Returns the emoji for an `<img>` tag pointing to a WordPress smiley, a WordPress.com SVG smiley
+ or a core emoji image, or nil if the tag is a regular image.
+ */
++ (NSString *)emojiForEmoticonImageTagCharacters:(const unichar *)tag length:(NSUInteger)length
+{
+    NSRange srcRange = WPRangeOfAttributeValue(tag, length, "src=");
+    if (srcRange.location == NSNotFound) {
+        return nil;
+    }
+    const unichar *src = tag + srcRange.location;
+    NSUInteger srcLength = srcRange.length;
+
+    NSUInteger nameStart = 0;
+    switch (WPClassifyEmoticonSource(src, srcLength, &nameStart)) {
+        case WPEmoticonSourceSmilies: {
+            // `.../smilies/<name>.gif` or `.../smilies/<name>.png`, possibly followed by a query
+            for (NSUInteger i = nameStart + 1; i + 4 <= srcLength; i++) {
+                if (WPHasPrefix(src + i, srcLength - i, ".gif") || WPHasPrefix(src + i, srcLength - i, ".png")) {
+                    NSString *name = [NSString stringWithCharacters:src + nameStart length:i - nameStart];
+                    return WPEmoticonReplacements()[name];
+                }
+            }
+            return nil;
+        }
+        case WPEmoticonSourceWPComSmileys: {
+            // `.../wpcom-smileys/<name>.svg`
+            if (srcLength < nameStart + 5 || !WPHasPrefix(src + srcLength - 4, 4, ".svg")) {
+                return nil;
+            }
+            NSString *name = [NSString stringWithCharacters:src + nameStart length:srcLength - 4 - nameStart];
+            return WPEmoticonReplacements()[name];
+        }
+        case WPEmoticonSourceCoreEmoji:
+            if (srcLength < 4 || !WPHasPrefix(src + srcLength - 4, 4, ".png")) {
+                return nil;
+            }
+            return [self emojiFromCoreEmojiImageTagCharacters:tag length:length];
+        case WPEmoticonSourceNone:
+            return nil;
+    }
+}
 
 /*
- * Uses a RegEx to strip all HTML tags from a string and unencode entites
+ * Strips all HTML tags (anything matching `<[^>]+>`) from a string
  */
 - (NSString *)stringByStrippingHTML
 {
-    return [self stringByReplacingOccurrencesOfString:@"<[^>]+>" withString:@"" options:NSRegularExpressionSearch range:NSMakeRange(0, self.length)];
+    NSUInteger length = self.length;
+    if ([self rangeOfString:@"<"].location == NSNotFound) {
+        return [self copy];
+    }
+
+    unichar *input = malloc(length * sizeof(unichar));
+    [self getCharacters:input range:NSMakeRange(0, length)];
+    unichar *output = malloc(length * sizeof(unichar));
+
+    NSUInteger outputLength = 0;
+    NSUInteger i = 0;
+    while (i < length) {
+        if (input[i] == '<' && i + 1 < length && input[i + 1] != '>') {
+            NSUInteger tagEnd = WPIndexOfTagEnd(input, length, i + 1);
+            if (tagEnd != NSNotFound) {
+                i = tagEnd + 1;
+                continue;
+            }
+        }
+        output[outputLength++] = input[i++];
+    }
+    free(input);
+
+    return [[NSString alloc] initWithCharactersNoCopy:output length:outputLength freeWhenDone:YES];
+}
+
+- (NSString *)stringByConvertingHTMLToPlainText
+{
+    return [self stringByConvertingHTMLToPlainTextWithMaxLength:NSUIntegerMax];
+}
+
+- (NSString *)stringByConvertingHTMLToPlainTextWithMaxLength:(NSUInteger)maxLength
+{
+    NSUInteger length = self.length;
+    if (length == 0 || maxLength == 0) {
+        return @"";
+    }
+
+    unichar *input = malloc(length * sizeof(unichar));
+    [self getCharacters:input range:NSMakeRange(0, length)];
+
+    // Produce one character past the limit, to tell whether the limit cuts a composed character sequence.
+    NSUInteger capacity = MIN(length, maxLength == NSUIntegerMax ? maxLength : maxLength + 1);
+    WPPlainTextWriter writer = {
+        .output = malloc(capacity * sizeof(unichar)),
+        .maxLength = capacity,
+    };
+
+    NSUInteger i = 0;
+    while (i < length && !WPPlainTextWriterIsFull(&writer)) {
+        unichar c = input[i];
+
+        if (c == '<' && i + 1 < length && input[i + 1] != '>') {
+            NSUInteger tagEnd = WPIndexOfTagEnd(input, length, i + 1);
+            if (tagEnd != NSNotFound) {
+                const unichar *name = input + i + 1;
+                NSUInteger nameLength = tagEnd - i - 1;
+                i = tagEnd + 1;
+                // Skip the contents of script and style elements, they are never visible
+                if (WPHasTagName(name, nameLength, "script")) {
+                    i = WPIndexOfClosingTag(input, length, i, "script");
+                } else if (WPHasTagName(name, nameLength, "style")) {
+                    i = WPIndexOfClosingTag(input, length, i, "style");
+                }
+                continue;
+            }
+        }
+
+        if (c == '&') {
+            unichar decoded[2];
+            NSUInteger sequenceLength = 0;
+            NSUInteger written = WPXMLDecodeEscapeSequenceAtStart(input + i, length - i, decoded, &sequenceLength);
+            if (written > 0) {
+                for (NSUInteger j = 0; j < written; j++) {
+                    WPPlainTextWriterAppend(&writer, decoded[j]);
+                }
+                i += sequenceLength;
+                continue;
+            }
+        }
+
+        WPPlainTextWriterAppend(&writer, c);
+        i++;
+    }
+    WPPlainTextWriterFlushWhitespace(&writer);
+    free(input);
+
+    NSString *text = [[NSString alloc] initWithCharactersNoCopy:writer.output length:writer.length freeWhenDone:YES];
+    if (writer.length > maxLength) {
+        // Drop the sequence at the limit as a whole, e.g. an emoji made of a surrogate pair.
+        NSRange lastSequence = [text rangeOfComposedCharacterSequenceAtIndex:maxLength];
+        return [text substringToIndex:lastSequence.location];
+    }
+    return text;
 }
 
 // A method to truncate a string at a predetermined length and append ellipsis to the end
@@ -311,7 +648,25 @@ static NSString *const Ellipsis =  @"\u2026";
 
 - (NSString *)stringByNormalizingWhitespace
 {
-    return [self stringByReplacingOccurrencesOfString:@"\\s{2,}" withString:@" " options:NSRegularExpressionSearch range:NSMakeRange(0, self.length)];
+    NSUInteger length = self.length;
+    if (length == 0) {
+        return @"";
+    }
+
+    unichar *input = malloc(length * sizeof(unichar));
+    [self getCharacters:input range:NSMakeRange(0, length)];
+
+    WPPlainTextWriter writer = {
+        .output = malloc(length * sizeof(unichar)),
+        .maxLength = length,
+    };
+    for (NSUInteger i = 0; i < length; i++) {
+        WPPlainTextWriterAppend(&writer, input[i]);
+    }
+    WPPlainTextWriterFlushWhitespace(&writer);
+    free(input);
+
+    return [[NSString alloc] initWithCharactersNoCopy:writer.output length:writer.length freeWhenDone:YES];
 }
 
 
@@ -2,17 +2,13 @@
 // https://github.com/mwaterfall/MWFeedParser Copyright (c) 2010 Michael Waterfall
 
 #import "NSString+XMLExtensions.h"
-
-
-typedef struct {
-	__unsafe_unretained NSString *escapeSequence;
-	unichar uchar;
-} HTMLEscapeMap;
+#import "WPXMLEntityDecoding.h"
+#import <simd/simd.h>
 
 
 // Taken from http://www.w3.org/TR/xhtml1/dtds.html#a_dtd_Special_characters
 // Ordered by uchar lowest to highest for bsearching
-static HTMLEscapeMap gAsciiHTMLEscapeMap[] = {
+const HTMLEscapeMap gAsciiHTMLEscapeMap[] = {
 	// A.2.2. Special characters
 	{ @"&quot;", 34 },
 	{ @"&amp;", 38 },
@@ -294,6 +290,280 @@ static HTMLEscapeMap gAsciiHTMLEscapeMap[] = {
 	{ @"&diams;", 9830 }
 };
 
+const NSUInteger gAsciiHTMLEscapeMapCount = sizeof(gAsciiHTMLEscapeMap) / sizeof(HTMLEscapeMap);
+
+
+enum {
+	// A sequence must be longer than 3 (&lt;) and less than 11 (&thetasym;)
+	WPXMLEscapeMinLength = 4,
+	WPXMLEscapeMaxLength = 10,
+	WPXMLEntityNameMaxLength = WPXMLEscapeMaxLength - 2,
+
+	// Open addressing hash table over the names in gAsciiHTMLEscapeMap (without the
+	// leading `&` and trailing `;`), built once so named entities resolve in O(1).
+	WPXMLEntityTableSize = 512,
+};
+
+typedef struct {
+	unichar name[WPXMLEntityNameMaxLength];
+	uint8_t length;
+	unichar uchar;
+} WPXMLEntity;
+
+static WPXMLEntity gEntityTable[WPXMLEntityTableSize];
+
+static NSUInteger WPXMLEntityHash(const unichar *name, NSUInteger length) {
+	// FNV-1a
+	uint32_t hash = 2166136261u;
+	for (NSUInteger i = 0; i < length; i++) {
+		hash ^= name[i];
+		hash *= 16777619u;
+	}
+	return hash & (WPXMLEntityTableSize - 1);
+}
+
+static void WPXMLBuildEntityTable(void) {
+	for (NSUInteger i = 0; i < gAsciiHTMLEscapeMapCount; ++i) {
+		NSString *sequence = gAsciiHTMLEscapeMap[i].escapeSequence;
+		NSUInteger length = [sequence length] - 2;
+		NSCAssert(length <= WPXMLEntityNameMaxLength, @"Escape sequence %@ is too long", sequence);
+
+		unichar name[WPXMLEntityNameMaxLength];
+		[sequence getCharacters:name range:NSMakeRange(1, length)];
+
+		NSUInteger slot = WPXMLEntityHash(name, length);
+		while (gEntityTable[slot].length != 0) {
+			slot = (slot + 1) & (WPXMLEntityTableSize - 1);
+		}
+		memcpy(gEntityTable[slot].name, name, length * sizeof(unichar));
+		gEntityTable[slot].length = length;
+		gEntityTable[slot].uchar = gAsciiHTMLEscapeMap[i].uchar;
+	}
+}
+
+static unichar WPXMLLookupEntity(const unichar *name, NSUInteger length) {
+	static dispatch_once_t onceToken;
+	dispatch_once(&onceToken, ^{
+		WPXMLBuildEntityTable();
+	});
+
+	NSUInteger slot = WPXMLEntityHash(name, length);
+	while (gEntityTable[slot].length != 0) {
+		if (gEntityTable[slot].length == length && memcmp(gEntityTable[slot].name, name, length * sizeof(unichar)) == 0) {
+			return gEntityTable[slot].uchar;
+		}
+		slot = (slot + 1) & (WPXMLEntityTableSize - 1);
+	}
+	return 0;
+}
+
+/// Parses the digits of a numeric character reference. Returns 0 if the digits
+/// are malformed or don't describe a valid Unicode scalar value.
+static uint32_t WPXMLParseCodePoint(const unichar *digits, NSUInteger length, BOOL hex) {
+	if (length == 0) {
+		return 0;
+	}
+	uint32_t value = 0;
+	for (NSUInteger i = 0; i < length; i++) {
+		unichar c = digits[i];
+		uint32_t digit;
+		if (c >= '0' && c <= '9') {
+			digit = c - '0';
+		} else if (hex && c >= 'a' && c <= 'f') {
+			digit = c - 'a' + 10;
+		} else if (hex && c >= 'A' && c <= 'F') {
+			digit = c - 'A' + 10;
+		} else {
+			return 0;
+		}
+		value = value * (hex ? 16 : 10) + digit;
+		if (value > 0x10FFFF) {
+			return 0;
+		}
+	}
+	if (value >= 0xD800 && value <= 0xDFFF) {
+		return 0;
+	}
+	return value;
+}
+
+/// Decodes the escape sequence `&...;` of `length` characters (including the
+/// delimiters) into `output`. Returns the number of UTF-16 units written, or 0
+/// if the sequence is not recognized.
+static NSUInteger WPXMLDecodeEscapeSequence(const unichar *sequence, NSUInteger length, unichar *output) {
+	if (sequence[1] == '#') {
+		BOOL hex = sequence[2] == 'x' || sequence[2] == 'X';
+		NSUInteger digitsStart = hex ? 3 : 2;
+		uint32_t value = WPXMLParseCodePoint(sequence + digitsStart, length - digitsStart - 1, hex);
+		if (value == 0) {
+			return 0;
+		}
+		if (value > 0xFFFF) {
+			value -= 0x10000;
+			output[0] = (unichar)(0xD800 + (value >> 10));
+			output[1] = (unichar)(0xDC00 + (value & 0x3FF));
+			return 2;
+		}
+		output[0] = (unichar)value;
+		return 1;
+	}
+
+	unichar uchar = WPXMLLookupEntity(sequence + 1, length - 2);
+	if (uchar == 0) {
+		return 0;
+	}
+	output[0] = uchar;
+	return 1;
+}
+
+NSUInteger WPXMLDecodeEscapeSequenceAtStart(const unichar *input, NSUInteger length, unichar *output, NSUInteger *sequenceLength) {
+	// Look for the closing semicolon within the longest possible sequence
+	NSUInteger limit = MIN(length, WPXMLEscapeMaxLength);
+	for (NSUInteger j = 1; j < limit; j++) {
+		if (input[j] != ';') {
+			continue;
+		}
+		NSUInteger candidateLength = j + 1;
+		if (candidateLength < WPXMLEscapeMinLength) {
+			return 0;
+		}
+		NSUInteger written = WPXMLDecodeEscapeSequence(input, candidateLength, output);
+		if (written > 0) {
+			*sequenceLength = candidateLength;
+		}
+		return written;
+	}
+	return 0;
+}
+
+/// Decodes `input` into `output` in a single forward pass and returns the length
+/// of the decoded string. `output` must have room for at least `length` characters.
+static NSUInteger WPDecodeXMLCharacters(const unichar *input, NSUInteger length, unichar *output) {
+	NSUInteger out = 0;
+	NSUInteger i = 0;
+	while (i < length) {
+		unichar c = input[i];
+		if (c == '&') {
+			NSUInteger sequenceLength = 0;
+			NSUInteger written = WPXMLDecodeEscapeSequenceAtStart(input + i, length - i, output + out, &sequenceLength);
+			if (written > 0) {
+				out += written;
+				i += sequenceLength;
+				continue;
+			}
+		}
+		output[out++] = c;
+		i++;
+	}
+	return out;
+}
+
+// NOTE: we use unicode entities instead of &amp; &gt; &lt; since some weird hosts (powweb, fatcow, and cousins)
+// have a weird PHP/libxml2 combination that ignores regular entities
+static const char WPXMLEscapedAmpersand[] = "&#38;";
+static const char WPXMLEscapedLessThan[] = "&#60;";
+static const char WPXMLEscapedGreaterThan[] = "&#62;";
+static const NSUInteger WPXMLEscapedLength = sizeof(WPXMLEscapedAmpersand) - 1;
+
+static inline const char *WPXMLEscapeForCharacter(uint16_t c) {
+	switch (c) {
+		case '&': return WPXMLEscapedAmpersand;
+		case '<': return WPXMLEscapedLessThan;
+		case '>': return WPXMLEscapedGreaterThan;
+		default: return NULL;
+	}
+}
+
+static inline simd_short8 WPXMLEscapableMask16(const unichar *chars) {
+	simd_ushort8 block;
+	memcpy(&block, chars, sizeof(block));
+	return (block == (unichar)'&') | (block == (unichar)'<') | (block == (unichar)'>');
+}
+
+static inline simd_char16 WPXMLEscapableMask8(const uint8_t *bytes) {
+	simd_uchar16 block;
+	memcpy(&block, bytes, sizeof(block));
+	return (block == (uint8_t)'&') | (block == (uint8_t)'<') | (block == (uint8_t)'>');
+}
+
+static NSUInteger WPXMLCountEscapableCharacters16(const unichar *chars, NSUInteger length) {
+	NSUInteger count = 0;
+	NSUInteger i = 0;
+	for (; i + 8 <= length; i += 8) {
+		// Matching lanes are all ones, i.e. -1
+		count -= simd_reduce_add(WPXMLEscapableMask16(chars + i));
+	}
+	for (; i < length; i++) {
+		count += WPXMLEscapeForCharacter(chars[i]) != NULL;
+	}
+	return count;
+}
+
+static NSUInteger WPXMLCountEscapableCharacters8(const uint8_t *bytes, NSUInteger length) {
+	NSUInteger count = 0;
+	NSUInteger i = 0;
+	for (; i + 16 <= length; i += 16) {
+		count -= simd_reduce_add(WPXMLEscapableMask8(bytes + i));
+	}
+	for (; i < length; i++) {
+		count += WPXMLEscapeForCharacter(bytes[i]) != NULL;
+	}
+	return count;
+}
+
+/// Writes the escaped form of `chars` to `output`, which must be large enough to
+/// hold every escapable character expanded to `WPXMLEscapedLength`.
+static void WPXMLEncodeCharacters16(const unichar *chars, NSUInteger length, unichar *output) {
+	NSUInteger i = 0;
+	while (i < length) {
+		if (i + 8 <= length && !simd_any(WPXMLEscapableMask16(chars + i))) {
+			memcpy(output, chars + i, 8 * sizeof(unichar));
+			output += 8;
+			i += 8;
+			continue;
+		}
+		const char *escape = WPXMLEscapeForCharacter(chars[i]);
+		if (escape) {
+			for (NSUInteger j = 0; j < WPXMLEscapedLength; j++) {
+				*output++ = escape[j];
+			}
+		} else {
+			*output++ = chars[i];
+		}
+		i++;
+	}
+}
+
+static void WPXMLAppendEncodedUTF8(const uint8_t *bytes, NSUInteger length, NSMutableData *data) {
+	NSUInteger count = WPXMLCountEscapableCharacters8(bytes, length);
+	if (count == 0) {
+		[data appendBytes:bytes length:length];
+		return;
+	}
+
+	NSUInteger offset = [data length];
+	[data increaseLengthBy:length + count * (WPXMLEscapedLength - 1)];
+	uint8_t *output = (uint8_t *)[data mutableBytes] + offset;
+
+	NSUInteger i = 0;
+	while (i < length) {
+		if (i + 16 <= length && !simd_any(WPXMLEscapableMask8(bytes + i))) {
+			memcpy(output, bytes + i, 16);
+			output += 16;
+			i += 16;
+			continue;
+		}
+		const char *escape = WPXMLEscapeForCharacter(bytes[i]);
+		if (escape) {
+			memcpy(output, escape, WPXMLEscapedLength);
+			output += WPXMLEscapedLength;
+		} else {
+			*output++ = bytes[i];
+		}
+		i++;
+	}
+}
+
 
 @implementation NSString (XMLExtensions)
 
@@ -301,93 +571,84 @@ static HTMLEscapeMap gAsciiHTMLEscapeMap[] = {
     if (![source isKindOfClass:[NSString class]] || !source)
         return @"";
 
-    NSString *result = [NSString stringWithString:source];
+    // Read the UTF-16 storage of the string in place when it has one, and copy it otherwise.
+    NSUInteger length = [source length];
+    const unichar *input = CFStringGetCharactersPtr((__bridge CFStringRef)source);
+    unichar *inputCopy = NULL;
+    if (input == NULL) {
+        inputCopy = malloc(length * sizeof(unichar));
+        [source getCharacters:inputCopy range:NSMakeRange(0, length)];
+        input = inputCopy;
+    }
+
+    NSUInteger count = WPXMLCountEscapableCharacters16(input, length);
+    if (count == 0) {
+        free(inputCopy);
+        return [NSString stringWithString:source];
+    }
 
-    // NOTE: we use unicode entities instead of &amp; &gt; &lt; since some weird hosts (powweb, fatcow, and cousins)
-    // have a weird PHP/libxml2 combination that ignores regular entities
-    if ([result rangeOfString:@"&"].location != NSNotFound)
-        result = [[result componentsSeparatedByString:@"&"] componentsJoinedByString:@"&#38;"];
+    NSUInteger outputLength = length + count * (WPXMLEscapedLength - 1);
+    unichar *output = malloc(outputLength * sizeof(unichar));
+    WPXMLEncodeCharacters16(input, length, output);
+    free(inputCopy);
 
-    if ([result rangeOfString:@"<"].location != NSNotFound)
-        result = [[result componentsSeparatedByString:@"<"] componentsJoinedByString:@"&#60;"];
+    return [[NSString alloc] initWithCharactersNoCopy:output length:outputLength freeWhenDone:YES];
+}
+
++ (void)appendXMLEncodedCharactersIn:(NSString *)source toData:(NSMutableData *)data {
+    if (![source isKindOfClass:[NSString class]] || !source)
+        return;
 
-    if ([result rangeOfString:@">"].location != NSNotFound)
-        result = [[result componentsSeparatedByString:@">"] componentsJoinedByString:@"&#62;"];
+    // Escape the UTF-8 storage of the string in place when it has one. Its length comes from the
+    // string rather than from the NUL terminator, since the string may contain NUL characters.
+    const char *utf8 = CFStringGetCStringPtr((__bridge CFStringRef)source, kCFStringEncodingUTF8);
+    if (utf8 != NULL) {
+        WPXMLAppendEncodedUTF8((const uint8_t *)utf8, [source lengthOfBytesUsingEncoding:NSUTF8StringEncoding], data);
+        return;
+    }
 
-    return result;
+    // Convert and escape the string in chunks so large post bodies never need a
+    // full intermediate copy.
+    uint8_t buffer[4096];
+    NSRange remaining = NSMakeRange(0, [source length]);
+    while (remaining.length > 0) {
+        NSUInteger usedLength = 0;
+        BOOL converted = [source getBytes:buffer
+                                maxLength:sizeof(buffer)
+                               usedLength:&usedLength
+                                 encoding:NSUTF8StringEncoding
+                                  options:NSStringEncodingConversionAllowLossy
+                                    range:remaining
+                           remainingRange:&remaining];
+        if (!converted) {
+            break;
+        }
+        WPXMLAppendEncodedUTF8(buffer, usedLength, data);
+    }
 }
 
 
 + (NSString *) decodeXMLCharactersIn:(NSString *)original {
 	if (![original isKindOfClass:[NSString class]] || !original)
         return @"";
-	
-    NSString *source = [NSString stringWithString:original];
-	
-	NSRange range = NSMakeRange(0, [source length]);
-	NSRange subrange = [source rangeOfString:@"&" options:NSBackwardsSearch range:range];
-	
+
 	// if no ampersands, we've got a quick way out
-	if (subrange.length == 0) return source;
-	NSMutableString *finalString = [NSMutableString stringWithString:source];
-	do {
-		NSRange semiColonRange = NSMakeRange(subrange.location, NSMaxRange(range) - subrange.location);
-		semiColonRange = [source rangeOfString:@";" options:0 range:semiColonRange];
-		range = NSMakeRange(0, subrange.location);
-		// if we don't find a semicolon in the range, we don't have a sequence
-		if (semiColonRange.location == NSNotFound) {
-			continue;
-		}
-		NSRange escapeRange = NSMakeRange(subrange.location, semiColonRange.location - subrange.location + 1);
-		NSString *escapeString = [source substringWithRange:escapeRange];
-		NSUInteger length = [escapeString length];
-		// a squence must be longer than 3 (&lt;) and less than 11 (&thetasym;)
-		if (length > 3 && length < 11) {
-			if ([escapeString characterAtIndex:1] == '#') {
-				unichar char2 = [escapeString characterAtIndex:2];
-				if (char2 == 'x' || char2 == 'X') {
-					// Hex escape squences &#xa3;
-					NSString *hexSequence = [escapeString substringWithRange:NSMakeRange(3, length - 4)];
-					NSScanner *scanner = [NSScanner scannerWithString:hexSequence];
-					unsigned value;
-					if ([scanner scanHexInt:&value] && 
-						value < USHRT_MAX &&
-						value > 0 
-						&& [scanner scanLocation] == length - 4) {
-						unichar uchar = value;
-						NSString *charString = [NSString stringWithCharacters:&uchar length:1];
-						[finalString replaceCharactersInRange:escapeRange withString:charString];
-					}
-					
-				} else {
-					// Decimal Sequences &#123;
-					NSString *numberSequence = [escapeString substringWithRange:NSMakeRange(2, length - 3)];
-					NSScanner *scanner = [NSScanner scannerWithString:numberSequence];
-					int value;
-					if ([scanner scanInt:&value] && 
-						value < USHRT_MAX &&
-						value > 0 
-						&& [scanner scanLocation] == length - 3) {
-						unichar uchar = value;
-						NSString *charString = [NSString stringWithCharacters:&uchar length:1];
-						[finalString replaceCharactersInRange:escapeRange withString:charString];
-					}
-				}
-			} else {
-				// "standard" sequences
-				for (unsigned i = 0; i < sizeof(gAsciiHTMLEscapeMap) / sizeof(HTMLEscapeMap); ++i) {
-					if ([escapeString isEqualToString:gAsciiHTMLEscapeMap[i].escapeSequence]) {
-						[finalString replaceCharactersInRange:escapeRange withString:[NSString stringWithCharacters:&gAsciiHTMLEscapeMap[i].uchar length:1]];
-						break;
-					}
-				}
-			}
-		}
-	
-	} while ((subrange = [source rangeOfString:@"&" options:NSBackwardsSearch range:range]).length != 0);
+	if ([original rangeOfString:@"&"].location == NSNotFound) {
+		return [NSString stringWithString:original];
+	}
+
+	NSUInteger length = [original length];
+	unichar *input = malloc(length * sizeof(unichar));
+	[original getCharacters:input range:NSMakeRange(0, length)];
 
-	return finalString;
-} 
+	// A decoded sequence is never longer than its escape sequence, so the output
+	// fits in a buffer of the same size as the input.
+	unichar *output = malloc(length * sizeof(unichar));
+	NSUInteger outputLength = WPDecodeXMLCharacters(input, length, output);
+	free(input);
+
+	return [[NSString alloc] initWithCharactersNoCopy:output length:outputLength freeWhenDone:YES];
+}
 
 - (NSString *)stringByDecodingXMLCharacters {
     return [NSString decodeXMLCharactersIn:self];
@@ -1,118 +1,366 @@
 #import "PhotonImageURLHelper.h"
 
-@implementation PhotonImageURLHelper
-
 static const NSUInteger DefaultPhotonImageQuality = 80;
 static const NSInteger MaxPhotonImageQuality = 100;
 static const NSInteger MinPhotonImageQuality = 1;
 
-+ (NSURL *)photonURLWithSize:(CGSize)size forImageURL:(NSURL *)url
+/// Large enough for the longest query string: `quality=100&resize=<width>,<height>&ssl=1`.
+static const size_t PhotonQueryBufferSize = 128;
+
+/// The parts of an absolute URL string needed to build a Photon URL, as ranges of the string.
+/// Missing parts have a location of NSNotFound.
+typedef struct {
+    NSRange scheme;
+    NSRange host;
+    NSRange pathExtension;
+} PhotonURLComponents;
+
+/// Typical image URLs are shorter than this, and are processed without allocating.
+static const NSUInteger PhotonURLInlineCapacity = 512;
+
+/// Storage for the characters of the URL strings being processed, reused across the URLs of a batch.
+/// Lives on the stack, and only falls back to the heap for URLs longer than `PhotonURLInlineCapacity`.
+typedef struct {
+    unichar inlineCharacters[PhotonURLInlineCapacity];
+    unichar *heapCharacters;
+    NSUInteger heapCapacity;
+} PhotonURLBuffer;
+
+#pragma mark - Parsing
+
+static inline unichar PhotonLowercase(unichar c)
 {
-    return [self photonURLWithSize:size forImageURL:url forceResize:YES imageQuality:DefaultPhotonImageQuality];
+    return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
 }
 
-+ (NSURL *)photonURLWithSize:(CGSize)size forImageURL:(NSURL *)url forceResize:(BOOL)forceResize imageQuality:(NSUInteger)quality
+static inline BOOL PhotonIsDigit(unichar c)
+{
+    return c >= '0' && c <= '9';
+}
+
+static BOOL PhotonIsSchemeCharacter(unichar c, BOOL isFirst)
+{
+    BOOL isLetter = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    return isLetter || (!isFirst && (PhotonIsDigit(c) || c == '+' || c == '-' || c == '.'));
+}
+
+/// Returns YES if the characters in `range` are the ASCII `token`.
+static BOOL PhotonRangeEquals(const unichar *chars, NSRange range, const char *token, BOOL caseInsensitive)
 {
-    // Photon will fail if the URL doesn't end in one of the accepted extensions
-    NSArray *acceptedImageTypes = @[@"gif", @"jpg", @"jpeg", @"png"];
-    if ([acceptedImageTypes indexOfObject:url.pathExtension] == NSNotFound) {
-        if (![url scheme]) {
-            return [NSURL URLWithString:[NSString stringWithFormat:@"http://%@", [url absoluteString]]];
+    size_t tokenLength = strlen(token);
+    if (range.location == NSNotFound || range.length != tokenLength) {
+        return NO;
+    }
+    for (NSUInteger i = 0; i < tokenLength; i++) {
+        unichar c = chars[range.location + i];
+        if ((caseInsensitive ? PhotonLowercase(c) : c) != (unichar)token[i]) {
+            return NO;
         }
-        return url;
     }
+    return YES;
+}
 
-    NSString *urlString = [url absoluteString];
-    CGFloat scale = [[UIScreen mainScreen] scale];
-    size.width *= scale;
-    size.height *= scale;
-    quality = MIN(MAX(quality, MinPhotonImageQuality), MaxPhotonImageQuality);
-
-    // If the URL is already a Photon URL reject its photon params, and substitute our own.
-    if ([self isURLPhotonURL:url]) {
-        NSRange range = [urlString rangeOfString:@"?" options:NSBackwardsSearch];
-        if (range.location != NSNotFound) {
-            BOOL useSSL = ([urlString rangeOfString:@"ssl=1"].location != NSNotFound);
-            urlString = [urlString substringToIndex:range.location];
-            NSString *queryString = [self photonQueryStringForSize:size usingSSL:useSSL forceResize:forceResize quality:quality];
-            urlString = [NSString stringWithFormat:@"%@?%@", urlString, queryString];
-            return [NSURL URLWithString:urlString];
+/// Returns the location of the first occurrence of the ASCII `token` in `range`, or NSNotFound.
+static NSUInteger PhotonFind(const unichar *chars, NSRange range, const char *token)
+{
+    size_t tokenLength = strlen(token);
+    if (range.length < tokenLength) {
+        return NSNotFound;
+    }
+    NSUInteger last = NSMaxRange(range) - tokenLength;
+    for (NSUInteger i = range.location; i <= last; i++) {
+        if (PhotonRangeEquals(chars, NSMakeRange(i, tokenLength), token, NO)) {
+            return i;
         }
-        // Saftey net. Don't photon photon!
-        return url;
+    }
+    return NSNotFound;
+}
+
+static PhotonURLComponents PhotonURLParse(const unichar *chars, NSUInteger length)
+{
+    NSRange notFound = NSMakeRange(NSNotFound, 0);
+    PhotonURLComponents components = { notFound, notFound, notFound };
+
+    NSUInteger i = 0;
+    while (i < length && PhotonIsSchemeCharacter(chars[i], i == 0)) {
+        i++;
     }
 
-    // Compose the URL
-    NSRange range = [urlString rangeOfString:@"://"];
-    if (range.location != NSNotFound && range.location < 6) {
-        urlString = [urlString substringFromIndex:(range.location + range.length)];
+    NSUInteger pathStart = 0;
+    if (i > 0 && i < length && chars[i] == ':') {
+        components.scheme = NSMakeRange(0, i);
+        pathStart = i + 1;
+
+        if (pathStart + 1 < length && chars[pathStart] == '/' && chars[pathStart + 1] == '/') {
+            NSUInteger hostStart = pathStart + 2;
+            NSUInteger authorityEnd = hostStart;
+            while (authorityEnd < length && chars[authorityEnd] != '/' && chars[authorityEnd] != '?' && chars[authorityEnd] != '#') {
+                if (chars[authorityEnd] == '@') {
+                    hostStart = authorityEnd + 1;
+                }
+                authorityEnd++;
+            }
+            NSUInteger hostEnd = hostStart;
+            while (hostEnd < authorityEnd && chars[hostEnd] != ':') {
+                hostEnd++;
+            }
+            components.host = NSMakeRange(hostStart, hostEnd - hostStart);
+            pathStart = authorityEnd;
+        }
     }
 
-    // Photon rejects resizing mshots
-    if ([urlString rangeOfString:@"/mshots/"].location != NSNotFound) {
-        if (size.height == 0) {
-            urlString = [urlString stringByAppendingFormat:@"?w=%i", (int)size.width];
-        } else {
-            urlString = [urlString stringByAppendingFormat:@"?w=%i&h=%i", (int)size.width, (int)size.height];
+    NSUInteger pathEnd = pathStart;
+    while (pathEnd < length && chars[pathEnd] != '?' && chars[pathEnd] != '#') {
+        pathEnd++;
+    }
+    // Like -[NSURL pathExtension], ignore trailing slashes.
+    while (pathEnd > pathStart && chars[pathEnd - 1] == '/') {
+        pathEnd--;
+    }
+    for (NSUInteger k = pathEnd; k > pathStart; k--) {
+        unichar c = chars[k - 1];
+        if (c == '/') {
+            break;
+        }
+        if (c == '.') {
+            components.pathExtension = NSMakeRange(k, pathEnd - k);
+            break;
         }
-        return [NSURL URLWithString:urlString];
     }
+    return components;
+}
 
-    // Strip original resizing parameters, or we might get an image too small
-    NSRange imgpressRange = [urlString rangeOfString:@"?w="];
-    if (imgpressRange.location != NSNotFound) {
-        urlString = [urlString substringToIndex:imgpressRange.location];
+/// Returns YES if the host contains `i<digits>.wp.com`, ignoring case.
+static BOOL PhotonIsPhotonHost(const unichar *chars, NSRange host)
+{
+    if (host.location == NSNotFound) {
+        // Relative URLs may not have a host
+        return NO;
+    }
+    NSUInteger end = NSMaxRange(host);
+    for (NSUInteger i = host.location; i < end; i++) {
+        if (PhotonLowercase(chars[i]) != 'i') {
+            continue;
+        }
+        NSUInteger j = i + 1;
+        while (j < end && PhotonIsDigit(chars[j])) {
+            j++;
+        }
+        if (j > i + 1 && PhotonRangeEquals(chars, NSMakeRange(j, MIN(end - j, 7)), ".wp.com", YES)) {
+            return YES;
+        }
     }
+    return NO;
+}
 
-    BOOL useSSL = [[url scheme] isEqualToString:@"https"];
-    NSString *queryString = [self photonQueryStringForSize:size usingSSL:useSSL forceResize:forceResize quality:quality];
-    NSString *photonURLString = [NSString stringWithFormat:@"https://i0.wp.com/%@?%@", urlString, queryString];
-    return [NSURL URLWithString:photonURLString];
+/// Photon will fail if the URL doesn't end in one of the accepted extensions.
+static BOOL PhotonIsAcceptedImageType(const unichar *chars, NSRange pathExtension)
+{
+    return PhotonRangeEquals(chars, pathExtension, "gif", NO)
+        || PhotonRangeEquals(chars, pathExtension, "jpg", NO)
+        || PhotonRangeEquals(chars, pathExtension, "jpeg", NO)
+        || PhotonRangeEquals(chars, pathExtension, "png", NO);
+}
+
+#pragma mark - Building
+
+static inline void PhotonURLBufferInit(PhotonURLBuffer *buffer)
+{
+    buffer->heapCharacters = NULL;
+    buffer->heapCapacity = 0;
+}
+
+static inline void PhotonURLBufferFree(PhotonURLBuffer *buffer)
+{
+    free(buffer->heapCharacters);
+}
+
+static const unichar *PhotonURLBufferLoad(PhotonURLBuffer *buffer, NSString *string, NSUInteger length)
+{
+    const unichar *chars = CFStringGetCharactersPtr((__bridge CFStringRef)string);
+    if (chars) {
+        return chars;
+    }
+    unichar *characters = buffer->inlineCharacters;
+    if (length > PhotonURLInlineCapacity) {
+        if (buffer->heapCapacity < length) {
+            buffer->heapCharacters = reallocf(buffer->heapCharacters, length * sizeof(unichar));
+            buffer->heapCapacity = buffer->heapCharacters ? length : 0;
+            if (!buffer->heapCharacters) {
+                return NULL;
+            }
+        }
+        characters = buffer->heapCharacters;
+    }
+    [string getCharacters:characters range:NSMakeRange(0, length)];
+    return characters;
 }
 
 /**
- Constructs a Photon query string from the  supplied parameters.
+ Writes a Photon query string for the supplied parameters into `query`.
  */
-+ (NSString *)photonQueryStringForSize:(CGSize)size usingSSL:(BOOL)useSSL forceResize:(BOOL)forceResize quality:(NSUInteger)quality
+static void PhotonWriteQuery(char *query, CGSize size, BOOL useSSL, BOOL forceResize, NSUInteger quality)
 {
-    NSString *queryString;
+    int written = snprintf(query, PhotonQueryBufferSize, "quality=%lu&", (unsigned long)quality);
     if (size.height == 0) {
-        queryString = [NSString stringWithFormat:@"w=%i", (int)size.width];
+        written += snprintf(query + written, PhotonQueryBufferSize - written, "w=%i", (int)size.width);
     } else {
-        NSString *method = forceResize ? @"resize" : @"fit";
-        queryString = [NSString stringWithFormat:@"%@=%.0f,%.0f", method, size.width, size.height];
+        const char *method = forceResize ? "resize" : "fit";
+        written += snprintf(query + written, PhotonQueryBufferSize - written, "%s=%.0f,%.0f", method, size.width, size.height);
     }
-
-    if (useSSL) {
-        queryString = [NSString stringWithFormat:@"%@&ssl=1", queryString];
+    if (useSSL && written < (int)PhotonQueryBufferSize) {
+        snprintf(query + written, PhotonQueryBufferSize - written, "&ssl=1");
     }
+}
 
-    queryString = [NSString stringWithFormat:@"quality=%lu&%@", (unsigned long)quality, queryString];
-    
-    return queryString;
+static inline void PhotonAppendCharacters(NSMutableString *string, const unichar *chars, NSUInteger location, NSUInteger length)
+{
+    CFStringAppendCharacters((__bridge CFMutableStringRef)string, chars + location, length);
 }
 
-/**
- Inspects the specified URL to see if its uses Photon.
- 
- @return True if the URL is a photon URL. False otherwise.
- */
-+ (BOOL)isURLPhotonURL:(NSURL *)url
-{
-    static NSRegularExpression *regex;
-    static dispatch_once_t onceToken;
-    dispatch_once(&onceToken, ^{
-        NSError *error;
-        regex = [NSRegularExpression regularExpressionWithPattern:@"i\\d+\\.wp\\.com" options:NSRegularExpressionCaseInsensitive error:&error];
-    });
-    NSString *host = [url host];
-    if ([host length] > 0) { // relative URLs may not have a host
-        NSInteger count = [regex numberOfMatchesInString:host options:0 range:NSMakeRange(0, [host length])];
-        if (count > 0) {
-            return YES;
+static inline void PhotonAppendCString(NSMutableString *string, const char *cString)
+{
+    CFStringAppendCString((__bridge CFMutableStringRef)string, cString, kCFStringEncodingASCII);
+}
+
+@implementation PhotonImageURLHelper
+
++ (NSURL *)photonURLWithSize:(CGSize)size forImageURL:(NSURL *)url
+{
+    return [self photonURLWithSize:size forImageURL:url forceResize:YES imageQuality:DefaultPhotonImageQuality];
+}
+
++ (NSURL *)photonURLWithSize:(CGSize)size forImageURL:(NSURL *)url forceResize:(BOOL)forceResize imageQuality:(NSUInteger)quality
+{
+    PhotonURLBuffer buffer;
+    PhotonURLBufferInit(&buffer);
+    NSURL *photonURL = [self photonURLWithSize:size
+                                   forImageURL:url
+                                   forceResize:forceResize
+                                  imageQuality:quality
+                                         scale:[[UIScreen mainScreen] scale]
+                                        buffer:&buffer];
+    PhotonURLBufferFree(&buffer);
+    return photonURL;
+}
+
++ (NSArray<NSURL *> *)photonURLsWithSizes:(NSArray<NSValue *> *)sizes forImageURLs:(NSArray<NSURL *> *)urls
+{
+    return [self photonURLsWithSizes:sizes forImageURLs:urls forceResize:YES imageQuality:DefaultPhotonImageQuality];
+}
+
++ (NSArray<NSURL *> *)photonURLsWithSizes:(NSArray<NSValue *> *)sizes
+                             forImageURLs:(NSArray<NSURL *> *)urls
+                              forceResize:(BOOL)forceResize
+                             imageQuality:(NSUInteger)quality
+{
+    NSParameterAssert(sizes.count == urls.count);
+    NSUInteger count = MIN(sizes.count, urls.count);
+    CGFloat scale = [[UIScreen mainScreen] scale];
+    PhotonURLBuffer buffer;
+    PhotonURLBufferInit(&buffer);
+
+    NSMutableArray<NSURL *> *photonURLs = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++) {
+        NSURL *url = urls[i];
+        NSURL *photonURL = [self photonURLWithSize:[sizes[i] CGSizeValue]
+                                       forImageURL:url
+                                       forceResize:forceResize
+                                      imageQuality:quality
+                                             scale:scale
+                                            buffer:&buffer];
+        [photonURLs addObject:photonURL ?: url];
+    }
+    PhotonURLBufferFree(&buffer);
+    return photonURLs;
+}
+
++ (NSURL *)photonURLWithSize:(CGSize)size
+                 forImageURL:(NSURL *)url
+                 forceResize:(BOOL)forceResize
+                imageQuality:(NSUInteger)quality
+                       scale:(CGFloat)scale
+                      buffer:(PhotonURLBuffer *)buffer
+{
+    NSString *urlString = [url absoluteString];
+    NSUInteger length = [urlString length];
+    const unichar *chars = PhotonURLBufferLoad(buffer, urlString, length);
+    if (!urlString || (length > 0 && !chars)) {
+        return url;
+    }
+    PhotonURLComponents components = PhotonURLParse(chars, length);
+
+    if (!PhotonIsAcceptedImageType(chars, components.pathExtension)) {
+        if (components.scheme.location == NSNotFound) {
+            return [NSURL URLWithString:[@"http://" stringByAppendingString:urlString]];
         }
+        return url;
     }
-    return NO;
+
+    size.width *= scale;
+    size.height *= scale;
+    quality = MIN(MAX(quality, MinPhotonImageQuality), MaxPhotonImageQuality);
+    char query[PhotonQueryBufferSize];
+
+    // If the URL is already a Photon URL reject its photon params, and substitute our own.
+    if (PhotonIsPhotonHost(chars, components.host)) {
+        NSUInteger queryStart = NSNotFound;
+        for (NSUInteger i = length; i > 0; i--) {
+            if (chars[i - 1] == '?') {
+                queryStart = i - 1;
+                break;
+            }
+        }
+        if (queryStart == NSNotFound) {
+            // Saftey net. Don't photon photon!
+            return url;
+        }
+        BOOL useSSL = PhotonFind(chars, NSMakeRange(0, length), "ssl=1") != NSNotFound;
+        PhotonWriteQuery(query, size, useSSL, forceResize, quality);
+
+        NSMutableString *photonURLString = [NSMutableString stringWithCapacity:queryStart + 1 + PhotonQueryBufferSize];
+        PhotonAppendCharacters(photonURLString, chars, 0, queryStart);
+        PhotonAppendCString(photonURLString, "?");
+        PhotonAppendCString(photonURLString, query);
+        return [NSURL URLWithString:photonURLString];
+    }
+
+    // Drop the scheme
+    NSUInteger start = 0;
+    NSUInteger separator = PhotonFind(chars, NSMakeRange(0, MIN(length, 8)), "://");
+    if (separator != NSNotFound && separator < 6) {
+        start = separator + 3;
+    }
+    NSRange remainder = NSMakeRange(start, length - start);
+
+    // Photon rejects resizing mshots
+    if (PhotonFind(chars, remainder, "/mshots/") != NSNotFound) {
+        if (size.height == 0) {
+            snprintf(query, PhotonQueryBufferSize, "?w=%i", (int)size.width);
+        } else {
+            snprintf(query, PhotonQueryBufferSize, "?w=%i&h=%i", (int)size.width, (int)size.height);
+        }
+        NSMutableString *mshotsURLString = [NSMutableString stringWithCapacity:remainder.length + PhotonQueryBufferSize];
+        PhotonAppendCharacters(mshotsURLString, chars, remainder.location, remainder.length);
+        PhotonAppendCString(mshotsURLString, query);
+        return [NSURL URLWithString:mshotsURLString];
+    }
+
+    // Strip original resizing parameters, or we might get an image too small
+    NSUInteger imgpressLocation = PhotonFind(chars, remainder, "?w=");
+    if (imgpressLocation != NSNotFound) {
+        remainder.length = imgpressLocation - remainder.location;
+    }
+
+    BOOL useSSL = PhotonRangeEquals(chars, components.scheme, "https", NO);
+    PhotonWriteQuery(query, size, useSSL, forceResize, quality);
+
+    NSMutableString *photonURLString = [NSMutableString stringWithCapacity:remainder.length + 19 + PhotonQueryBufferSize];
+    PhotonAppendCString(photonURLString, "https://i0.wp.com/");
+    PhotonAppendCharacters(photonURLString, chars, remainder.location, remainder.length);
+    PhotonAppendCString(photonURLString, "?");
+    PhotonAppendCString(photonURLString, query);
+    return [NSURL URLWithString:photonURLString];
 }
 
 @end
@@ -0,0 +1,23 @@
+#import <Foundation/Foundation.h>
+
+typedef struct {
+	__unsafe_unretained NSString *escapeSequence;
+	unichar uchar;
+} HTMLEscapeMap;
+
+/// The named escape sequences recognized by the decoders, e.g. `&amp;`, ordered by character.
+extern const HTMLEscapeMap gAsciiHTMLEscapeMap[];
+extern const NSUInteger gAsciiHTMLEscapeMapCount;
+
+/**
+ *  Decodes the XML escape sequence at the start of `input`, which must begin with an `&`.
+ *
+ *  @param input            the characters to decode, starting at the `&`.
+ *  @param length           the number of characters available in `input`.
+ *  @param output           buffer receiving the decoded character. Must have room for 2 characters.
+ *  @param sequenceLength   on success, the length of the escape sequence including the `&` and `;`.
+ *
+ *  @return the number of UTF-16 characters written to `output`, or 0 if `input` doesn't start
+ *          with a recognized escape sequence.
+ */
+NSUInteger WPXMLDecodeEscapeSequenceAtStart(const unichar *input, NSUInteger length, unichar *output, NSUInteger *sequenceLength);
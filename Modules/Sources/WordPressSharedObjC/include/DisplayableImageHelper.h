@@ -1,5 +1,21 @@
 #import <Foundation/Foundation.h>
 
+/**
+ The images and gallery attachments found in a post's content by a single scan.
+ */
+@interface DisplayableImageContent : NSObject
+
+/// The URL path of the image to feature, or an empty string.
+@property (nonatomic, copy, readonly) NSString *imageToDisplay;
+
+/// The src attribute of every img tag, in the order they appear.
+@property (nonatomic, copy, readonly) NSArray<NSString *> *imageSources;
+
+/// The ids of the attachments referenced by gallery shortcodes.
+@property (nonatomic, copy, readonly) NSSet<NSNumber *> *galleryAttachmentIds;
+
+@end
+
 /**
  Helper for searching a post's content or attachments for an image suitable for 
  using as the displayed image in the post list. 
@@ -15,6 +31,16 @@
  */
 + (NSString *)searchPostAttachmentsForImageToDisplay:(NSDictionary *)attachmentsDict existingInContent:(NSString *)content;
 
+/**
+ Scan the passed html content once for its images and gallery shortcodes.
+
+ @details Prefer this over calling `searchPostContentForImageToDisplay:` and
+ `searchPostContentForAttachmentIdsInGalleries:` separately, which each scan the content.
+ @param content The content string to scan.
+ @return The images and gallery attachments found in the content.
+ */
++ (DisplayableImageContent *)scanPostContent:(NSString *)content;
+
 /**
  Search the passed string for an image that is a good candidate to feature.
 
@@ -5,6 +5,19 @@
 - (NSMutableDictionary *)dictionaryFromQueryString;
 - (NSString *)stringByReplacingHTMLEmoticonsWithEmoji;
 - (NSString *)stringByStrippingHTML;
+
+/**
+ *  Converts HTML into plain text in a single pass: tags are stripped, the contents of
+ *  `<script>` and `<style>` elements are skipped, entities are decoded and runs of
+ *  whitespace are collapsed into a single space.
+ *
+ *  @param maxLength    the conversion stops once this many characters have been produced,
+ *                      which makes it cheap to build excerpts out of long posts. A composed
+ *                      character sequence cut by the limit is left out as a whole.
+ *  @return the plain text representation of the string.
+ */
+- (NSString *)stringByConvertingHTMLToPlainTextWithMaxLength:(NSUInteger)maxLength;
+- (NSString *)stringByConvertingHTMLToPlainText;
 - (NSString *)stringByEllipsizingWithMaxLength:(NSInteger)lengthlimit preserveWords:(BOOL)preserveWords;
 - (BOOL)isWordPressComPath;
 
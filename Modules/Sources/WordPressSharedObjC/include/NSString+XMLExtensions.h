@@ -4,6 +4,13 @@
 
 + (NSString *)encodeXMLCharactersIn : (NSString *)source;
 + (NSString *)decodeXMLCharactersIn : (NSString *)source;
+
+/**
+ *  Appends the UTF-8 representation of `source` to `data`, escaping XML characters
+ *  the same way as `encodeXMLCharactersIn:`, without creating an intermediate string.
+ */
++ (void)appendXMLEncodedCharactersIn:(NSString *)source toData:(NSMutableData *)data;
+
 - (NSString *)stringByDecodingXMLCharacters;
 - (NSString *)stringByEncodingXMLCharacters;
 
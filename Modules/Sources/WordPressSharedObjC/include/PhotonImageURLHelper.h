@@ -39,4 +39,33 @@
                  forceResize:(BOOL)forceResize
                 imageQuality:(NSUInteger)quality;
 
+/**
+ Create "photonized" URLs for a batch of image URLs, such as the images being prefetched,
+ with the same defaults as `photonURLWithSize:forImageURL:`.
+
+ @param sizes The desired "points" size of each photon image, as `CGSize` values.
+ @param urls The URLs to the source images. Must have as many elements as `sizes`.
+
+ @return The photon URL of each source image, in the same order. A source URL that can't be
+        photonized is returned unchanged.
+ */
++ (NSArray<NSURL *> *)photonURLsWithSizes:(NSArray<NSValue *> *)sizes forImageURLs:(NSArray<NSURL *> *)urls;
+
+/**
+ Create "photonized" URLs for a batch of image URLs, such as the images being prefetched.
+ Building the URLs together avoids repeating the per-call setup for each image.
+
+ @param sizes The desired "points" size of each photon image, as `CGSize` values.
+ @param urls The URLs to the source images. Must have as many elements as `sizes`.
+ @param forceResize Whether the returned images should match the specified sizes.
+ @param quality An integer value 1 - 100. Passed values are constrained to this range.
+
+ @return The photon URL of each source image, in the same order. A source URL that can't be
+        photonized is returned unchanged.
+ */
++ (NSArray<NSURL *> *)photonURLsWithSizes:(NSArray<NSValue *> *)sizes
+                             forImageURLs:(NSArray<NSURL *> *)urls
+                              forceResize:(BOOL)forceResize
+                             imageQuality:(NSUInteger)quality;
+
 @end
@@ -0,0 +1,83 @@
+import UIKit
+import Testing
+import AsyncImageKit
+
+final class DiskImageCacheTests {
+    private let directory = FileManager.default.temporaryDirectory
+        .appendingPathComponent(UUID().uuidString, isDirectory: true)
+
+    deinit {
+        try? FileManager.default.removeItem(at: directory)
+    }
+
+    @Test func storeAndLoadImage() async throws {
+        // GIVEN
+        let sut = DiskImageCache(directory: directory)
+        let size = ImageSize(width: 40, height: 30)
+        let image = makeImage(size: size, color: .red)
+
+        // WHEN
+        await sut.setImage(image, forKey: "image", size: size)
+
+        // THEN the bitmap is read back from a new cache instance
+        let cachedImage = try #require(await DiskImageCache(directory: directory).image(forKey: "image", size: size))
+        #expect(cachedImage.size == CGSize(width: 40, height: 30))
+        #expect(cachedImage.cgImage?.width == 40)
+        #expect(cachedImage.cgImage?.height == 30)
+        #expect(await sut.image(forKey: "image", size: ImageSize(width: 400, height: 300)) == nil)
+    }
+
+    @Test func evictLeastRecentlyUsedImages() async throws {
+        // GIVEN a cache that fits two 32×32 bitmaps
+        let size = ImageSize(width: 32, height: 32)
+        let sut = DiskImageCache(directory: directory, sizeLimit: 2 * (32 * 32 * 4 + 32))
+        await sut.setImage(makeImage(size: size, color: .red), forKey: "a", size: size)
+        await sut.setImage(makeImage(size: size, color: .green), forKey: "b", size: size)
+
+        // WHEN "a" is used, then a third image is added
+        #expect(await sut.image(forKey: "a", size: size) != nil)
+        await sut.setImage(makeImage(size: size, color: .blue), forKey: "c", size: size)
+
+        // THEN "b" is evicted
+        #expect(await sut.image(forKey: "a", size: size) != nil)
+        #expect(await sut.image(forKey: "b", size: size) == nil)
+        #expect(await sut.image(forKey: "c", size: size) != nil)
+    }
+
+    @Test func removeAllImages() async {
+        let size = ImageSize(width: 32, height: 32)
+        let sut = DiskImageCache(directory: directory)
+        await sut.setImage(makeImage(size: size, color: .red), forKey: "a", size: size)
+
+        await sut.removeAllImages()
+
+        #expect(await sut.image(forKey: "a", size: size) == nil)
+        #expect(await DiskImageCache(directory: directory).image(forKey: "a", size: size) == nil)
+    }
+
+    @Test func removeExpiredImages() async {
+        let size = ImageSize(width: 32, height: 32)
+        await DiskImageCache(directory: directory).setImage(makeImage(size: size, color: .red), forKey: "a", size: size)
+
+        let sut = DiskImageCache(directory: directory, maxAge: 0)
+
+        #expect(await sut.image(forKey: "a", size: size) == nil)
+    }
+
+    // MARK: - Helpers
+
+    private func makeImage(size: ImageSize, color: UIColor) -> UIImage {
+        let format = UIGraphicsImageRendererFormat()
+        format.scale = 1
+        return UIGraphicsImageRenderer(size: CGSize(size), format: format).image { context in
+            color.setFill()
+            context.fill(CGRect(origin: .zero, size: CGSize(size)))
+        }
+    }
+}
+
+private extension CGSize {
+    init(_ size: ImageSize) {
+        self.init(width: size.width, height: size.height)
+    }
+}
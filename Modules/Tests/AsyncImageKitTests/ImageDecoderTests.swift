@@ -0,0 +1,37 @@
+import UIKit
+import Testing
+import WordPressTesting
+@testable import AsyncImageKit
+
+struct ImageDecoderTests {
+    @Test func makePreviewFromPartialData() throws {
+        // GIVEN the first part of a JPEG image (1024×680 px)
+        let data = try makeImageData()
+        let sut = ProgressiveImageDecoder(size: CGSize(width: 256, height: 256))
+
+        // WHEN
+        let preview = try #require(sut.makePreview(from: data.prefix(data.count * 2 / 3)))
+
+        // THEN the preview is downsampled to the target size
+        #expect(preview.cgImage?.width == 386)
+        #expect(preview.cgImage?.height == 256)
+    }
+
+    @Test func makeNoPreviewWithoutEnoughData() throws {
+        let data = try makeImageData()
+        let sut = ProgressiveImageDecoder(size: CGSize(width: 256, height: 256))
+
+        #expect(sut.makePreview(from: data.prefix(2)) == nil)
+    }
+
+    @Test func makeNoPreviewForOtherFormats() throws {
+        let sut = ProgressiveImageDecoder(size: nil)
+
+        #expect(sut.makePreview(from: Data("GIF89a".utf8) + Data(count: 1024)) == nil)
+    }
+
+    private func makeImageData() throws -> Data {
+        let sourceURL = try #require(Bundle.test.url(forResource: "test-image", withExtension: "jpg"))
+        return try Data(contentsOf: sourceURL)
+    }
+}
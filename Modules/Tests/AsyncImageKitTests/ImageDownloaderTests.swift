@@ -1,6 +1,6 @@
 import UIKit
 import Testing
-import AsyncImageKit
+@testable import AsyncImageKit
 import WordPressTesting
 import OHHTTPStubs
 import OHHTTPStubsSwift
@@ -11,7 +11,7 @@ import OHHTTPStubsSwift
     private let cache = MockMemoryCache()
 
     init() async throws {
-        sut = ImageDownloader(cache: cache)
+        sut = ImageDownloader(cache: cache, diskCache: nil)
     }
 
     deinit {
@@ -124,6 +124,137 @@ import OHHTTPStubsSwift
         #expect(image.size == CGSize(width: 1024, height: 680))
     }
 
+    @Test func diskCache() async throws {
+        // GIVEN
+        let imageURL = try #require(URL(string: "https://example.files.wordpress.com/2023/09/image.jpg"))
+        try mockResponse(withResource: "test-image", fileExtension: "jpg")
+
+        let directory = FileManager.default.temporaryDirectory.appendingPathComponent(UUID().uuidString)
+        defer { try? FileManager.default.removeItem(at: directory) }
+        let diskCache = DiskImageCache(directory: directory)
+
+        let size = ImageSize(width: 256, height: 256)
+        let options = ImageRequestOptions(size: size, isMemoryCacheEnabled: false, isDiskCacheEnabled: true)
+        _ = try await ImageDownloader(cache: cache, diskCache: diskCache).image(from: imageURL, options: options)
+
+        // GIVEN the network is unavailable and the thumbnail was written to disk
+        HTTPStubs.removeAllStubs()
+        stub(condition: { _ in true }, response: { _ in
+            HTTPStubsResponse(error: URLError(.unknown))
+        })
+        for _ in 0..<100 {
+            if await diskCache.image(forKey: imageURL.absoluteString + "?w=256,h=256", size: size) != nil {
+                break
+            }
+            try await Task.sleep(for: .milliseconds(20))
+        }
+
+        // WHEN
+        let image = try await ImageDownloader(cache: cache, diskCache: diskCache).image(from: imageURL, options: options)
+
+        // THEN resized image is returned from disk cache
+        #expect(image.size == CGSize(width: 386, height: 256))
+    }
+
+    @Test func startVisibleDownloadsFirst() async throws {
+        // GIVEN a single download slot, and the order the requests reach the network is recorded
+        let sourceURL = try #require(Bundle.test.url(forResource: "test-image", withExtension: "jpg"))
+        let data = try Data(contentsOf: sourceURL)
+        let requestedPaths = LockedArray()
+        stub(condition: { request in
+            requestedPaths.appendIfNeeded(request.url?.lastPathComponent ?? "")
+            return true
+        }, response: { _ in
+            HTTPStubsResponse(data: data, statusCode: 200, headers: nil).requestTime(0.5, responseTime: 0)
+        })
+        let scheduler = ImageRequestScheduler(concurrency: AdaptiveConcurrencyLimit(initialLimit: 1, range: 1...1))
+        let sut = ImageDownloader(cache: cache, diskCache: nil, scheduler: scheduler)
+
+        func load(_ name: String, priority: ImageRequestPriority) throws -> Task<UIImage, Error> {
+            let imageURL = try #require(URL(string: "https://example.files.wordpress.com/2023/09/\(name).jpg"))
+            let options = ImageRequestOptions(isMemoryCacheEnabled: false, isDiskCacheEnabled: false, priority: priority)
+            return Task { try await sut.image(from: imageURL, options: options) }
+        }
+
+        // WHEN
+        let first = try load("first", priority: .visible)
+        for _ in 0..<100 where await scheduler.runningCount == 0 {
+            try await Task.sleep(for: .milliseconds(10))
+        }
+        let speculative = try load("speculative", priority: .speculative)
+        let visible = try load("visible", priority: .visible)
+        for _ in 0..<100 where await scheduler.pendingCount < 2 {
+            try await Task.sleep(for: .milliseconds(10))
+        }
+        for task in [first, speculative, visible] {
+            _ = try await task.value
+        }
+
+        // THEN
+        #expect(requestedPaths.values == ["first.jpg", "visible.jpg", "speculative.jpg"])
+    }
+
+    @Test func progressiveDecoding() async throws {
+        // GIVEN remote image is mocked (1024×680 px) and delivered over a second
+        let imageURL = try #require(URL(string: "https://example.files.wordpress.com/2023/09/image.jpg"))
+        let sourceURL = try #require(Bundle.test.url(forResource: "test-image", withExtension: "jpg"))
+        let data = try Data(contentsOf: sourceURL)
+        stub(condition: { _ in true }, response: { _ in
+            HTTPStubsResponse(data: data, statusCode: 200, headers: ["Content-Length": "\(data.count)"])
+                .responseTime(1)
+        })
+
+        // WHEN
+        let options = ImageRequestOptions(
+            size: ImageSize(width: 256, height: 256),
+            isMemoryCacheEnabled: false,
+            isDiskCacheEnabled: false,
+            isProgressiveDecodingEnabled: true
+        )
+        let previews = LockedArray()
+        let image = try await sut.image(for: ImageRequest(url: imageURL, options: options)) { preview in
+            previews.appendIfNeeded("\(Int(preview.size.width))x\(Int(preview.size.height))")
+        }
+
+        // THEN downsampled previews are delivered before the image
+        #expect(previews.values == ["386x256"])
+        #expect(image.size == CGSize(width: 386, height: 256))
+    }
+
+    @Test func progressiveDecodingWhenJoiningDownload() async throws {
+        // GIVEN remote image is mocked (1024×680 px) and delivered over a second
+        let imageURL = try #require(URL(string: "https://example.files.wordpress.com/2023/09/image.jpg"))
+        let sourceURL = try #require(Bundle.test.url(forResource: "test-image", withExtension: "jpg"))
+        let data = try Data(contentsOf: sourceURL)
+        stub(condition: { _ in true }, response: { _ in
+            HTTPStubsResponse(data: data, statusCode: 200, headers: ["Content-Length": "\(data.count)"])
+                .responseTime(1)
+        })
+
+        // GIVEN the download was started without previews
+        let options = ImageRequestOptions(
+            size: ImageSize(width: 256, height: 256),
+            isMemoryCacheEnabled: false,
+            isDiskCacheEnabled: false
+        )
+        let first = Task { [sut] in
+            try await sut.data(for: ImageRequest(url: imageURL, options: options))
+        }
+        try await Task.sleep(for: .milliseconds(50))
+
+        // WHEN a request with previews joins it
+        var progressiveOptions = options
+        progressiveOptions.isProgressiveDecodingEnabled = true
+        let previews = LockedArray()
+        _ = try await sut.image(for: ImageRequest(url: imageURL, options: progressiveOptions)) { preview in
+            previews.appendIfNeeded("\(Int(preview.size.width))x\(Int(preview.size.height))")
+        }
+
+        // THEN
+        #expect(previews.values == ["386x256"])
+        #expect(try await first.value == data)
+    }
+
     // MARK: - Helpers
 
     func mockResponse(withResource name: String, fileExtension: String, expectedURL: URL? = nil, delay: TimeInterval = 0) throws {
@@ -154,3 +285,20 @@ private final class MockMemoryCache: MemoryCacheProtocol, @unchecked Sendable {
         cache = [:]
     }
 }
+
+private final class LockedArray: @unchecked Sendable {
+    private let lock = NSLock()
+    private var _values: [String] = []
+
+    var values: [String] {
+        lock.withLock { _values }
+    }
+
+    func appendIfNeeded(_ value: String) {
+        lock.withLock {
+            if !_values.contains(value) {
+                _values.append(value)
+            }
+        }
+    }
+}
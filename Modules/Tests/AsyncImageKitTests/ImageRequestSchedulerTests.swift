@@ -0,0 +1,188 @@
+import Foundation
+import Testing
+@testable import AsyncImageKit
+
+@ImageDownloaderActor
+struct ImageRequestSchedulerTests {
+    @Test func startHighestPriorityFirst() async throws {
+        // GIVEN a single slot taken by a download
+        let sut = ImageRequestScheduler(concurrency: AdaptiveConcurrencyLimit(initialLimit: 1, range: 1...1))
+        let ticket = try await sut.start(key: "first", priority: .visible)
+
+        // GIVEN downloads waiting for the slot
+        let recorder = Recorder()
+        let tasks = [
+            start("speculative", priority: .speculative, scheduler: sut, recorder: recorder),
+            start("nearVisible", priority: .nearVisible, scheduler: sut, recorder: recorder),
+            start("visible", priority: .visible, scheduler: sut, recorder: recorder)
+        ]
+        try await waitUntil { sut.pendingCount == 3 }
+
+        // WHEN
+        sut.finish(ticket)
+        for task in tasks {
+            try await task.value
+        }
+
+        // THEN
+        #expect(recorder.keys == ["visible", "nearVisible", "speculative"])
+    }
+
+    @Test func reprioritizePendingDownloads() async throws {
+        // GIVEN
+        let sut = ImageRequestScheduler(concurrency: AdaptiveConcurrencyLimit(initialLimit: 1, range: 1...1))
+        let ticket = try await sut.start(key: "first", priority: .visible)
+
+        let recorder = Recorder()
+        let first = start("a", priority: .speculative, scheduler: sut, recorder: recorder)
+        try await waitUntil { sut.pendingCount == 1 }
+        let second = start("b", priority: .speculative, scheduler: sut, recorder: recorder)
+        try await waitUntil { sut.pendingCount == 2 }
+
+        // WHEN the second image scrolls into view
+        sut.setPriority(.visible, forKey: "b")
+        sut.finish(ticket)
+        try await first.value
+        try await second.value
+
+        // THEN
+        #expect(recorder.keys == ["b", "a"])
+    }
+
+    @Test func keepSlotForVisibleDownloads() async throws {
+        // GIVEN two slots, one of which is taken
+        let sut = ImageRequestScheduler(concurrency: AdaptiveConcurrencyLimit(initialLimit: 2, range: 2...2))
+        _ = try await sut.start(key: "first", priority: .visible)
+
+        // WHEN
+        let recorder = Recorder()
+        let speculative = start("speculative", priority: .speculative, scheduler: sut, recorder: recorder)
+        try await waitUntil { sut.pendingCount == 1 }
+
+        // THEN the speculative download waits, but the visible one doesn't
+        _ = try await sut.start(key: "visible", priority: .visible)
+        #expect(sut.runningCount == 2)
+        #expect(sut.pendingCount == 1)
+
+        speculative.cancel()
+        try await waitUntil { sut.pendingCount == 0 }
+    }
+
+    @Test func cancelPendingDownload() async throws {
+        // GIVEN
+        let sut = ImageRequestScheduler(concurrency: AdaptiveConcurrencyLimit(initialLimit: 1, range: 1...1))
+        _ = try await sut.start(key: "first", priority: .visible)
+        let task = start("pending", priority: .visible, scheduler: sut, recorder: Recorder())
+        try await waitUntil { sut.pendingCount == 1 }
+
+        // WHEN
+        task.cancel()
+
+        // THEN
+        do {
+            try await task.value
+            Issue.record("Expected the download to be cancelled")
+        } catch {
+            #expect(error is CancellationError)
+        }
+        #expect(sut.pendingCount == 0)
+        #expect(sut.runningCount == 1)
+    }
+
+    // MARK: - AdaptiveConcurrencyLimit
+
+    @Test func increaseLimitAdditively() {
+        var sut = AdaptiveConcurrencyLimit(initialLimit: 4, range: 2...8)
+
+        // WHEN a full window of downloads succeeds
+        for _ in 0..<5 {
+            sut.recordSuccess(bytes: 100_000, timeToFirstByte: 0.05, duration: 0.1)
+        }
+
+        // THEN
+        #expect(sut.limit == 5)
+    }
+
+    @Test func decreaseLimitMultiplicativelyOnFailure() {
+        var sut = AdaptiveConcurrencyLimit(initialLimit: 8, range: 2...8)
+
+        sut.recordFailure()
+        #expect(sut.limit == 4)
+
+        sut.recordFailure()
+        sut.recordFailure()
+        #expect(sut.limit == 2)
+    }
+
+    @Test func decreaseLimitWhenLatencyDegrades() {
+        var sut = AdaptiveConcurrencyLimit(initialLimit: 4, range: 2...8)
+        sut.recordSuccess(bytes: 100_000, timeToFirstByte: 0.05, duration: 0.1)
+
+        // WHEN a response takes much longer to start without the throughput improving
+        sut.recordSuccess(bytes: 100_000, timeToFirstByte: 0.5, duration: 1)
+
+        // THEN
+        #expect(sut.limit == 2)
+    }
+
+    @Test func keepLimitWhenThroughputImproves() {
+        var sut = AdaptiveConcurrencyLimit(initialLimit: 4, range: 2...8)
+        sut.recordSuccess(bytes: 100_000, timeToFirstByte: 0.05, duration: 0.1)
+
+        // WHEN a response takes longer to start, but uses the bandwidth better
+        sut.recordSuccess(bytes: 10_000_000, timeToFirstByte: 0.5, duration: 1)
+
+        // THEN
+        #expect(sut.limit == 4)
+    }
+
+    @Test func keepLimitForLargeDownloads() {
+        var sut = AdaptiveConcurrencyLimit(initialLimit: 4, range: 2...8)
+        sut.recordSuccess(bytes: 100_000, timeToFirstByte: 0.05, duration: 0.1)
+
+        // WHEN a large image takes long to download, but its response starts as fast
+        sut.recordSuccess(bytes: 2_000_000, timeToFirstByte: 0.05, duration: 4)
+
+        // THEN
+        #expect(sut.limit == 4)
+    }
+
+    @Test func decreaseLimitOnlyForCongestionFailures() async throws {
+        let sut = ImageRequestScheduler(concurrency: AdaptiveConcurrencyLimit(initialLimit: 8, range: 2...8))
+
+        // WHEN an image is missing
+        sut.finish(try await sut.start(key: "a", priority: .visible), error: ImageDownloaderError.unacceptableStatusCode(404))
+        #expect(sut.concurrencyLimit == 8)
+
+        // WHEN the server is throttling the requests
+        sut.finish(try await sut.start(key: "b", priority: .visible), error: ImageDownloaderError.unacceptableStatusCode(429))
+        #expect(sut.concurrencyLimit == 4)
+    }
+
+    // MARK: - Helpers
+
+    private func start(
+        _ key: String,
+        priority: ImageRequestPriority,
+        scheduler: ImageRequestScheduler,
+        recorder: Recorder
+    ) -> Task<Void, Error> {
+        Task { @ImageDownloaderActor in
+            let ticket = try await scheduler.start(key: key, priority: priority)
+            recorder.keys.append(key)
+            scheduler.finish(ticket)
+        }
+    }
+
+    private func waitUntil(_ condition: () -> Bool) async throws {
+        for _ in 0..<1000 where !condition() {
+            try await Task.sleep(for: .milliseconds(1))
+        }
+        try #require(condition())
+    }
+}
+
+@ImageDownloaderActor
+private final class Recorder {
+    var keys: [String] = []
+}
@@ -0,0 +1,126 @@
+import UIKit
+import Testing
+import AsyncImageKit
+
+struct MemoryCacheTests {
+    @Test func evictLeastRecentlyUsedData() {
+        // GIVEN more data than fits in the budget
+        let sut = MemoryCache(imageCostLimit: 0, dataCostLimit: 8 * 1000)
+        for index in 0..<100 {
+            sut.setData(Data(count: 100), forKey: "\(index)")
+        }
+
+        // THEN the pool stays within its budget and the most recent entry is kept
+        let statistics = sut.dataStatistics
+        #expect(statistics.totalCost <= 8 * 1000)
+        #expect(statistics.evictions == 100 - statistics.count)
+        #expect(sut.geData(forKey: "99") != nil)
+    }
+
+    @Test func recentlyUsedEntriesAreKept() {
+        // GIVEN a budget with room for a single entry per shard
+        let sut = MemoryCache(imageCostLimit: 0, dataCostLimit: 8 * 150)
+        sut.setData(Data(count: 100), forKey: "a")
+
+        // WHEN
+        for index in 0..<100 {
+            _ = sut.geData(forKey: "a")
+            sut.setData(Data(count: 10), forKey: "\(index)")
+        }
+
+        // THEN the older entries are evicted first
+        #expect(sut.geData(forKey: "a") != nil)
+    }
+
+    @Test func oversizeEntriesAreNotCached() {
+        // GIVEN a budget of 8000 bytes, filled with small entries
+        let sut = MemoryCache(imageCostLimit: 0, dataCostLimit: 8 * 1000)
+        for index in 0..<40 {
+            sut.setData(Data(count: 100), forKey: "\(index)")
+        }
+
+        // WHEN an entry larger than the whole budget is added
+        sut.setData(Data(count: 8 * 1000 + 1), forKey: "large")
+
+        // THEN it is rejected without evicting anything
+        #expect(sut.geData(forKey: "large") == nil)
+        #expect(sut.dataStatistics.count == 40)
+        #expect(sut.dataStatistics.evictions == 0)
+    }
+
+    @Test func entriesLargerThanAShardAreCached() {
+        // GIVEN a budget of 1000 bytes per shard, filled with small entries
+        let sut = MemoryCache(imageCostLimit: 0, dataCostLimit: 8 * 1000)
+        for index in 0..<40 {
+            sut.setData(Data(count: 100), forKey: "\(index)")
+        }
+
+        // WHEN an entry larger than a shard is added
+        sut.setData(Data(count: 6000), forKey: "large")
+
+        // THEN it is cached, and the pool stays within its budget
+        #expect(sut.geData(forKey: "large")?.count == 6000)
+        let statistics = sut.dataStatistics
+        #expect(statistics.totalCost <= 8 * 1000)
+        #expect(statistics.count == 21)
+        #expect(statistics.evictions == 20)
+    }
+
+    @Test func imagesAndDataHaveSeparateBudgets() {
+        let sut = MemoryCache(imageCostLimit: 8 * 1_000_000, dataCostLimit: 0)
+
+        sut.setData(Data(count: 100), forKey: "data")
+        sut["image"] = makeImage()
+
+        #expect(sut.geData(forKey: "data") == nil)
+        #expect(sut["image"] != nil)
+        #expect(sut.imageStatistics.count == 1)
+        #expect(sut.dataStatistics.count == 0)
+    }
+
+    @Test func statistics() {
+        let sut = MemoryCache()
+
+        let image = makeImage()
+        sut["image"] = image
+        _ = sut["image"]
+        _ = sut["missing"]
+
+        let statistics = sut.imageStatistics
+        #expect(statistics.hits == 1)
+        #expect(statistics.misses == 1)
+        #expect(statistics.count == 1)
+        #expect(statistics.totalCost == image.cgImage.map { $0.bytesPerRow * $0.height })
+        #expect(statistics.costLimit == 256_000_000)
+    }
+
+    @Test func trimKeepsPartOfTheCache() {
+        let sut = MemoryCache(imageCostLimit: 0, dataCostLimit: 8 * 1000)
+        for index in 0..<80 {
+            sut.setData(Data(count: 100), forKey: "\(index)")
+        }
+        let countBeforeTrim = sut.dataStatistics.count
+
+        sut.trim(toRatio: 0.5)
+
+        let statistics = sut.dataStatistics
+        #expect(statistics.count > 0)
+        #expect(statistics.count < countBeforeTrim)
+        #expect(statistics.totalCost <= 4 * 1000)
+        #expect(sut.geData(forKey: "79") != nil)
+
+        sut.removeAllObjects()
+        #expect(sut.dataStatistics.count == 0)
+        #expect(sut.dataStatistics.totalCost == 0)
+    }
+
+    private func makeImage() -> UIImage {
+        let format = UIGraphicsImageRendererFormat()
+        format.scale = 1
+        format.opaque = true
+        return UIGraphicsImageRenderer(size: CGSize(width: 10, height: 10), format: format).image { context in
+            UIColor.red.setFill()
+            context.fill(CGRect(x: 0, y: 0, width: 10, height: 10))
+        }
+    }
+}
@@ -105,4 +105,28 @@ static NSString * const PathForAttachmentD = @"http://www.example.com/exampleD.p
     XCTAssertTrue(imageSrc.length == 0, @"It shouldn't find an image since the width is too small");
 }
 
+- (void)testSearchPostContentForImageToDisplayFallsBackToSizeClass
+{
+    NSString *imageSrc = [DisplayableImageHelper searchPostContentForImageToDisplay:@"<img class=\"size-medium\" src=\"http://photo.com/medium.jpg\" /> <IMG CLASS='aligncenter size-large' SRC='http://photo.com/large.jpg?resize=100' />"];
+    XCTAssertEqualObjects(imageSrc, @"http://photo.com/large.jpg", @"It should prefer the large image and drop its query");
+
+    imageSrc = [DisplayableImageHelper searchPostContentForImageToDisplay:@"<img src=\"http://photo.com/small.jpg?w=100\" /> <img src=\"http://photo.com/big.jpg?fit=1&amp;w=600\" />"];
+    XCTAssertEqualObjects(imageSrc, @"http://photo.com/big.jpg?fit=1&amp;w=600", @"It should read the width from the w query parameter");
+}
+
+- (void)testScanPostContent
+{
+    DisplayableImageContent *result = [DisplayableImageHelper scanPostContent:@"<p><img width=\"400\" src=\"http://photo.com/400.jpg\"></p> [gallery ids=\"12,,34\"] <img src=\"http://photo.com/emoji.png\">"];
+
+    NSArray *expectedSources = @[@"http://photo.com/400.jpg", @"http://photo.com/emoji.png"];
+    XCTAssertEqualObjects(result.imageSources, expectedSources);
+    XCTAssertEqualObjects(result.imageToDisplay, @"http://photo.com/400.jpg");
+    XCTAssertEqualObjects(result.galleryAttachmentIds, ([NSSet setWithObjects:@12, @34, nil]));
+
+    result = [DisplayableImageHelper scanPostContent:nil];
+    XCTAssertEqualObjects(result.imageToDisplay, @"");
+    XCTAssertEqual(result.imageSources.count, 0);
+    XCTAssertEqual(result.galleryAttachmentIds.count, 0);
+}
+
 @end
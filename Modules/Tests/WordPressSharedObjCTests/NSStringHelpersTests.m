@@ -1,5 +1,6 @@
 #import <XCTest/XCTest.h>
 #import "NSString+Helpers.h"
+#import "NSString+XMLExtensions.h"
 
 @interface NSString ()
 + (NSString *)emojiCharacterFromCoreEmojiFilename:(NSString *)filename;
@@ -178,6 +179,46 @@
     XCTAssertEqualObjects(expected, replacedString, @"The image tag was not replaced with an emoji string");
 }
 
+- (void)testStringByReplacingHTMLEmoticonsWithEmojiReplacesSmilies
+{
+    NSString *html = @"Hi <img src='https://example.com/wp-includes/images/smilies/icon_smile.gif' alt=':)' class='wp-smiley' /> there";
+    XCTAssertEqualObjects([html stringByReplacingHTMLEmoticonsWithEmoji], @"Hi 😊 there");
+
+    html = @"<IMG SRC=\"https://example.com/wp-includes/images/smilies/simple-smile.png?m=123\" class=\"wp-smiley\">";
+    XCTAssertEqualObjects([html stringByReplacingHTMLEmoticonsWithEmoji], @"😊");
+}
+
+- (void)testStringByReplacingHTMLEmoticonsWithEmojiReplacesWPComSmileys
+{
+    NSString *html = @"<p><img src=\"https://s0.wp.com/wp-content/mu-plugins/wpcom-smileys/icon_wink.svg\" class=\"wp-smiley\" style=\"height: 1em;\"></p>";
+    XCTAssertEqualObjects([html stringByReplacingHTMLEmoticonsWithEmoji], @"<p>😉</p>");
+}
+
+- (void)testStringByReplacingHTMLEmoticonsWithEmojiKeepsUnknownSmilies
+{
+    NSString *html = @"<img src=\"https://example.com/wp-includes/images/smilies/unknown.gif\" class=\"wp-smiley\">";
+    XCTAssertEqualObjects([html stringByReplacingHTMLEmoticonsWithEmoji], html);
+}
+
+- (void)testStringByReplacingHTMLEmoticonsWithEmojiReturnsOriginalStringWithoutMatches
+{
+    NSString *html = @"<p>No smileys here <img src=\"https://example.com/photo.jpg\"></p>";
+    XCTAssertTrue([html stringByReplacingHTMLEmoticonsWithEmoji] == html);
+}
+
+- (void)testStringByReplacingHTMLEmoticonsWithEmojiPerformance
+{
+    NSString *comment = @"<p>Great post <img src=\"https://s.w.org/images/core/emoji/15.0.3/72x72/1f600.png\" alt=\"😀\" class=\"wp-smiley\" style=\"height: 1em; max-height: 1em;\"> "
+        "thanks for sharing <img src=\"https://example.com/wp-includes/images/smilies/icon_wink.gif\" alt=\";)\" class=\"wp-smiley\" /></p>"
+        "<p><img src=\"https://example.files.wordpress.com/2020/01/photo.jpg?w=600\" class=\"size-large\"></p>";
+
+    [self measureBlock:^{
+        for (NSInteger i = 0; i < 5000; i++) {
+            [comment stringByReplacingHTMLEmoticonsWithEmoji];
+        }
+    }];
+}
+
 - (void)testNormalizeWhitespace
 {
     NSString *sourceString = @"This     is a \n\n\n test    string.   ";
@@ -186,4 +227,132 @@
     XCTAssertTrue([expectedString isEqualToString:[sourceString stringByNormalizingWhitespace]]);
 }
 
+- (void)testNormalizeWhitespaceKeepsSingleWhitespaceCharacters
+{
+    XCTAssertEqualObjects([@"a\nb\tc d" stringByNormalizingWhitespace], @"a\nb\tc d");
+    XCTAssertEqualObjects([@"  leading and trailing  " stringByNormalizingWhitespace], @" leading and trailing ");
+    XCTAssertEqualObjects([@"" stringByNormalizingWhitespace], @"");
+}
+
+- (void)testStrippingHTML
+{
+    XCTAssertEqualObjects([@"<p>Hello <b>World</b></p>" stringByStrippingHTML], @"Hello World");
+    XCTAssertEqualObjects([@"<a href=\"x\"\n title=\"y\">Link</a>" stringByStrippingHTML], @"Link");
+    XCTAssertEqualObjects([@"1 < 2 and <> stays" stringByStrippingHTML], @"1 < 2 and <> stays");
+    XCTAssertEqualObjects([@"Entities &amp; stay" stringByStrippingHTML], @"Entities &amp; stay");
+}
+
+- (void)testConvertingHTMLToPlainText
+{
+    NSString *html = @"<p>Fish &amp; Chips</p>\n\n<p>Caf&eacute;   &#8220;open&#8221;</p>";
+    XCTAssertEqualObjects([html stringByConvertingHTMLToPlainText], @"Fish & Chips Café “open”");
+}
+
+- (void)testConvertingHTMLToPlainTextSkipsScriptAndStyle
+{
+    NSString *html = @"<style>p { color: red; }</style><p>Visible</p><SCRIPT type=\"text/javascript\">var a = '<b>';</SCRIPT> text";
+    XCTAssertEqualObjects([html stringByConvertingHTMLToPlainText], @"Visible text");
+}
+
+- (void)testConvertingHTMLToPlainTextDoesNotSkipElementsStartingWithScriptOrStyle
+{
+    NSString *html = @"<styled-box>Visible</styled-box>";
+    XCTAssertEqualObjects([html stringByConvertingHTMLToPlainText], @"Visible");
+}
+
+- (void)testConvertingHTMLToPlainTextStopsAtMaxLength
+{
+    NSString *html = @"<p>The quick brown fox</p> <p>jumps over the lazy dog.</p>";
+    XCTAssertEqualObjects([html stringByConvertingHTMLToPlainTextWithMaxLength:9], @"The quick");
+    XCTAssertEqualObjects([html stringByConvertingHTMLToPlainTextWithMaxLength:0], @"");
+    XCTAssertEqualObjects([html stringByConvertingHTMLToPlainTextWithMaxLength:1000], @"The quick brown fox jumps over the lazy dog.");
+}
+
+- (void)testConvertingHTMLToPlainTextDoesNotSplitEmoji
+{
+    NSString *html = @"<p>Hi 😀👍🏽</p>";
+    XCTAssertEqualObjects([html stringByConvertingHTMLToPlainTextWithMaxLength:4], @"Hi ");
+    XCTAssertEqualObjects([html stringByConvertingHTMLToPlainTextWithMaxLength:5], @"Hi 😀");
+    XCTAssertEqualObjects([html stringByConvertingHTMLToPlainTextWithMaxLength:8], @"Hi 😀");
+    XCTAssertEqualObjects([html stringByConvertingHTMLToPlainTextWithMaxLength:9], @"Hi 😀👍🏽");
+    XCTAssertEqualObjects([@"&#128512;" stringByConvertingHTMLToPlainTextWithMaxLength:1], @"");
+}
+
+#pragma mark - Performance
+
+- (void)testStrippingHTMLPerformance
+{
+    NSString *html = [self postHTMLCorpus];
+    [self measureBlock:^{
+        [html stringByStrippingHTML];
+    }];
+}
+
+- (void)testStrippingHTMLWithRegexPerformance
+{
+    NSString *html = [self postHTMLCorpus];
+    [self measureBlock:^{
+        [html stringByReplacingOccurrencesOfString:@"<[^>]+>" withString:@"" options:NSRegularExpressionSearch range:NSMakeRange(0, html.length)];
+    }];
+}
+
+- (void)testNormalizeWhitespacePerformance
+{
+    NSString *html = [self postHTMLCorpus];
+    [self measureBlock:^{
+        [html stringByNormalizingWhitespace];
+    }];
+}
+
+- (void)testNormalizeWhitespaceWithRegexPerformance
+{
+    NSString *html = [self postHTMLCorpus];
+    [self measureBlock:^{
+        [html stringByReplacingOccurrencesOfString:@"\\s{2,}" withString:@" " options:NSRegularExpressionSearch range:NSMakeRange(0, html.length)];
+    }];
+}
+
+- (void)testConvertingHTMLToPlainTextPerformance
+{
+    NSString *html = [self postHTMLCorpus];
+    [self measureBlock:^{
+        [html stringByConvertingHTMLToPlainText];
+    }];
+}
+
+- (void)testConvertingHTMLToPlainTextExcerptPerformance
+{
+    NSString *html = [self postHTMLCorpus];
+    [self measureBlock:^{
+        for (NSInteger i = 0; i < 1000; i++) {
+            [html stringByConvertingHTMLToPlainTextWithMaxLength:300];
+        }
+    }];
+}
+
+- (void)testStripDecodeAndNormalizeWithRegexPerformance
+{
+    NSString *html = [self postHTMLCorpus];
+    [self measureBlock:^{
+        [[[html stringByDecodingXMLCharacters] stringByStrippingHTML] stringByNormalizingWhitespace];
+    }];
+}
+
+#pragma mark - Helpers
+
+/// Returns the markup of a long-form post as produced by the block editor.
+- (NSString *)postHTMLCorpus
+{
+    NSString *blocks = @"<!-- wp:paragraph -->\n<p>It&#8217;s been a while since I&#8217;ve written about <a href=\"https://example.com/slow-travel/\">slow travel</a> &mdash; the kind where you stay put for weeks &amp; let a place seep in.</p>\n<!-- /wp:paragraph -->\n\n"
+        "<!-- wp:image {\"id\":2315,\"sizeSlug\":\"large\"} -->\n<figure class=\"wp-block-image size-large\"><img src=\"https://example.files.wordpress.com/2020/01/img_0005.jpg?w=1024\" alt=\"\" class=\"wp-image-2315\"/><figcaption>Caf&eacute; on the corner</figcaption></figure>\n<!-- /wp:image -->\n\n"
+        "<!-- wp:html -->\n<style>.note { color: #333; }</style><script>window.stats = { views: 42 };</script>\n<!-- /wp:html -->\n\n"
+        "<!-- wp:list -->\n<ul>\n    <li>Prices were &pound;3&ndash;&pound;5</li>\n    <li>Trains ran <em>mostly</em> on time</li>\n</ul>\n<!-- /wp:list -->\n\n";
+
+    NSMutableString *corpus = [NSMutableString string];
+    while (corpus.length < 512 * 1024) {
+        [corpus appendString:blocks];
+    }
+    return corpus;
+}
+
 @end
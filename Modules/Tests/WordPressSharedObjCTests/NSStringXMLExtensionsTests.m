@@ -0,0 +1,229 @@
+#import <XCTest/XCTest.h>
+#import "NSString+XMLExtensions.h"
+#import "../../Sources/WordPressSharedObjC/Utility/WPXMLEntityDecoding.h"
+
+@interface NSStringXMLExtensionsTests : XCTestCase
+
+@end
+
+@implementation NSStringXMLExtensionsTests
+
+- (void)testDecodingNamedEntities
+{
+    XCTAssertEqualObjects([NSString decodeXMLCharactersIn:@"Fish &amp; Chips &lt;b&gt;"], @"Fish & Chips <b>");
+    XCTAssertEqualObjects([NSString decodeXMLCharactersIn:@"&quot;&apos;&nbsp;&copy;&thetasym;&diams;"], @"\"' ©ϑ♦");
+    XCTAssertEqualObjects([NSString decodeXMLCharactersIn:@"&Aring;&aring;&lArr;&larr;"], @"Åå⇐←");
+}
+
+- (void)testDecodingNumericEntities
+{
+    XCTAssertEqualObjects([NSString decodeXMLCharactersIn:@"&#65;&#x42;&#X43;"], @"ABC");
+    XCTAssertEqualObjects([NSString decodeXMLCharactersIn:@"&#8217;&#x2019;"], @"’’");
+}
+
+- (void)testDecodingCodePointsOutsideTheBasicMultilingualPlane
+{
+    XCTAssertEqualObjects([NSString decodeXMLCharactersIn:@"&#128512;"], @"😀");
+    XCTAssertEqualObjects([NSString decodeXMLCharactersIn:@"smile &#x1F600; please"], @"smile 😀 please");
+}
+
+- (void)testDecodingLeavesInvalidSequencesUntouched
+{
+    NSArray *invalid = @[
+        @"&",
+        @"&;",
+        @"&#;",
+        @"&#0;",
+        @"&#xD800;",
+        @"&#x110000;",
+        @"&#12a;",
+        @"&unknown;",
+        @"&nbsp",
+        @"&amp ;",
+        @"&averylongname;",
+    ];
+
+    for (NSString *string in invalid) {
+        XCTAssertEqualObjects([NSString decodeXMLCharactersIn:string], string);
+    }
+}
+
+- (void)testDecodingIsNotRecursive
+{
+    XCTAssertEqualObjects([NSString decodeXMLCharactersIn:@"&amp;lt;"], @"&lt;");
+    XCTAssertEqualObjects([NSString decodeXMLCharactersIn:@"&#38;amp;"], @"&amp;");
+}
+
+- (void)testDecodingSkipsUnterminatedSequenceBeforeValidOne
+{
+    XCTAssertEqualObjects([NSString decodeXMLCharactersIn:@"AT&T &amp; more"], @"AT&T & more");
+    XCTAssertEqualObjects([NSString decodeXMLCharactersIn:@"&foo &amp;"], @"&foo &");
+}
+
+- (void)testDecodingInvalidInput
+{
+    XCTAssertEqualObjects([NSString decodeXMLCharactersIn:nil], @"");
+    XCTAssertEqualObjects([NSString decodeXMLCharactersIn:(NSString *)@42], @"");
+    XCTAssertEqualObjects([NSString decodeXMLCharactersIn:@""], @"");
+    XCTAssertEqualObjects([NSString decodeXMLCharactersIn:@"No entities here"], @"No entities here");
+}
+
+- (void)testEncoding
+{
+    XCTAssertEqualObjects([NSString encodeXMLCharactersIn:@"Fish & Chips <b>"], @"Fish &#38; Chips &#60;b&#62;");
+    XCTAssertEqualObjects([NSString encodeXMLCharactersIn:@"<<&&>>"], @"&#60;&#60;&#38;&#38;&#62;&#62;");
+    XCTAssertEqualObjects([NSString encodeXMLCharactersIn:@"A longer string with a trailing & after a full block"], @"A longer string with a trailing &#38; after a full block");
+    XCTAssertEqualObjects([NSString encodeXMLCharactersIn:@"Nothing to escape 😀"], @"Nothing to escape 😀");
+    XCTAssertEqualObjects([NSString encodeXMLCharactersIn:@""], @"");
+    XCTAssertEqualObjects([NSString encodeXMLCharactersIn:nil], @"");
+}
+
+- (void)testAppendingEncodedCharactersToData
+{
+    NSMutableData *data = [[@"<param>" dataUsingEncoding:NSUTF8StringEncoding] mutableCopy];
+    [NSString appendXMLEncodedCharactersIn:@"Café & <croissants> 😀" toData:data];
+
+    NSString *result = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+    XCTAssertEqualObjects(result, @"<param>Café &#38; &#60;croissants&#62; 😀");
+}
+
+- (void)testAppendingEncodedCharactersToDataMatchesStringEncoding
+{
+    NSString *body = [self largePostBody];
+    NSMutableData *data = [NSMutableData data];
+    [NSString appendXMLEncodedCharactersIn:body toData:data];
+
+    NSString *result = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+    XCTAssertEqualObjects(result, [NSString encodeXMLCharactersIn:body]);
+}
+
+- (void)testAppendingEncodedCharactersWithEmbeddedNULsToData
+{
+    unichar nul = 0;
+    NSString *separator = [NSString stringWithCharacters:&nul length:1];
+    NSString *ascii = [@[@"a", @"<b>", @"&c"] componentsJoinedByString:separator];
+    NSString *unicode = [@[@"Café", @"<b>", @"😀"] componentsJoinedByString:separator];
+    for (NSString *source in @[ascii, unicode]) {
+        NSMutableData *data = [NSMutableData data];
+        [NSString appendXMLEncodedCharactersIn:source toData:data];
+
+        NSString *result = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+        XCTAssertEqualObjects(result, [NSString encodeXMLCharactersIn:source]);
+    }
+    XCTAssertEqual([[NSString encodeXMLCharactersIn:ascii] length], 20);
+}
+
+- (void)testEncodingPerformance
+{
+    NSString *body = [self largePostBody];
+
+    [self measureBlock:^{
+        [NSString encodeXMLCharactersIn:body];
+    }];
+}
+
+- (void)testDecodingPerformance
+{
+    NSString *body = [self largePostBody];
+
+    [self measureBlock:^{
+        [NSString decodeXMLCharactersIn:body];
+    }];
+}
+
+- (void)testDecodingPerformanceOnBaselineBody
+{
+    NSString *body = [self baselinePostBody];
+
+    [self measureWithMetrics:@[[XCTClockMetric new], [XCTCPUMetric new]] block:^{
+        [NSString decodeXMLCharactersIn:body];
+    }];
+}
+
+- (void)testScannerDecodingBaselinePerformance
+{
+    NSString *body = [self baselinePostBody];
+
+    [self measureWithMetrics:@[[XCTClockMetric new], [XCTCPUMetric new]] block:^{
+        [self decodeXMLCharactersWithScannerIn:body];
+    }];
+}
+
+#pragma mark - Helpers
+
+/// The decoder replaced by the forward pass: it searches backwards for each `&`, parses numeric
+/// references with `NSScanner`, walks the entity map for named ones and replaces every sequence
+/// in place in a mutable copy.
+- (NSString *)decodeXMLCharactersWithScannerIn:(NSString *)source
+{
+    NSRange range = NSMakeRange(0, [source length]);
+    NSRange subrange = [source rangeOfString:@"&" options:NSBackwardsSearch range:range];
+    if (subrange.length == 0) {
+        return source;
+    }
+
+    NSMutableString *finalString = [NSMutableString stringWithString:source];
+    do {
+        NSRange semiColonRange = NSMakeRange(subrange.location, NSMaxRange(range) - subrange.location);
+        semiColonRange = [source rangeOfString:@";" options:0 range:semiColonRange];
+        range = NSMakeRange(0, subrange.location);
+        if (semiColonRange.location == NSNotFound) {
+            continue;
+        }
+        NSRange escapeRange = NSMakeRange(subrange.location, semiColonRange.location - subrange.location + 1);
+        NSString *escapeString = [source substringWithRange:escapeRange];
+        NSUInteger length = [escapeString length];
+        if (length <= 3 || length >= 11) {
+            continue;
+        }
+        if ([escapeString characterAtIndex:1] == '#') {
+            unichar char2 = [escapeString characterAtIndex:2];
+            BOOL hex = char2 == 'x' || char2 == 'X';
+            NSUInteger digitsStart = hex ? 3 : 2;
+            NSScanner *scanner = [NSScanner scannerWithString:[escapeString substringWithRange:NSMakeRange(digitsStart, length - digitsStart - 1)]];
+            unsigned value = 0;
+            int decimalValue = 0;
+            BOOL scanned = hex ? [scanner scanHexInt:&value] : [scanner scanInt:&decimalValue];
+            if (!hex) {
+                value = decimalValue;
+            }
+            if (scanned && value > 0 && value < USHRT_MAX && [scanner scanLocation] == length - digitsStart - 1) {
+                unichar uchar = value;
+                [finalString replaceCharactersInRange:escapeRange withString:[NSString stringWithCharacters:&uchar length:1]];
+            }
+        } else {
+            for (NSUInteger i = 0; i < gAsciiHTMLEscapeMapCount; i++) {
+                if ([escapeString isEqualToString:gAsciiHTMLEscapeMap[i].escapeSequence]) {
+                    [finalString replaceCharactersInRange:escapeRange withString:[NSString stringWithCharacters:&gAsciiHTMLEscapeMap[i].uchar length:1]];
+                    break;
+                }
+            }
+        }
+    } while ((subrange = [source rangeOfString:@"&" options:NSBackwardsSearch range:range]).length != 0);
+
+    return finalString;
+}
+
+/// Returns a multi-megabyte post body with an entity density similar to the
+/// content of long-form Reader posts.
+- (NSString *)largePostBody
+{
+    NSString *paragraph = @"<p>It&#8217;s been a while since I&#8217;ve written about "
+        "&ldquo;slow travel&rdquo; &mdash; the kind where you stay put for weeks &amp; let a place "
+        "seep in. Caf&eacute;s, na&iuml;ve plans &amp; the occasional &#x1F600; moment. "
+        "Prices were &pound;3&ndash;&pound;5 &times; 2, &lt;not bad&gt;&hellip;</p>\n";
+
+    NSMutableString *body = [NSMutableString string];
+    while (body.length < 4 * 1024 * 1024) {
+        [body appendString:paragraph];
+    }
+    return body;
+}
+
+/// The start of `largePostBody`. The scanner-based decoder is too slow to run on the whole body.
+- (NSString *)baselinePostBody
+{
+    return [[self largePostBody] substringToIndex:256 * 1024];
+}
+
+@end
@@ -48,4 +48,85 @@
     XCTAssertTrue([[photonURL absoluteString] isEqualToString:path]);
 }
 
+- (void)testPhotonURLReplacesExistingPhotonParameters
+{
+    CGFloat scale = [[UIScreen mainScreen] scale];
+    NSURL *url = [NSURL URLWithString:@"https://I2.WP.com/example.com/image.jpg?w=100&ssl=1"];
+    NSURL *photonURL = [PhotonImageURLHelper photonURLWithSize:CGSizeMake(100, 0) forImageURL:url];
+
+    NSString *expected = [NSString stringWithFormat:@"https://I2.WP.com/example.com/image.jpg?quality=80&w=%i&ssl=1", (int)(100 * scale)];
+    XCTAssertEqualObjects([photonURL absoluteString], expected);
+}
+
+- (void)testPhotonURLStripsResizingParameters
+{
+    CGFloat scale = [[UIScreen mainScreen] scale];
+    NSURL *url = [NSURL URLWithString:@"http://example.com/image.png?w=1000"];
+    NSURL *photonURL = [PhotonImageURLHelper photonURLWithSize:CGSizeMake(10, 20) forImageURL:url forceResize:NO imageQuality:120];
+
+    NSString *expected = [NSString stringWithFormat:@"https://i0.wp.com/example.com/image.png?quality=100&fit=%.0f,%.0f", 10 * scale, 20 * scale];
+    XCTAssertEqualObjects([photonURL absoluteString], expected);
+}
+
+- (void)testPhotonURLIgnoresUnsupportedImageTypes
+{
+    NSURL *url = [NSURL URLWithString:@"https://example.com/image.svg"];
+    XCTAssertEqualObjects([PhotonImageURLHelper photonURLWithSize:CGSizeMake(100, 100) forImageURL:url], url);
+
+    NSURL *relativeURL = [NSURL URLWithString:@"example.com/image.svg"];
+    NSURL *photonURL = [PhotonImageURLHelper photonURLWithSize:CGSizeMake(100, 100) forImageURL:relativeURL];
+    XCTAssertEqualObjects([photonURL absoluteString], @"http://example.com/image.svg");
+}
+
+- (void)testPhotonURLsMatchSingleURLs
+{
+    NSArray<NSURL *> *urls = @[
+        [NSURL URLWithString:@"https://example.com/a.jpg"],
+        [NSURL URLWithString:@"https://i0.wp.com/example.com/b.png?w=10"],
+        [NSURL URLWithString:@"https://s.wordpress.com/mshots/v1/example.com/c.jpeg"],
+        [NSURL URLWithString:@"https://example.com/d.pdf"],
+    ];
+    NSArray<NSValue *> *sizes = @[
+        [NSValue valueWithCGSize:CGSizeMake(100, 50)],
+        [NSValue valueWithCGSize:CGSizeMake(200, 0)],
+        [NSValue valueWithCGSize:CGSizeMake(300, 0)],
+        [NSValue valueWithCGSize:CGSizeMake(400, 400)],
+    ];
+
+    NSArray<NSURL *> *photonURLs = [PhotonImageURLHelper photonURLsWithSizes:sizes forImageURLs:urls forceResize:YES imageQuality:80];
+
+    XCTAssertEqual(photonURLs.count, urls.count);
+    for (NSUInteger i = 0; i < urls.count; i++) {
+        NSURL *expected = [PhotonImageURLHelper photonURLWithSize:[sizes[i] CGSizeValue] forImageURL:urls[i]];
+        XCTAssertEqualObjects(photonURLs[i], expected);
+    }
+}
+
+- (void)testPhotonURLForLongImageURL
+{
+    // Longer than the inline buffer, so the characters are copied to the heap.
+    NSString *path = [@"" stringByPaddingToLength:600 withString:@"a" startingAtIndex:0];
+    NSURL *url = [NSURL URLWithString:[NSString stringWithFormat:@"https://example.com/%@.jpg", path]];
+    CGFloat scale = [[UIScreen mainScreen] scale];
+
+    NSURL *photonURL = [PhotonImageURLHelper photonURLWithSize:CGSizeMake(100, 100) forImageURL:url];
+
+    NSString *expected = [NSString stringWithFormat:@"https://i0.wp.com/example.com/%@.jpg?quality=80&resize=%.0f,%.0f&ssl=1", path, 100 * scale, 100 * scale];
+    XCTAssertEqualObjects(photonURL.absoluteString, expected);
+}
+
+- (void)testPhotonURLsPerformance
+{
+    NSMutableArray<NSURL *> *urls = [NSMutableArray array];
+    NSMutableArray<NSValue *> *sizes = [NSMutableArray array];
+    for (NSUInteger i = 0; i < 1000; i++) {
+        [urls addObject:[NSURL URLWithString:[NSString stringWithFormat:@"https://example.com/wp-content/uploads/%lu.jpg?w=1024", (unsigned long)i]]];
+        [sizes addObject:[NSValue valueWithCGSize:CGSizeMake(320, 180)]];
+    }
+
+    [self measureBlock:^{
+        [PhotonImageURLHelper photonURLsWithSizes:sizes forImageURLs:urls forceResize:YES imageQuality:80];
+    }];
+}
+
 @end
@@ -69,4 +69,81 @@ class RichContentFormatterTests: XCTestCase {
         let sanitizedStr3 = RichContentFormatter.formatVideoTags(str3) as NSString
         XCTAssert(!sanitizedStr3.contains("controls controls"))
     }
+
+    func testRemoveForbiddenTagsAndInlineStylesMatchesSeparatePasses() {
+        let strings = [
+            "<script>alert();</script><style>body{color:#000;}</style><p>test</p><p><!-- wp:paragraph {\"fontSize\":\"large\"}--></p><p><!-- /wp:paragraph --></p>\n<img><p><!-- wp:self-closing-tag /--></p>",
+            "<p style=\"background-color:#fff;\">test</p><div  STYLE=\"a\">test</div>",
+            "<STYLE type=\"text/css\">a{}</style>\n<img src=\"a.jpg\" style=\"width:100%\">",
+            "<p><!-- wp:spacer /--></p><style>a{}</style>\n<p>text</p>",
+            "<script>unterminated <p style=\"unterminated</p>",
+            "Plain text with no markup. Café 😀"
+        ]
+
+        for string in strings {
+            let expected = RichContentFormatter.removeInlineStyles(RichContentFormatter.removeForbiddenTags(string))
+            XCTAssertEqual(RichContentFormatter.removeForbiddenTagsAndInlineStyles(string), expected)
+        }
+    }
+
+    func testSanitizeReaderPostContent() {
+        let content = "<p style=\"color:red\">test</p><script>alert();</script>"
+        XCTAssertEqual(RichContentFormatter.sanitizeReaderPostContent(content, forPostWithID: "1"), "<p>test</p>")
+        XCTAssertEqual(RichContentFormatter.sanitizeReaderPostContent(content, forPostWithID: "1"), "<p>test</p>")
+        XCTAssertEqual(RichContentFormatter.sanitizeReaderPostContent(content, forPostWithID: nil), "<p>test</p>")
+        XCTAssertEqual(RichContentFormatter.sanitizeReaderPostContent("", forPostWithID: "1"), "")
+    }
+
+    func testSanitizeReaderPostContentAfterContentChanges() {
+        XCTAssertEqual(RichContentFormatter.sanitizeReaderPostContent("<p>Draft</p>", forPostWithID: "2"), "<p>Draft</p>")
+        XCTAssertEqual(RichContentFormatter.sanitizeReaderPostContent("<p>Edited</p>", forPostWithID: "2"), "<p>Edited</p>")
+    }
+
+    func testPrepareReaderPostContents() {
+        let contents = Dictionary(uniqueKeysWithValues: (0..<20).map { ("\($0)", "<p style=\"color:red\">Post \($0)</p>") })
+
+        let contentsPrepared = expectation(description: "Contents prepared")
+        RichContentFormatter.prepareReaderPostContents(contents) {
+            contentsPrepared.fulfill()
+        }
+        wait(for: [contentsPrepared], timeout: 5)
+
+        XCTAssertEqual(RichContentFormatter.sanitizeReaderPostContent(contents["3"]!, forPostWithID: "3"), "<p>Post 3</p>")
+    }
+
+    func testRemoveForbiddenTagsAndInlineStylesWithUnterminatedBlocks() {
+        let content = String(repeating: "<p><script>x</p><style>y style=\"a", count: 1_000)
+
+        let expected = RichContentFormatter.removeInlineStyles(RichContentFormatter.removeForbiddenTags(content))
+        XCTAssertEqual(RichContentFormatter.removeForbiddenTagsAndInlineStyles(content), expected)
+    }
+
+    func testRemoveForbiddenTagsAndInlineStylesPerformance() {
+        let content = makeLongPostContent()
+
+        measure {
+            _ = RichContentFormatter.removeForbiddenTagsAndInlineStyles(content)
+        }
+    }
+
+    func testSeparatePassesPerformance() {
+        let content = makeLongPostContent()
+
+        measure {
+            _ = RichContentFormatter.removeInlineStyles(RichContentFormatter.removeForbiddenTags(content))
+        }
+    }
+
+    private func makeLongPostContent() -> String {
+        let block = """
+        <p><!-- wp:paragraph --></p>
+        <p style="text-align:center">A paragraph with <strong>bold</strong> text and a <a href="https://example.com">link</a>.</p>
+        <p><!-- /wp:paragraph --></p>
+        <figure class="wp-block-image"><img src="https://example.com/image.jpg" style="width:100%" alt=""></figure>
+        <script type="text/javascript">window.stats = { views: 1 };</script>
+        <style>.wp-block-image { margin: 0; }</style>
+
+        """
+        return String(repeating: block, count: 2_000)
+    }
 }
@@ -0,0 +1,52 @@
+import Foundation
+import CoreData
+import WordPressShared
+
+/// A persisted index of the images and galleries found in the post's content.
+///
+/// Scanning the content of a long post isn't free, and post syncs used to scan every post again
+/// even when its content hadn't changed. Setting a different content invalidates the index
+/// (see `-[AbstractPost setContent:]`), so the content is only scanned again once it changes.
+extension AbstractPost {
+
+    /// Whether the index was built from the current content.
+    @NSManaged var contentIsIndexed: Bool
+
+    /// The image of the content suitable for display, if any.
+    @NSManaged var contentImageToDisplay: String?
+
+    /// The ids of the media referenced by gallery shortcodes in the content.
+    @NSManaged var contentGalleryMediaIDs: [NSNumber]?
+
+    /// Rebuilds the index unless it was already built from the current content.
+    @objc func updateContentIndexIfNeeded() {
+        guard !contentIsIndexed else {
+            return
+        }
+
+        let scan = DisplayableImageHelper.scanPostContent(content)
+        contentImageToDisplay = scan.imageToDisplay.isEmpty ? nil : scan.imageToDisplay
+        contentGalleryMediaIDs = scan.galleryAttachmentIds.sorted { $0.int64Value < $1.int64Value }
+        contentIsIndexed = true
+    }
+
+    /// Returns the remote URL of a media item from the content's galleries, if the blog's library has one.
+    ///
+    /// Only the matching media is fetched, rather than faulting in the blog's whole library.
+    @objc func galleryImagePathForDisplay() -> String? {
+        guard let mediaIDs = contentGalleryMediaIDs, !mediaIDs.isEmpty, let context = managedObjectContext else {
+            return nil
+        }
+
+        let request = NSFetchRequest<Media>(entityName: Media.entityName())
+        request.predicate = NSPredicate(format: "blog = %@ AND mediaID IN %@ AND remoteURL != nil", blog, mediaIDs)
+        request.sortDescriptors = [NSSortDescriptor(key: #keyPath(Media.mediaID), ascending: true)]
+        request.fetchLimit = 1
+        do {
+            return try context.fetch(request).first?.remoteURL
+        } catch {
+            DDLogError("Error fetching gallery media: \(error)")
+            return nil
+        }
+    }
+}
@@ -38,6 +38,19 @@
 
 #pragma mark - Getters/Setters
 
+- (void)setContent:(NSString *)content
+{
+    NSString *key = @"content";
+    // Syncs assign the same content over and over, so only a different one invalidates the content index.
+    NSString *currentContent = self.content;
+    if (content != currentContent && ![content isEqualToString:currentContent]) {
+        self.contentIsIndexed = NO;
+    }
+    [self willChangeValueForKey:key];
+    [self setPrimitiveValue:content forKey:key];
+    [self didChangeValueForKey:key];
+}
+
 - (void)setRemoteStatusNumber:(NSNumber *)remoteStatusNumber
 {
     NSString *key = @"remoteStatusNumber";
@@ -337,20 +350,15 @@
 
 - (void)updatePathForDisplayImageBasedOnContent
 {
+    [self updateContentIndexIfNeeded];
+
     // First lets check the post content for a suitable image
-    NSString *result = [DisplayableImageHelper searchPostContentForImageToDisplay:self.content];
-    if (result.length > 0) {
-        self.pathForDisplayImage = result;
-    }
+    NSString *result = self.contentImageToDisplay;
     // If none found let's see if some galleries are available
-    NSSet *mediaIDs = [DisplayableImageHelper searchPostContentForAttachmentIdsInGalleries:self.content];
-    for (Media *media in self.blog.media) {
-        NSNumber *mediaID = media.mediaID;
-        if (mediaID && [mediaIDs containsObject:mediaID]) {
-            result = media.remoteURL;
-        }
+    if (result.length == 0) {
+        result = [self galleryImagePathForDisplay];
     }
-    self.pathForDisplayImage = result;    
+    self.pathForDisplayImage = result;
 }
 
 @end
@@ -42,6 +42,56 @@ extension Blog {
         request.fetchLimit = 1
         return (try? context.fetch(request))?.first
     }
+
+    /// Lookup many posts in the blog at once.
+    ///
+    /// - Parameter postIDs: The IDs associated with the posts.
+    /// - Returns: The posts found, keyed by their post ID. IDs without a matching post are absent.
+    @objc(lookupPostsWithIDs:inContext:)
+    public func lookupPosts(withIDs postIDs: [NSNumber], in context: NSManagedObjectContext) -> [NSNumber: AbstractPost] {
+        let posts = lookupPosts(matching: #keyPath(AbstractPost.postID), values: postIDs, in: context)
+        return posts.reduce(into: [:]) { result, post in
+            if let postID = post.postID, result[postID] == nil {
+                result[postID] = post
+            }
+        }
+    }
+
+    /// Lookup many posts in the blog at once.
+    ///
+    /// - Parameter foreignIDs: The foreign IDs associated with the posts.
+    /// - Returns: The posts found, keyed by their foreign ID. IDs without a matching post are absent.
+    @objc(lookupPostsWithForeignIDs:inContext:)
+    public func lookupPosts(withForeignIDs foreignIDs: [UUID], in context: NSManagedObjectContext) -> [UUID: AbstractPost] {
+        let posts = lookupPosts(matching: #keyPath(AbstractPost.foreignID), values: foreignIDs.map { $0 as NSUUID }, in: context)
+        return posts.reduce(into: [:]) { result, post in
+            if let foreignID = post.foreignID, result[foreignID] == nil {
+                result[foreignID] = post
+            }
+        }
+    }
+
+    /// Fetches the posts whose `key` value is one of `values`, splitting the `IN` predicate
+    /// into batches so large syncs stay under SQLite's bound variable limit.
+    private func lookupPosts(matching key: String, values: [NSObject], in context: NSManagedObjectContext) -> [AbstractPost] {
+        let uniqueValues = Array(NSOrderedSet(array: values)) as! [NSObject]
+        guard !uniqueValues.isEmpty else {
+            return []
+        }
+
+        var posts: [AbstractPost] = []
+        for start in stride(from: 0, to: uniqueValues.count, by: Blog.postLookupBatchSize) {
+            let batch = uniqueValues[start..<min(start + Blog.postLookupBatchSize, uniqueValues.count)]
+            let request = NSFetchRequest<AbstractPost>(entityName: NSStringFromClass(AbstractPost.self))
+            request.predicate = NSPredicate(format: "blog = %@ AND original = NULL AND %K IN %@", self, key, Array(batch))
+            // The callers update every post they look up, so there's no point in returning faults.
+            request.returnsObjectsAsFaults = false
+            posts += (try? context.fetch(request)) ?? []
+        }
+        return posts
+    }
+
+    private static let postLookupBatchSize = 500
 }
 
 // MARK: - Create posts
@@ -63,6 +63,18 @@ public class Comment: NSManagedObject {
         return parentID > 0
     }
 
+    /// Returns true if the given comment is one of this comment's ancestors in the thread.
+    /// An ancestor's hierarchy key is always a strict prefix of its descendants' keys.
+    public func isDescendant(of ancestor: Comment) -> Bool {
+        guard let key = hierarchyKey,
+              let ancestorKey = ancestor.hierarchyKey,
+              !ancestorKey.isEmpty,
+              key.count > ancestorKey.count else {
+            return false
+        }
+        return key.starts(with: ancestorKey)
+    }
+
     /// Convenience method to check if the current user can actually moderate.
     /// `canModerate` is only applicable when the site is dotcom-related (hosted or atomic). For self-hosted sites, default to true.
     @objc public func allowsModeration() -> Bool {
@@ -112,9 +124,27 @@ public class Comment: NSManagedObject {
 
 private extension Comment {
 
+    /// The length of the content converted for a preview. Previews show a few lines at most.
+    static let contentPreviewPrefixLength = 2_000
+
     func decodedContent() -> String {
+        return decodedContent(availableContent())
+    }
+
+    private func decodedContent(_ content: String) -> String {
         // rawContent/content contains markup for Gutenberg comments. Remove it so it's not displayed.
-        return availableContent().stringByDecodingXMLCharacters().trim().strippingHTML().normalizingWhitespace() ?? String()
+        return content.stringByDecodingXMLCharacters().trim().strippingHTML().normalizingWhitespace() ?? String()
+    }
+
+    /// Returns the start of `content`, without a tag or character reference cut in half at the end.
+    private static func contentPreviewPrefix(of content: String) -> String {
+        var prefix = content.prefix(contentPreviewPrefixLength)
+        for (opening, closing) in [("<", ">"), ("&", ";")] as [(Character, Character)] {
+            if let start = prefix.lastIndex(of: opening), !prefix[start...].contains(closing) {
+                prefix = prefix[..<start]
+            }
+        }
+        return String(prefix)
     }
 
     func authorName() -> String {
@@ -158,7 +188,13 @@ extension Comment: PostContentProvider {
 
     // Used in Comments list (non-threaded)
     public func contentPreviewForDisplay() -> String {
-        return decodedContent()
+        // Snippets are truncated to a few lines, so long comments only have their start converted,
+        // the same way as `contentForDisplay()`.
+        let content = availableContent()
+        guard content.utf16.count > Comment.contentPreviewPrefixLength else {
+            return decodedContent(content)
+        }
+        return decodedContent(Comment.contentPreviewPrefix(of: content))
     }
 
     public func avatarURLForDisplay() -> URL? {
@@ -25,7 +25,9 @@ extension Comment {
     // Hierarchical properties
     @NSManaged public var parentID: Int32
     @NSManaged public var depth: Int16
-    @NSManaged public var hierarchy: String
+    @NSManaged public var hierarchyKey: Data?
+    @NSManaged public var threadRoot: Int32
+    @NSManaged public var position: Int32
     @NSManaged public var replyID: Int32
 
     /// Determines if the comment should be displayed in the Reader comment thread.
@@ -35,11 +37,11 @@ extension Comment {
     @NSManaged public var visibleOnReader: Bool
 
     /*
-     // Hierarchy is a string representation of a comments ancestors. Each ancestor's
-     // is denoted by a ten character zero padded representation of its ID
-     // (e.g. "0000000001"). Ancestors are separated by a period.
-     // This allows hierarchical comments to be retrieved from core data by sorting
-     // on hierarchy, and allows for new comments to be inserted without needing to
-     // reorder the list.
+     // The hierarchy key is a binary representation of a comment's ancestors followed
+     // by the comment itself. Each ID is packed as a big-endian 32-bit integer, so
+     // comparing two keys byte by byte orders comments the same way as walking the thread.
+     // `threadRoot` is the ID of the top-level comment of the thread and `position` is the
+     // comment's index within that thread in hierarchy key order. Together they allow
+     // threaded comments to be retrieved from core data with an index-backed sort.
      */
 }
@@ -0,0 +1,72 @@
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class MenuItem;
+
+/**
+ A precomputed index of the tree formed by the ordered items of a Menu.
+ Answers ancestry and sibling queries in constant time, which the linear
+ MenuItem helpers can't afford while the user is dragging items around.
+
+ Items are expected to be ordered top-down, as a parent followed by its descendants, as returned from the Menus API.
+ Each item is indexed by its position in that order and the position right after its last descendant,
+ so the descendants of an item are the items positioned between the two.
+ */
+@interface MenuItemTreeIndex : NSObject
+
+/**
+ The ordered items currently indexed.
+ */
+@property (nonatomic, copy, readonly) NSArray<MenuItem *> *orderedItems;
+
+- (instancetype)initWithOrderedItems:(nullable NSOrderedSet<MenuItem *> *)orderedItems;
+
+/**
+ Update the index after items were moved, inserted, removed or assigned a new parent.
+ Items positioned before firstChangedIndex must be unchanged, both in position and parent.
+ Only the items from firstChangedIndex on, and the ancestors of the item at that position, are re-indexed.
+ @param orderedItems the ordered items of the menu, after the change.
+ @param firstChangedIndex the first position of orderedItems affected by the change.
+ */
+- (void)updateWithOrderedItems:(nullable NSOrderedSet<MenuItem *> *)orderedItems fromIndex:(NSUInteger)firstChangedIndex NS_SWIFT_NAME(update(withOrderedItems:from:));
+
+/**
+ The position of the item, or NSNotFound if the item isn't indexed.
+ */
+- (NSUInteger)indexOfItem:(MenuItem *)item;
+
+/**
+ The number of items in the subtree of the item, including the item itself, or 0 if the item isn't indexed.
+ */
+- (NSUInteger)subtreeSizeOfItem:(MenuItem *)item;
+
+/**
+ @returns YES if item is a descendant of ancestor, NO if not.
+ */
+- (BOOL)isItem:(MenuItem *)item descendantOfItem:(MenuItem *)ancestor;
+
+/**
+ The last occurring descendant of the item, at any depth, or nil if the item has no descendants.
+ */
+- (nullable MenuItem *)lastDescendantOfItem:(MenuItem *)item;
+
+/**
+ The last occurring direct child of the item, or nil if the item has no children.
+ Matches the result of -[MenuItem lastDescendantInOrderedItems:].
+ */
+- (nullable MenuItem *)lastChildOfItem:(MenuItem *)item;
+
+/**
+ The closest item sharing the parent of the item and preceding it, or nil if there is not one.
+ */
+- (nullable MenuItem *)precedingSiblingOfItem:(MenuItem *)item;
+
+/**
+ The first item following the item that isn't one of its descendants, or nil if there is not one.
+ */
+- (nullable MenuItem *)nextItemAfterDescendantsOfItem:(MenuItem *)item;
+
+@end
+
+NS_ASSUME_NONNULL_END
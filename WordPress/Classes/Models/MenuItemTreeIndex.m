@@ -0,0 +1,153 @@
+#import "MenuItemTreeIndex.h"
+#import "MenuItem.h"
+
+@interface MenuItemTreeIndexEntry : NSObject
+
+@property (nonatomic, strong) MenuItem *item;
+/// The parent the item was indexed with, nil for top-level items.
+@property (nonatomic, strong, nullable) MenuItem *parent;
+@property (nonatomic, assign) NSUInteger position;
+/// The position following the last descendant of the item.
+@property (nonatomic, assign) NSUInteger end;
+@property (nonatomic, strong, nullable) MenuItem *previousSibling;
+@property (nonatomic, strong, nullable) MenuItem *lastChild;
+
+@end
+
+@implementation MenuItemTreeIndexEntry
+@end
+
+@interface MenuItemTreeIndex ()
+
+@property (nonatomic, copy, readwrite) NSArray<MenuItem *> *orderedItems;
+@property (nonatomic, strong, readonly) NSMapTable<MenuItem *, MenuItemTreeIndexEntry *> *entries;
+
+@end
+
+@implementation MenuItemTreeIndex
+
+- (instancetype)initWithOrderedItems:(nullable NSOrderedSet<MenuItem *> *)orderedItems
+{
+    self = [super init];
+    if (self) {
+        _orderedItems = @[];
+        _entries = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality
+                                         valueOptions:NSPointerFunctionsStrongMemory];
+        [self updateWithOrderedItems:orderedItems fromIndex:0];
+    }
+    return self;
+}
+
+- (void)updateWithOrderedItems:(nullable NSOrderedSet<MenuItem *> *)orderedItems fromIndex:(NSUInteger)firstChangedIndex
+{
+    NSArray<MenuItem *> *oldItems = self.orderedItems;
+    NSArray<MenuItem *> *newItems = orderedItems.array ?: @[];
+    const NSUInteger start = MIN(firstChangedIndex, MIN(oldItems.count, newItems.count));
+
+    for (NSUInteger i = start; i < oldItems.count; i++) {
+        [self.entries removeObjectForKey:oldItems[i]];
+    }
+    self.orderedItems = newItems;
+
+    /*
+     Walking the items top-down, the open subtrees right before a position are the item preceding it and its ancestors.
+     Items before the start are unchanged, so their entries are reused to reopen these subtrees and resume the walk from there.
+     Any other item before the start had its subtree closed already, and keeps its entry as is.
+     */
+    NSMutableArray<MenuItemTreeIndexEntry *> *openEntries = [NSMutableArray array];
+    if (start > 0) {
+        MenuItemTreeIndexEntry *entry = [self.entries objectForKey:newItems[start - 1]];
+        MenuItem *lastChild = nil;
+        while (entry) {
+            entry.lastChild = lastChild;
+            [openEntries insertObject:entry atIndex:0];
+            lastChild = entry.item;
+            entry = entry.parent ? [self.entries objectForKey:entry.parent] : nil;
+        }
+    }
+    MenuItem *lastTopLevelItem = openEntries.firstObject.item;
+
+    for (NSUInteger i = start; i < newItems.count; i++) {
+        MenuItem *item = newItems[i];
+        MenuItem *parent = item.parent;
+        while (openEntries.count && openEntries.lastObject.item != parent) {
+            openEntries.lastObject.end = i;
+            [openEntries removeLastObject];
+        }
+
+        // An item whose parent doesn't precede it is out of place, and indexed as a top-level item.
+        MenuItemTreeIndexEntry *parentEntry = openEntries.lastObject;
+        MenuItemTreeIndexEntry *entry = [[MenuItemTreeIndexEntry alloc] init];
+        entry.item = item;
+        entry.parent = parentEntry.item;
+        entry.position = i;
+        if (parentEntry) {
+            entry.previousSibling = parentEntry.lastChild;
+            parentEntry.lastChild = item;
+        } else {
+            entry.previousSibling = lastTopLevelItem;
+            lastTopLevelItem = item;
+        }
+
+        [self.entries setObject:entry forKey:item];
+        [openEntries addObject:entry];
+    }
+
+    for (MenuItemTreeIndexEntry *entry in openEntries) {
+        entry.end = newItems.count;
+    }
+}
+
+#pragma mark - Queries
+
+- (NSUInteger)indexOfItem:(MenuItem *)item
+{
+    MenuItemTreeIndexEntry *entry = [self.entries objectForKey:item];
+    return entry ? entry.position : NSNotFound;
+}
+
+- (NSUInteger)subtreeSizeOfItem:(MenuItem *)item
+{
+    MenuItemTreeIndexEntry *entry = [self.entries objectForKey:item];
+    return entry ? entry.end - entry.position : 0;
+}
+
+- (BOOL)isItem:(MenuItem *)item descendantOfItem:(MenuItem *)ancestor
+{
+    MenuItemTreeIndexEntry *entry = [self.entries objectForKey:item];
+    MenuItemTreeIndexEntry *ancestorEntry = [self.entries objectForKey:ancestor];
+    if (!entry || !ancestorEntry) {
+        return NO;
+    }
+    return ancestorEntry.position < entry.position && entry.position < ancestorEntry.end;
+}
+
+- (nullable MenuItem *)lastDescendantOfItem:(MenuItem *)item
+{
+    MenuItemTreeIndexEntry *entry = [self.entries objectForKey:item];
+    if (!entry || entry.end - entry.position < 2) {
+        return nil;
+    }
+    return self.orderedItems[entry.end - 1];
+}
+
+- (nullable MenuItem *)lastChildOfItem:(MenuItem *)item
+{
+    return [self.entries objectForKey:item].lastChild;
+}
+
+- (nullable MenuItem *)precedingSiblingOfItem:(MenuItem *)item
+{
+    return [self.entries objectForKey:item].previousSibling;
+}
+
+- (nullable MenuItem *)nextItemAfterDescendantsOfItem:(MenuItem *)item
+{
+    MenuItemTreeIndexEntry *entry = [self.entries objectForKey:item];
+    if (!entry || entry.end >= self.orderedItems.count) {
+        return nil;
+    }
+    return self.orderedItems[entry.end];
+}
+
+@end
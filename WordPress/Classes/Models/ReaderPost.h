@@ -82,6 +82,18 @@ extern NSString * const ReaderPostStoredCommentTextKey;
 
 + (instancetype)createOrReplaceFromRemotePost:(RemoteReaderPost *)remotePost forTopic:(ReaderAbstractTopic *)topic context:(NSManagedObjectContext *) managedObjectContext;
 
+/// Creates or updates a page of posts, looking up the existing posts with a single fetch.
+/// Returns the posts in the same order as `remotePosts`.
++ (NSArray<ReaderPost *> *)createOrReplaceFromRemotePosts:(NSArray<RemoteReaderPost *> *)remotePosts forTopic:(ReaderAbstractTopic *)topic context:(NSManagedObjectContext *)managedObjectContext;
+
+/// Same as `createOrReplaceFromRemotePosts:forTopic:context:`, but uses `existingPosts` from
+/// `postsForRemotePosts:forTopic:context:` instead of fetching them. Created posts are added to the map.
++ (NSArray<ReaderPost *> *)createOrReplaceFromRemotePosts:(NSArray<RemoteReaderPost *> *)remotePosts forTopic:(ReaderAbstractTopic *)topic existingPosts:(NSMutableDictionary<NSString *, ReaderPost *> *)existingPosts context:(NSManagedObjectContext *)managedObjectContext;
+
+/// Fetches the stored posts matching the given remote posts with a single `IN` query, keyed by `globalID`.
+/// Includes posts assigned to `topic` and posts without a topic.
++ (NSMutableDictionary<NSString *, ReaderPost *> *)postsForRemotePosts:(NSArray<RemoteReaderPost *> *)remotePosts forTopic:(ReaderAbstractTopic *)topic context:(NSManagedObjectContext *)managedObjectContext;
+
 - (BOOL)isCrossPost;
 - (BOOL)isP2Type;
 - (NSString *)authorString;
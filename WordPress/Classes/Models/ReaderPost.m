@@ -95,6 +95,88 @@ static NSString * const SourceAttributionStandardTaxonomy = @"standard-pick";
                                              inManagedObjectContext:managedObjectContext];
     }
 
+    [self updatePost:post fromRemotePost:remotePost forTopic:topic existing:existing context:managedObjectContext];
+    return post;
+}
+
++ (NSArray<ReaderPost *> *)createOrReplaceFromRemotePosts:(NSArray<RemoteReaderPost *> *)remotePosts
+                                                 forTopic:(ReaderAbstractTopic *)topic
+                                                  context:(NSManagedObjectContext *)managedObjectContext
+{
+    NSMutableDictionary<NSString *, ReaderPost *> *existingPosts = [self postsForRemotePosts:remotePosts
+                                                                                    forTopic:topic
+                                                                                     context:managedObjectContext];
+    return [self createOrReplaceFromRemotePosts:remotePosts forTopic:topic existingPosts:existingPosts context:managedObjectContext];
+}
+
++ (NSArray<ReaderPost *> *)createOrReplaceFromRemotePosts:(NSArray<RemoteReaderPost *> *)remotePosts
+                                                 forTopic:(ReaderAbstractTopic *)topic
+                                            existingPosts:(NSMutableDictionary<NSString *, ReaderPost *> *)existingPosts
+                                                  context:(NSManagedObjectContext *)managedObjectContext
+{
+    NSMutableArray<ReaderPost *> *posts = [NSMutableArray arrayWithCapacity:remotePosts.count];
+    for (RemoteReaderPost *remotePost in remotePosts) {
+        ReaderPost *post = remotePost.globalID ? existingPosts[remotePost.globalID] : nil;
+        BOOL existing = post != nil;
+        if (!existing) {
+            post = [NSEntityDescription insertNewObjectForEntityForName:@"ReaderPost"
+                                                 inManagedObjectContext:managedObjectContext];
+        }
+
+        [self updatePost:post fromRemotePost:remotePost forTopic:topic existing:existing context:managedObjectContext];
+
+        // A page can list the same post more than once. Later copies update the post created for the first one.
+        if (remotePost.globalID) {
+            existingPosts[remotePost.globalID] = post;
+        }
+        [posts addObject:post];
+    }
+    return posts;
+}
+
++ (NSMutableDictionary<NSString *, ReaderPost *> *)postsForRemotePosts:(NSArray<RemoteReaderPost *> *)remotePosts
+                                                              forTopic:(ReaderAbstractTopic *)topic
+                                                               context:(NSManagedObjectContext *)managedObjectContext
+{
+    NSMutableSet<NSString *> *globalIDs = [NSMutableSet setWithCapacity:remotePosts.count];
+    for (RemoteReaderPost *remotePost in remotePosts) {
+        if (remotePost.globalID) {
+            [globalIDs addObject:remotePost.globalID];
+        }
+    }
+
+    NSMutableDictionary<NSString *, ReaderPost *> *postsByGlobalID = [NSMutableDictionary dictionaryWithCapacity:globalIDs.count];
+    if (globalIDs.count == 0) {
+        return postsByGlobalID;
+    }
+
+    NSError *error;
+    NSFetchRequest *fetchRequest = [[NSFetchRequest alloc] initWithEntityName:@"ReaderPost"];
+    fetchRequest.predicate = [NSPredicate predicateWithFormat:@"globalID IN %@ AND (topic = %@ OR topic = NULL)", globalIDs, topic];
+    fetchRequest.returnsObjectsAsFaults = NO;
+    fetchRequest.relationshipKeyPathsForPrefetching = @[@"crossPostMeta", @"sourceAttribution"];
+    NSArray<ReaderPost *> *posts = [managedObjectContext executeFetchRequest:fetchRequest error:&error];
+    if (error) {
+        DDLogError(@"Error fetching existing reader posts. - %@", error);
+        return postsByGlobalID;
+    }
+
+    // Prefer the copy of a post that already belongs to the topic over one without a topic.
+    for (ReaderPost *post in posts) {
+        ReaderPost *current = postsByGlobalID[post.globalID];
+        if (current == nil || (current.topic == nil && post.topic != nil)) {
+            postsByGlobalID[post.globalID] = post;
+        }
+    }
+    return postsByGlobalID;
+}
+
++ (void)updatePost:(ReaderPost *)post
+    fromRemotePost:(RemoteReaderPost *)remotePost
+          forTopic:(ReaderAbstractTopic *)topic
+          existing:(BOOL)existing
+           context:(NSManagedObjectContext *)managedObjectContext
+{
     post.authorID = remotePost.authorID;
     post.author = remotePost.author;
     post.authorAvatarURL = remotePost.authorAvatarURL;
@@ -187,15 +269,13 @@ static NSString * const SourceAttributionStandardTaxonomy = @"standard-pick";
         post.sourceAttribution = nil;
     }
 
-    post.content = [RichContentFormatter removeInlineStyles:[RichContentFormatter removeForbiddenTags:remotePost.content]];
+    post.content = [RichContentFormatter sanitizeReaderPostContent:remotePost.content forPostWithID:remotePost.globalID];
 
     // assign the topic last.
     post.topic = topic;
 
     // auto-suggested image, but NOT an explcitly specified featured image
     post.pathForDisplayImage = remotePost.autoSuggestedFeaturedImage;
-
-    return post;
 }
 
 + (SourcePostAttribution *)createOrReplaceFromRemoteDiscoverAttribution:(RemoteSourcePostAttribution *)remoteAttribution
@@ -1,4 +1,5 @@
 import Foundation
+import AsyncImageKit
 import WordPressShared
 import ShareExtensionCore
 import WebKit
@@ -66,6 +67,12 @@ extension AccountService {
         }
 
         URLCache.shared.removeAllCachedResponses()
+        BlogMetadataFreshness.shared.invalidateAll()
+
+        // Thumbnails of private sites shouldn't outlive the account.
+        Task {
+            await ImageDownloader.shared.clearDiskCache()
+        }
 
         // Remove defaults
         UserPersistentStoreFactory.instance().removeObject(forKey: AccountService.defaultDotcomAccountUUIDDefaultsKey)
@@ -0,0 +1,154 @@
+import Foundation
+import CoreData
+import CryptoKit
+import WordPressKit
+
+/// Remembers a fingerprint of the last payload merged into Core Data for each blog metadata endpoint,
+/// so that syncs can skip the merge, and the save notifications it triggers, when nothing changed.
+///
+/// Fingerprints are kept in memory only: after a relaunch, the first sync of each endpoint always merges.
+/// They are also forgotten whenever the merged metadata of a blog is changed locally, so that a sync
+/// never leaves a local edit in place just because the remote payload is the same as last time.
+@objc final class BlogMetadataFreshness: NSObject {
+
+    @objc static let shared = BlogMetadataFreshness()
+
+    /// The name of the contexts that merge fetched metadata. Their saves aren't local changes.
+    @objc static let mergeContextName = "org.wordpress.BlogMetadataFreshness.merge"
+
+    /// The `Blog` attributes written by the metadata merges.
+    private static let mergedBlogKeys: Set<String> = ["options", "postFormats"]
+
+    private struct Key: Hashable {
+        let blogID: NSManagedObjectID
+        let endpoint: String
+    }
+
+    private let lock = NSLock()
+    private var fingerprints: [Key: Data] = [:]
+
+    override init() {
+        super.init()
+        NotificationCenter.default.addObserver(self, selector: #selector(contextWillSave(_:)), name: .NSManagedObjectContextWillSave, object: nil)
+    }
+
+    // MARK: - Fingerprints
+
+    /// Returns a fingerprint of a JSON-compatible payload, such as the post formats or options dictionaries,
+    /// or `nil` if the payload can't be serialized.
+    @objc(fingerprintForPayload:)
+    func fingerprint(for payload: Any) -> Data? {
+        guard JSONSerialization.isValidJSONObject(payload),
+              let data = try? JSONSerialization.data(withJSONObject: payload, options: [.sortedKeys]) else {
+            return nil
+        }
+        return Data(SHA256.hash(data: data))
+    }
+
+    /// Returns a fingerprint of the user fields merged into `BlogAuthor`.
+    @objc(fingerprintForUsers:)
+    func fingerprint(for users: [RemoteUser]) -> Data? {
+        fingerprint(for: users.map { user -> [Any] in
+            [
+                user.userID ?? NSNull(),
+                user.username ?? NSNull(),
+                user.email ?? NSNull(),
+                user.displayName ?? NSNull(),
+                user.primaryBlogID ?? NSNull(),
+                user.avatarURL ?? NSNull(),
+                user.linkedUserID ?? NSNull()
+            ]
+        })
+    }
+
+    /// Returns a fingerprint of the category fields merged into `PostCategory`.
+    @objc(fingerprintForCategories:)
+    func fingerprint(for categories: [RemotePostCategory]) -> Data? {
+        fingerprint(for: categories.map { category -> [Any] in
+            [
+                category.categoryID ?? NSNull(),
+                category.name ?? NSNull(),
+                category.parentID ?? NSNull()
+            ]
+        })
+    }
+
+    // MARK: - Freshness
+
+    /// Returns `true` if `fingerprint` matches the last payload merged for the blog and endpoint.
+    /// A `nil` fingerprint never matches.
+    @objc(isFingerprint:mergedForEndpoint:blogID:)
+    func isMerged(_ fingerprint: Data?, endpoint: String, blogID: NSManagedObjectID) -> Bool {
+        guard let fingerprint else {
+            return false
+        }
+        lock.lock()
+        defer { lock.unlock() }
+        return fingerprints[Key(blogID: blogID, endpoint: endpoint)] == fingerprint
+    }
+
+    /// Records the fingerprint of a payload once it has been merged for the blog and endpoint.
+    @objc(recordFingerprint:forEndpoint:blogID:)
+    func record(_ fingerprint: Data?, endpoint: String, blogID: NSManagedObjectID) {
+        lock.lock()
+        defer { lock.unlock() }
+        fingerprints[Key(blogID: blogID, endpoint: endpoint)] = fingerprint
+    }
+
+    /// Forgets every fingerprint recorded for the blog, so that the next sync merges all of its metadata.
+    @objc(invalidateBlogID:)
+    func invalidate(blogID: NSManagedObjectID) {
+        lock.lock()
+        defer { lock.unlock() }
+        fingerprints = fingerprints.filter { $0.key.blogID != blogID }
+    }
+
+    /// Forgets every fingerprint, e.g. when the user logs out.
+    @objc func invalidateAll() {
+        lock.lock()
+        defer { lock.unlock() }
+        fingerprints.removeAll()
+    }
+
+    // MARK: - Local Changes
+
+    /// Called on the queue of the context being saved, while its changes are still pending.
+    ///
+    /// This observes the saves of every context, so saves that don't touch blog metadata return
+    /// after a type check per changed object, without collecting anything.
+    @objc private func contextWillSave(_ notification: Notification) {
+        guard let context = notification.object as? NSManagedObjectContext,
+              context.name != Self.mergeContextName,
+              context.hasChanges else {
+            return
+        }
+        for blogID in Self.blogsWithMetadataChanges(in: context) {
+            invalidate(blogID: blogID)
+        }
+    }
+
+    private static func blogsWithMetadataChanges(in context: NSManagedObjectContext) -> Set<NSManagedObjectID> {
+        var blogIDs = Set<NSManagedObjectID>()
+        for objects in [context.insertedObjects, context.updatedObjects, context.deletedObjects] {
+            for object in objects where isMetadata(object) {
+                if let blogID = blogIDForMetadataChange(of: object) {
+                    blogIDs.insert(blogID)
+                }
+            }
+        }
+        return blogIDs
+    }
+
+    private static func isMetadata(_ object: NSManagedObject) -> Bool {
+        object is Blog || object is PostCategory || object is BlogAuthor || object is BlogSettings
+    }
+
+    private static func blogIDForMetadataChange(of object: NSManagedObject) -> NSManagedObjectID? {
+        if let blog = object as? Blog {
+            return blog.isDeleted || !mergedBlogKeys.isDisjoint(with: blog.changedValues().keys) ? blog.objectID : nil
+        }
+        // Deleted objects may have lost their blog already, so fall back to the saved one.
+        let blog = object.value(forKey: "blog") ?? object.committedValues(forKeys: ["blog"])["blog"]
+        return (blog as? NSManagedObject)?.objectID
+    }
+}
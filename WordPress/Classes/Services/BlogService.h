@@ -53,6 +53,18 @@ extern NSString *const WPBlogSettingsUpdatedNotification;
 - (void)syncBlogAndAllMetadata:(Blog *)blog
              completionHandler:(void (^)(void))completionHandler;
 
+/**
+ *  Sync the blog and all available metadata or configuration, like `syncBlogAndAllMetadata:completionHandler:`.
+ *
+ *  @param blog              the blog from where to read the information from
+ *  @param userInitiated     whether the user is waiting for the sync, such as after a pull to refresh,
+ *                           in which case it goes ahead of the background syncs of other blogs.
+ *  @param completionHandler a block that is invoked when the sync is done.
+ */
+- (void)syncBlogAndAllMetadata:(Blog *)blog
+                 userInitiated:(BOOL)userInitiated
+             completionHandler:(void (^)(void))completionHandler;
+
 /**
  *  Sync the available postTypes configured for the blog.
  *
@@ -25,6 +25,28 @@ NSString *const HttpsPrefix = @"https://";
 NSString *const WPBlogUpdatedNotification = @"WPBlogUpdatedNotification";
 NSString *const WPBlogSettingsUpdatedNotification = @"WPBlogSettingsUpdatedNotification";
 
+static NSString *const BlogMetadataEndpointOptions = @"options";
+static NSString *const BlogMetadataEndpointPostFormats = @"post-formats";
+static NSString *const BlogMetadataEndpointAuthors = @"authors";
+
+static NSString *const BlogSyncTaskSiteDetails = @"site-details";
+static NSString *const BlogSyncTaskSettings = @"settings";
+static NSString *const BlogSyncTaskPostFormats = @"post-formats";
+static NSString *const BlogSyncTaskCategories = @"categories";
+static NSString *const BlogSyncTaskPublicizeConnections = @"publicize-connections";
+static NSString *const BlogSyncTaskPublicizeServices = @"publicize-services";
+static NSString *const BlogSyncTaskSharingLimit = @"sharing-limit";
+static NSString *const BlogSyncTaskAuthors = @"authors";
+static NSString *const BlogSyncTaskPlans = @"plans";
+static NSString *const BlogSyncTaskPlanPrices = @"plan-prices";
+static NSString *const BlogSyncTaskEditorSettings = @"editor-settings";
+static NSString *const BlogSyncTaskDomains = @"domains";
+
+/// Metadata that rarely changes, such as the post formats or the list of plans.
+static NSTimeInterval const BlogSyncFreshnessLong = 60 * 60;
+/// Metadata that users may change from other devices, such as categories or authors.
+static NSTimeInterval const BlogSyncFreshnessShort = 5 * 60;
+
 @implementation BlogService
 
 - (instancetype)initWithCoreDataStack:(id<CoreDataStack>)coreDataStack
@@ -81,160 +103,261 @@ NSString *const WPBlogSettingsUpdatedNotification = @"WPBlogSettingsUpdatedNotif
 
 - (void)syncBlogAndAllMetadata:(Blog *)blog completionHandler:(void (^)(void))completionHandler
 {
-    // Create a dispatch group. We'll use this to monitor completion of the various
-    // remote calls and to execute the completionHandler.
-    dispatch_group_t syncGroup = dispatch_group_create();
+    [self syncBlogAndAllMetadata:blog userInitiated:NO completionHandler:completionHandler];
+}
 
+- (void)syncBlogAndAllMetadata:(Blog *)blog userInitiated:(BOOL)userInitiated completionHandler:(void (^)(void))completionHandler
+{
+    // The tasks go through a scheduler shared by all blogs, which caps the number of remote calls in flight,
+    // runs them by priority once their dependencies are done, and skips the ones synced recently enough.
+    // The tasks may run long after this call, so they look the blog up again rather than holding on to it.
     NSManagedObjectID *blogObjectID = blog.objectID;
+    NSString *blogURL = blog.url;
     id<BlogServiceRemote> remote = [self remoteForBlog:blog];
+    NSMutableArray<BlogSyncTask *> *tasks = [NSMutableArray array];
 
     if ([remote isKindOfClass:[BlogServiceRemoteXMLRPC class]]) {
-        dispatch_group_enter(syncGroup);
         BlogServiceRemoteXMLRPC *xmlrpcRemote = remote;
-        [xmlrpcRemote syncBlogOptionsWithSuccess:[self optionsHandlerWithBlogObjectID:blogObjectID
-                                                                    completionHandler:^{
-                                                                        dispatch_group_leave(syncGroup);
-                                                                    }]
-                                         failure:^(NSError *error) {
-                                             DDLogError(@"Failed syncing options for blog %@: %@", blog.url, error);
-                                             dispatch_group_leave(syncGroup);
-                                         }];
+        [tasks addObject:[[BlogSyncTask alloc] initWithIdentifier:BlogSyncTaskSettings
+                                                         priority:BlogSyncTaskPriorityHigh
+                                                freshnessInterval:0
+                                                     dependencies:@[]
+                                                             work:^(void (^done)(BOOL)) {
+            [xmlrpcRemote syncBlogOptionsWithSuccess:[self optionsHandlerWithBlogObjectID:blogObjectID
+                                                                        completionHandler:^{
+                                                                            done(YES);
+                                                                        }]
+                                             failure:^(NSError *error) {
+                                                 DDLogError(@"Failed syncing options for blog %@: %@", blogURL, error);
+                                                 done(NO);
+                                             }];
+        }]];
     }
 
     if ([remote isKindOfClass:[BlogServiceRemoteREST class]]) {
-        dispatch_group_enter(syncGroup);
         BlogServiceRemoteREST *restRemote = remote;
-        [restRemote syncBlogWithSuccess:[self blogDetailsHandlerWithBlogObjectID:blogObjectID
-                                                               completionHandler:^{
-                                                                   dispatch_group_leave(syncGroup);
-                                                               }]
-                                failure:^(NSError *error) {
-                                    DDLogError(@"Failed syncing site details for blog %@: %@", blog.url, error);
-                                    dispatch_group_leave(syncGroup);
-                                }];
-
-        dispatch_group_enter(syncGroup);
-        [restRemote syncBlogSettingsWithSuccess:^(RemoteBlogSettings *settings) {
-            [self.coreDataStack performAndSaveUsingBlock:^(NSManagedObjectContext *context) {
-                Blog *blogInContext = (Blog *)[context existingObjectWithID:blogObjectID error:nil];
-                if (blogInContext) {
-                    [self updateSettings:blogInContext.settings withRemoteSettings:settings];
-                }
-            } completion:^{
-                dispatch_group_leave(syncGroup);
-            } onQueue:dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0)];
-        } failure:^(NSError *error) {
-            DDLogError(@"Failed syncing settings for blog %@: %@", blog.url, error);
-            dispatch_group_leave(syncGroup);
-        }];
+        [tasks addObject:[[BlogSyncTask alloc] initWithIdentifier:BlogSyncTaskSiteDetails
+                                                         priority:BlogSyncTaskPriorityHigh
+                                                freshnessInterval:0
+                                                     dependencies:@[]
+                                                             work:^(void (^done)(BOOL)) {
+            [restRemote syncBlogWithSuccess:[self blogDetailsHandlerWithBlogObjectID:blogObjectID
+                                                                   completionHandler:^{
+                                                                       done(YES);
+                                                                   }]
+                                    failure:^(NSError *error) {
+                                        DDLogError(@"Failed syncing site details for blog %@: %@", blogURL, error);
+                                        done(NO);
+                                    }];
+        }]];
+
+        [tasks addObject:[[BlogSyncTask alloc] initWithIdentifier:BlogSyncTaskSettings
+                                                         priority:BlogSyncTaskPriorityHigh
+                                                freshnessInterval:0
+                                                     dependencies:@[]
+                                                             work:^(void (^done)(BOOL)) {
+            [restRemote syncBlogSettingsWithSuccess:^(RemoteBlogSettings *settings) {
+                [self.coreDataStack performAndSaveUsingBlock:^(NSManagedObjectContext *context) {
+                    Blog *blogInContext = (Blog *)[context existingObjectWithID:blogObjectID error:nil];
+                    if (blogInContext) {
+                        [self updateSettings:blogInContext.settings withRemoteSettings:settings];
+                    }
+                } completion:^{
+                    done(YES);
+                } onQueue:dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0)];
+            } failure:^(NSError *error) {
+                DDLogError(@"Failed syncing settings for blog %@: %@", blogURL, error);
+                done(NO);
+            }];
+        }]];
     }
 
-    dispatch_group_enter(syncGroup);
-    [remote syncPostFormatsWithSuccess:[self postFormatsHandlerWithBlogObjectID:blogObjectID
-                                                              completionHandler:^{
-                                                                  dispatch_group_leave(syncGroup);
-                                                              }]
-                               failure:^(NSError *error) {
-                                   DDLogError(@"Failed syncing post formats for blog %@: %@", blog.url, error);
-                                   dispatch_group_leave(syncGroup);
-                               }];
-
-    PostCategoryService *categoryService = [[PostCategoryService alloc] initWithCoreDataStack:self.coreDataStack];
-    dispatch_group_enter(syncGroup);
-    [categoryService syncCategoriesForBlog:blog
-                                   success:^{
-                                       dispatch_group_leave(syncGroup);
-                                   }
+    [tasks addObject:[[BlogSyncTask alloc] initWithIdentifier:BlogSyncTaskPostFormats
+                                                     priority:BlogSyncTaskPriorityLow
+                                            freshnessInterval:BlogSyncFreshnessLong
+                                                 dependencies:@[]
+                                                         work:^(void (^done)(BOOL)) {
+        [remote syncPostFormatsWithSuccess:[self postFormatsHandlerWithBlogObjectID:blogObjectID
+                                                                  completionHandler:^{
+                                                                      done(YES);
+                                                                  }]
                                    failure:^(NSError *error) {
-                                       DDLogError(@"Failed syncing categories for blog %@: %@", blog.url, error);
-                                       dispatch_group_leave(syncGroup);
+                                       DDLogError(@"Failed syncing post formats for blog %@: %@", blogURL, error);
+                                       done(NO);
                                    }];
-
-    SharingSyncService *sharingService = [[SharingSyncService alloc] initWithCoreDataStack:self.coreDataStack];
-    dispatch_group_enter(syncGroup);
-    [sharingService syncPublicizeConnectionsForBlog:blog
-                                            success:^{
-                                                dispatch_group_leave(syncGroup);
-                                            }
-                                            failure:^(NSError *error) {
-                                                DDLogError(@"Failed syncing publicize connections for blog %@: %@", blog.url, error);
-                                                dispatch_group_leave(syncGroup);
-                                            }];
-
-    SharingService *publicizeService = [[SharingService alloc] initWithContextManager:[ContextManager sharedInstance]];
-    dispatch_group_enter(syncGroup);
-    [publicizeService syncPublicizeServicesForBlog:blog success:^{
-        dispatch_group_leave(syncGroup);
-    } failure:^(NSError * _Nullable error) {
-        DDLogError(@"Failed syncing publicize services for blog %@: %@", blog.url, error);
-        dispatch_group_leave(syncGroup);
-    }];
-
-    if ([RemoteFeature enabled:RemoteFeatureFlagJetpackSocialImprovements] && blog.dotComID != nil) {
-        JetpackSocialService *jetpackSocialService = [[JetpackSocialService alloc] initWithContextManager:ContextManager.sharedInstance];
-        dispatch_group_enter(syncGroup);
-        [jetpackSocialService syncSharingLimitWithDotComID:blog.dotComID success:^{
-            dispatch_group_leave(syncGroup);
+    }]];
+
+    [tasks addObject:[[BlogSyncTask alloc] initWithIdentifier:BlogSyncTaskCategories
+                                                     priority:BlogSyncTaskPriorityNormal
+                                            freshnessInterval:BlogSyncFreshnessShort
+                                                 dependencies:@[]
+                                                         work:^(void (^done)(BOOL)) {
+        Blog *blogInContext = [self blogInMainContextWithObjectID:blogObjectID];
+        if (!blogInContext) {
+            done(NO);
+            return;
+        }
+        PostCategoryService *categoryService = [[PostCategoryService alloc] initWithCoreDataStack:self.coreDataStack];
+        [categoryService syncCategoriesForBlog:blogInContext
+                                       success:^{
+                                           done(YES);
+                                       }
+                                       failure:^(NSError *error) {
+                                           DDLogError(@"Failed syncing categories for blog %@: %@", blogURL, error);
+                                           done(NO);
+                                       }];
+    }]];
+
+    [tasks addObject:[[BlogSyncTask alloc] initWithIdentifier:BlogSyncTaskPublicizeConnections
+                                                     priority:BlogSyncTaskPriorityNormal
+                                            freshnessInterval:BlogSyncFreshnessShort
+                                                 dependencies:@[]
+                                                         work:^(void (^done)(BOOL)) {
+        Blog *blogInContext = [self blogInMainContextWithObjectID:blogObjectID];
+        if (!blogInContext) {
+            done(NO);
+            return;
+        }
+        SharingSyncService *sharingService = [[SharingSyncService alloc] initWithCoreDataStack:self.coreDataStack];
+        [sharingService syncPublicizeConnectionsForBlog:blogInContext
+                                                success:^{
+                                                    done(YES);
+                                                }
+                                                failure:^(NSError *error) {
+                                                    DDLogError(@"Failed syncing publicize connections for blog %@: %@", blogURL, error);
+                                                    done(NO);
+                                                }];
+    }]];
+
+    [tasks addObject:[[BlogSyncTask alloc] initWithIdentifier:BlogSyncTaskPublicizeServices
+                                                     priority:BlogSyncTaskPriorityLow
+                                            freshnessInterval:BlogSyncFreshnessLong
+                                                 dependencies:@[]
+                                                         work:^(void (^done)(BOOL)) {
+        Blog *blogInContext = [self blogInMainContextWithObjectID:blogObjectID];
+        if (!blogInContext) {
+            done(NO);
+            return;
+        }
+        SharingService *publicizeService = [[SharingService alloc] initWithContextManager:[ContextManager sharedInstance]];
+        [publicizeService syncPublicizeServicesForBlog:blogInContext success:^{
+            done(YES);
         } failure:^(NSError * _Nullable error) {
-            DDLogError(@"Failed syncing publicize sharing limit for blog %@: %@", blog.url, error);
-            dispatch_group_leave(syncGroup);
+            DDLogError(@"Failed syncing publicize services for blog %@: %@", blogURL, error);
+            done(NO);
         }];
+    }]];
+
+    if ([RemoteFeature enabled:RemoteFeatureFlagJetpackSocialImprovements] && blog.dotComID != nil) {
+        NSNumber *dotComID = blog.dotComID;
+        [tasks addObject:[[BlogSyncTask alloc] initWithIdentifier:BlogSyncTaskSharingLimit
+                                                         priority:BlogSyncTaskPriorityLow
+                                                freshnessInterval:BlogSyncFreshnessShort
+                                                     dependencies:@[BlogSyncTaskPublicizeConnections]
+                                                             work:^(void (^done)(BOOL)) {
+            JetpackSocialService *jetpackSocialService = [[JetpackSocialService alloc] initWithContextManager:ContextManager.sharedInstance];
+            [jetpackSocialService syncSharingLimitWithDotComID:dotComID success:^{
+                done(YES);
+            } failure:^(NSError * _Nullable error) {
+                DDLogError(@"Failed syncing publicize sharing limit for blog %@: %@", blogURL, error);
+                done(NO);
+            }];
+        }]];
     }
 
-    dispatch_group_enter(syncGroup);
-    [remote getAllAuthorsWithSuccess:^(NSArray<RemoteUser *> *users) {
-        [self updateMultiAuthor:users forBlog:blogObjectID completionHandler:^{
-            dispatch_group_leave(syncGroup);
+    [tasks addObject:[[BlogSyncTask alloc] initWithIdentifier:BlogSyncTaskAuthors
+                                                     priority:BlogSyncTaskPriorityNormal
+                                            freshnessInterval:BlogSyncFreshnessShort
+                                                 dependencies:@[]
+                                                         work:^(void (^done)(BOOL)) {
+        [remote getAllAuthorsWithSuccess:^(NSArray<RemoteUser *> *users) {
+            [self updateMultiAuthor:users forBlog:blogObjectID completionHandler:^{
+                done(YES);
+            }];
+        } failure:^(NSError *error) {
+            DDLogError(@"Failed checking multi-author status for blog %@: %@", blogURL, error);
+            done(NO);
         }];
-    } failure:^(NSError *error) {
-        DDLogError(@"Failed checking multi-author status for blog %@: %@", blog.url, error);
-        dispatch_group_leave(syncGroup);
-    }];
+    }]];
 
     PlanService *planService = [[PlanService alloc] initWithCoreDataStack:self.coreDataStack];
-    dispatch_group_enter(syncGroup);
-    [planService getWpcomPlans:blog.account
-                       success:^{
-        dispatch_group_leave(syncGroup);
-    } failure:^(NSError *error) {
-        DDLogError(@"Failed updating plans: %@", error);
-        dispatch_group_leave(syncGroup);
-    }];
-
-    dispatch_group_enter(syncGroup);
-    [planService plansWithPricesForBlog:blog success:^{
-        dispatch_group_leave(syncGroup);
-    } failure:^(NSError *error) {
-        DDLogError(@"Failed checking domain credit for site %@: %@", blog.url, error);
-        dispatch_group_leave(syncGroup);
-    }];
+    [tasks addObject:[[BlogSyncTask alloc] initWithIdentifier:BlogSyncTaskPlans
+                                                     priority:BlogSyncTaskPriorityLow
+                                            freshnessInterval:BlogSyncFreshnessLong
+                                                 dependencies:@[]
+                                                         work:^(void (^done)(BOOL)) {
+        Blog *blogInContext = [self blogInMainContextWithObjectID:blogObjectID];
+        if (!blogInContext) {
+            done(NO);
+            return;
+        }
+        [planService getWpcomPlans:blogInContext.account
+                           success:^{
+            done(YES);
+        } failure:^(NSError *error) {
+            DDLogError(@"Failed updating plans: %@", error);
+            done(NO);
+        }];
+    }]];
+
+    [tasks addObject:[[BlogSyncTask alloc] initWithIdentifier:BlogSyncTaskPlanPrices
+                                                     priority:BlogSyncTaskPriorityNormal
+                                            freshnessInterval:BlogSyncFreshnessShort
+                                                 dependencies:@[BlogSyncTaskSiteDetails]
+                                                         work:^(void (^done)(BOOL)) {
+        Blog *blogInContext = [self blogInMainContextWithObjectID:blogObjectID];
+        if (!blogInContext) {
+            done(NO);
+            return;
+        }
+        [planService plansWithPricesForBlog:blogInContext success:^{
+            done(YES);
+        } failure:^(NSError *error) {
+            DDLogError(@"Failed checking domain credit for site %@: %@", blogURL, error);
+            done(NO);
+        }];
+    }]];
+
+    [tasks addObject:[[BlogSyncTask alloc] initWithIdentifier:BlogSyncTaskEditorSettings
+                                                     priority:BlogSyncTaskPriorityNormal
+                                            freshnessInterval:BlogSyncFreshnessShort
+                                                 dependencies:@[BlogSyncTaskSettings]
+                                                         work:^(void (^done)(BOOL)) {
+        Blog *blogInContext = [self blogInMainContextWithObjectID:blogObjectID];
+        if (!blogInContext) {
+            done(NO);
+            return;
+        }
+        EditorSettingsService *editorService = [[EditorSettingsService alloc] initWithCoreDataStack:self.coreDataStack];
+        [editorService syncEditorSettingsForBlog:blogInContext success:^{
+            done(YES);
+        } failure:^(NSError * _Nonnull __unused error) {
+            DDLogError(@"Failed to sync Editor settings");
+            done(NO);
+        }];
+    }]];
 
-    EditorSettingsService *editorService = [[EditorSettingsService alloc] initWithCoreDataStack:self.coreDataStack];
-    dispatch_group_enter(syncGroup);
-    [editorService syncEditorSettingsForBlog:blog success:^{
-        dispatch_group_leave(syncGroup);
-    } failure:^(NSError * _Nonnull __unused error) {
-        DDLogError(@"Failed to sync Editor settings");
-        dispatch_group_leave(syncGroup);
-    }];
-    
     if ([FreeToPaidPlansDashboardCardHelper isFeatureEnabled]) {
-        dispatch_group_enter(syncGroup);
-        [self refreshDomainsFor:blog success:^{
-            dispatch_group_leave(syncGroup);
-        } failure:^(NSError * _Nonnull error) {
-            DDLogError(@"Failed refreshing domains: %@", error);
-            dispatch_group_leave(syncGroup);
-        }];
+        [tasks addObject:[[BlogSyncTask alloc] initWithIdentifier:BlogSyncTaskDomains
+                                                         priority:BlogSyncTaskPriorityNormal
+                                                freshnessInterval:BlogSyncFreshnessShort
+                                                     dependencies:@[BlogSyncTaskSiteDetails]
+                                                             work:^(void (^done)(BOOL)) {
+            Blog *blogInContext = [self blogInMainContextWithObjectID:blogObjectID];
+            if (!blogInContext) {
+                done(NO);
+                return;
+            }
+            [self refreshDomainsFor:blogInContext success:^{
+                done(YES);
+            } failure:^(NSError * _Nonnull error) {
+                DDLogError(@"Failed refreshing domains: %@", error);
+                done(NO);
+            }];
+        }]];
     }
-    
-    // When everything has left the syncGroup (all calls have ended with success
-    // or failure) perform the completionHandler
-    dispatch_group_notify(syncGroup, dispatch_get_main_queue(),^{
-        if (completionHandler) {
-            completionHandler();
-        }
-    });
+
+    [[BlogSyncScheduler shared] syncTasks:tasks forBlog:blogObjectID userInitiated:userInitiated completion:completionHandler];
 }
 
 - (void)syncSettingsForBlog:(Blog *)blog
@@ -401,6 +524,7 @@ NSString *const WPBlogSettingsUpdatedNotification = @"WPBlogSettingsUpdatedNotif
         Blog *blogInContext = [context existingObjectWithID:blog.objectID error:nil];
         [context deleteObject:blogInContext];
     }];
+    [[BlogMetadataFreshness shared] invalidateBlogID:blog.objectID];
 
     if (account) {
         AccountService *accountService = [[AccountService alloc] initWithCoreDataStack:self.coreDataStack];
@@ -442,6 +566,12 @@ NSString *const WPBlogSettingsUpdatedNotification = @"WPBlogSettingsUpdatedNotif
 
 #pragma mark - Private methods
 
+/// Returns the blog with the given ID in the main context, or `nil` if it has been deleted.
+- (Blog *)blogInMainContextWithObjectID:(NSManagedObjectID *)blogObjectID
+{
+    return (Blog *)[self.coreDataStack.mainContext existingObjectWithID:blogObjectID error:nil];
+}
+
 - (void)mergeBlogs:(NSArray<RemoteBlog *> *)blogs withAccountID:(NSManagedObjectID *)accountID inContext:(NSManagedObjectContext *)context
 {
     // Nuke dead blogs
@@ -608,7 +738,19 @@ NSString *const WPBlogSettingsUpdatedNotification = @"WPBlogSettingsUpdatedNotif
 
 - (void)updateMultiAuthor:(NSArray<RemoteUser *> *)users forBlog:(NSManagedObjectID *)blogObjectID completionHandler:(void (^)(void))completion
 {
+    BlogMetadataFreshness *freshness = [BlogMetadataFreshness shared];
+    NSData *fingerprint = [freshness fingerprintForUsers:users];
+    if ([freshness isFingerprint:fingerprint mergedForEndpoint:BlogMetadataEndpointAuthors blogID:blogObjectID]) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            if (completion) {
+                completion();
+            }
+        });
+        return;
+    }
+
     [self.coreDataStack performAndSaveUsingBlock:^(NSManagedObjectContext *context) {
+        context.name = BlogMetadataFreshness.mergeContextName;
         NSError *error;
         Blog *blog = (Blog *)[context existingObjectWithID:blogObjectID error:&error];
         if (error) {
@@ -644,7 +786,12 @@ NSString *const WPBlogSettingsUpdatedNotification = @"WPBlogSettingsUpdatedNotif
                 }
             }
         }
-    } completion: completion onQueue:dispatch_get_main_queue()];
+    } completion:^{
+        [freshness recordFingerprint:fingerprint forEndpoint:BlogMetadataEndpointAuthors blogID:blogObjectID];
+        if (completion) {
+            completion();
+        }
+    } onQueue:dispatch_get_main_queue()];
 }
 
 - (BlogDetailsHandler)blogDetailsHandlerWithBlogObjectID:(NSManagedObjectID *)blogObjectID
@@ -667,7 +814,19 @@ NSString *const WPBlogSettingsUpdatedNotification = @"WPBlogSettingsUpdatedNotif
                                completionHandler:(void (^)(void))completion
 {
     return ^void(NSDictionary *options) {
+        BlogMetadataFreshness *freshness = [BlogMetadataFreshness shared];
+        NSData *fingerprint = [freshness fingerprintForPayload:options];
+        if ([freshness isFingerprint:fingerprint mergedForEndpoint:BlogMetadataEndpointOptions blogID:blogObjectID]) {
+            dispatch_async(dispatch_get_main_queue(), ^{
+                if (completion) {
+                    completion();
+                }
+            });
+            return;
+        }
+
         [self.coreDataStack performAndSaveUsingBlock:^(NSManagedObjectContext *context) {
+            context.name = BlogMetadataFreshness.mergeContextName;
             Blog *blog = (Blog *)[context existingObjectWithID:blogObjectID error:nil];
             if (!blog) {
                 return;
@@ -693,7 +852,12 @@ NSString *const WPBlogSettingsUpdatedNotification = @"WPBlogSettingsUpdatedNotif
                     blog.lastUpdateWarning = WordPressMinimumVersion;
                 }
             }
-        } completion:completion onQueue:dispatch_get_main_queue()];
+        } completion:^{
+            [freshness recordFingerprint:fingerprint forEndpoint:BlogMetadataEndpointOptions blogID:blogObjectID];
+            if (completion) {
+                completion();
+            }
+        } onQueue:dispatch_get_main_queue()];
     };
 }
 
@@ -701,7 +865,19 @@ NSString *const WPBlogSettingsUpdatedNotification = @"WPBlogSettingsUpdatedNotif
                                        completionHandler:(void (^)(void))completion
 {
     return ^void(NSDictionary *postFormats) {
+        BlogMetadataFreshness *freshness = [BlogMetadataFreshness shared];
+        NSData *fingerprint = [freshness fingerprintForPayload:postFormats];
+        if ([freshness isFingerprint:fingerprint mergedForEndpoint:BlogMetadataEndpointPostFormats blogID:blogObjectID]) {
+            dispatch_async(dispatch_get_main_queue(), ^{
+                if (completion) {
+                    completion();
+                }
+            });
+            return;
+        }
+
         [self.coreDataStack performAndSaveUsingBlock:^(NSManagedObjectContext *context) {
+            context.name = BlogMetadataFreshness.mergeContextName;
             Blog *blog = (Blog *)[context existingObjectWithID:blogObjectID error:nil];
             if (blog) {
                 NSDictionary *formats = postFormats;
@@ -712,7 +888,12 @@ NSString *const WPBlogSettingsUpdatedNotification = @"WPBlogSettingsUpdatedNotif
                 }
                 blog.postFormats = formats;
             }
-        } completion:completion onQueue:dispatch_get_main_queue()];
+        } completion:^{
+            [freshness recordFingerprint:fingerprint forEndpoint:BlogMetadataEndpointPostFormats blogID:blogObjectID];
+            if (completion) {
+                completion();
+            }
+        } onQueue:dispatch_get_main_queue()];
     };
 }
 
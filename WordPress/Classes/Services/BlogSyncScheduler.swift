@@ -0,0 +1,315 @@
+import Foundation
+import CoreData
+import WordPressShared
+
+/// The relative importance of a `BlogSyncTask`. When the scheduler is saturated,
+/// ready tasks with a higher priority start first.
+@objc enum BlogSyncTaskPriority: Int {
+    case low
+    case normal
+    case high
+}
+
+/// A unit of work of a blog metadata sync, such as syncing the blog's settings or its categories.
+@objc final class BlogSyncTask: NSObject {
+    /// Performs the task and calls `done` exactly once, reporting whether the sync succeeded.
+    /// Tasks that don't call `done` in time are considered failed, and later calls are ignored.
+    typealias Work = (_ done: @escaping (_ succeeded: Bool) -> Void) -> Void
+
+    /// Identifies the task within a sync, and across syncs of the same blog for freshness purposes.
+    @objc let identifier: String
+
+    @objc let priority: BlogSyncTaskPriority
+
+    /// How long the result of a successful run stays fresh. Fresh tasks are skipped. Zero means the task always runs.
+    @objc let freshnessInterval: TimeInterval
+
+    /// The identifiers of the tasks in the same sync that must finish (successfully or not) before this one starts.
+    /// Dependencies that aren't part of the sync are ignored.
+    @objc let dependencies: [String]
+
+    let work: Work
+
+    @objc init(identifier: String,
+               priority: BlogSyncTaskPriority,
+               freshnessInterval: TimeInterval,
+               dependencies: [String],
+               work: @escaping Work) {
+        self.identifier = identifier
+        self.priority = priority
+        self.freshnessInterval = freshnessInterval
+        self.dependencies = dependencies
+        self.work = work
+        super.init()
+    }
+}
+
+/// Timing information about a task handled by `BlogSyncScheduler`.
+struct BlogSyncTaskMetrics {
+    enum Outcome {
+        case succeeded
+        case failed
+        /// The task didn't call `done` in time, and its slot was given to the next task.
+        case timedOut
+        /// The task wasn't run because its previous result was still fresh.
+        case skipped
+    }
+
+    let identifier: String
+    let blogID: NSManagedObjectID
+    let outcome: Outcome
+    /// The time spent waiting for dependencies and a free slot.
+    let waitTime: TimeInterval
+    /// The time spent running the task.
+    let duration: TimeInterval
+}
+
+/// Runs the tasks of blog metadata syncs, ordering them by dependencies and priority,
+/// while capping the number of tasks in flight across all blogs being synced.
+///
+/// Syncing many blogs at once used to start every remote call of every blog at the same time.
+/// Going through one shared scheduler keeps the network and Core Data load bounded, and lets
+/// tasks whose result is still fresh be skipped entirely.
+///
+/// Syncs the user asked for, such as a pull to refresh, have their own pool of slots, so they
+/// don't queue behind the background syncs of other blogs. Within a pool, the blog with the fewest
+/// tasks running goes first, so that one blog with many tasks doesn't hold up the others.
+@objc final class BlogSyncScheduler: NSObject {
+
+    @objc static let shared = BlogSyncScheduler(maxConcurrentTasks: 4)
+
+    /// Called on the scheduler's internal queue for each task handled. Logs the metrics by default.
+    var metricsHandler: (BlogSyncTaskMetrics) -> Void {
+        get { metricsHandlerLock.withLock { _metricsHandler } }
+        set { metricsHandlerLock.withLock { _metricsHandler = newValue } }
+    }
+
+    private let metricsHandlerLock = NSLock()
+    private var _metricsHandler: (BlogSyncTaskMetrics) -> Void = { metrics in
+        DDLogDebug("Blog sync task \(metrics.identifier) \(metrics.outcome): waited \(metrics.waitTime)s, ran \(metrics.duration)s")
+    }
+
+    private let maxConcurrentTasks: Int
+    private let taskTimeout: TimeInterval
+    private let workQueue: DispatchQueue
+    private let now: () -> Date
+    private let queue = DispatchQueue(label: "org.wordpress.blog-sync-scheduler")
+
+    private var pendingTasks: [PendingTask] = []
+    private var runningTaskCount = 0
+    private var runningUserInitiatedTaskCount = 0
+    private var runningTaskCounts: [NSManagedObjectID: Int] = [:]
+    private var nextSequence = 0
+    private var lastSuccessDates: [FreshnessKey: Date] = [:]
+
+    /// - Parameters:
+    ///   - maxConcurrentTasks: The maximum number of tasks of background syncs running at the same time.
+    ///     User-initiated syncs have a separate pool of the same size.
+    ///   - taskTimeout: How long a task can run before its slot is freed, in case it never calls `done`.
+    ///   - workQueue: The queue the tasks and completion handlers are called on.
+    ///   - now: Returns the current date. Used to check freshness and measure tasks.
+    init(maxConcurrentTasks: Int, taskTimeout: TimeInterval = 120, workQueue: DispatchQueue = .main, now: @escaping () -> Date = Date.init) {
+        precondition(maxConcurrentTasks > 0, "The scheduler must be allowed to run at least one task")
+        self.maxConcurrentTasks = maxConcurrentTasks
+        self.taskTimeout = taskTimeout
+        self.workQueue = workQueue
+        self.now = now
+        super.init()
+    }
+
+    /// Schedules the tasks of a background sync of the given blog.
+    @objc(syncTasks:forBlog:completion:)
+    func sync(_ tasks: [BlogSyncTask], forBlog blogID: NSManagedObjectID, completion: (() -> Void)?) {
+        sync(tasks, forBlog: blogID, isUserInitiated: false, completion: completion)
+    }
+
+    /// Schedules the tasks of a sync of the given blog.
+    ///
+    /// - Parameters:
+    ///   - tasks: The tasks to run. Identifiers must be unique within the sync.
+    ///   - blogID: The blog being synced. Freshness is tracked per blog.
+    ///   - isUserInitiated: Whether the user is waiting for the sync, in which case its tasks
+    ///     start ahead of the tasks of background syncs.
+    ///   - completion: Called on the work queue once every task has finished or been skipped.
+    @objc(syncTasks:forBlog:userInitiated:completion:)
+    func sync(_ tasks: [BlogSyncTask], forBlog blogID: NSManagedObjectID, isUserInitiated: Bool, completion: (() -> Void)?) {
+        wpAssert(Set(tasks.map(\.identifier)).count == tasks.count, "Blog sync task identifiers must be unique")
+
+        queue.async {
+            guard !tasks.isEmpty else {
+                self.workQueue.async { completion?() }
+                return
+            }
+
+            let sync = Sync(blogID: blogID, identifiers: Set(tasks.map(\.identifier)), isUserInitiated: isUserInitiated, completion: completion)
+            let enqueueDate = self.now()
+            for task in tasks {
+                self.pendingTasks.append(PendingTask(task: task, sync: sync, enqueueDate: enqueueDate, sequence: self.nextSequence))
+                self.nextSequence += 1
+            }
+            self.startReadyTasks()
+        }
+    }
+
+    /// Forgets the results of previous syncs of the given blog, so that the next sync runs every task.
+    @objc func invalidateFreshness(forBlog blogID: NSManagedObjectID) {
+        queue.async {
+            self.lastSuccessDates = self.lastSuccessDates.filter { $0.key.blogID != blogID }
+        }
+    }
+
+    // MARK: - Scheduling
+
+    /// Must be called on `queue`.
+    private func startReadyTasks() {
+        while let index = nextTaskIndex() {
+            let pending = pendingTasks.remove(at: index)
+            let startDate = now()
+
+            let key = FreshnessKey(blogID: pending.sync.blogID, identifier: pending.task.identifier)
+            if let lastSuccess = lastSuccessDates[key], startDate.timeIntervalSince(lastSuccess) < pending.task.freshnessInterval {
+                finish(pending, outcome: .skipped, startDate: startDate)
+                continue
+            }
+
+            updateRunningTaskCounts(for: pending.sync, by: 1)
+            var isFinished = false
+            let complete = { (outcome: BlogSyncTaskMetrics.Outcome) in
+                // Called on `queue`, either by the task or by the timeout, whichever comes first.
+                guard !isFinished else {
+                    return
+                }
+                isFinished = true
+                self.updateRunningTaskCounts(for: pending.sync, by: -1)
+                self.finish(pending, outcome: outcome, startDate: startDate)
+                self.startReadyTasks()
+            }
+            queue.asyncAfter(deadline: .now() + taskTimeout) {
+                if !isFinished {
+                    DDLogError("Blog sync task \(pending.task.identifier) didn't finish in \(self.taskTimeout)s")
+                }
+                complete(.timedOut)
+            }
+            workQueue.async {
+                pending.task.work { succeeded in
+                    self.queue.async {
+                        complete(succeeded ? .succeeded : .failed)
+                    }
+                }
+            }
+        }
+    }
+
+    /// Returns the index of the pending task to start next, if a task is ready and its pool has a free slot.
+    ///
+    /// A task is ready once all of its dependencies in the same sync have finished. Among the ready tasks,
+    /// tasks of user-initiated syncs win, then tasks of the blog with the fewest tasks running, then the
+    /// one with the highest priority that was scheduled first.
+    private func nextTaskIndex() -> Int? {
+        guard !pendingTasks.isEmpty else {
+            return nil
+        }
+
+        let candidates = pendingTasks.indices.filter { pendingTasks[$0].isReady && hasFreeSlot(for: pendingTasks[$0].sync) }
+        if let index = candidates.min(by: { precedes(pendingTasks[$0], pendingTasks[$1]) }) {
+            return index
+        }
+
+        // Nothing is ready and nothing is running to unblock the pending tasks, which means the
+        // dependencies form a cycle. Break it rather than never completing the sync.
+        if runningTaskCount == 0 {
+            wpAssertionFailure("Blog sync task dependencies form a cycle")
+            return pendingTasks.indices.min(by: { precedes(pendingTasks[$0], pendingTasks[$1]) })
+        }
+        return nil
+    }
+
+    private func hasFreeSlot(for sync: Sync) -> Bool {
+        if sync.isUserInitiated {
+            return runningUserInitiatedTaskCount < maxConcurrentTasks
+        }
+        return runningTaskCount - runningUserInitiatedTaskCount < maxConcurrentTasks
+    }
+
+    private func precedes(_ lhs: PendingTask, _ rhs: PendingTask) -> Bool {
+        if lhs.sync.isUserInitiated != rhs.sync.isUserInitiated {
+            return lhs.sync.isUserInitiated
+        }
+        let lhsRunning = runningTaskCounts[lhs.sync.blogID, default: 0]
+        let rhsRunning = runningTaskCounts[rhs.sync.blogID, default: 0]
+        if lhsRunning != rhsRunning {
+            return lhsRunning < rhsRunning
+        }
+        return lhs.precedes(rhs)
+    }
+
+    private func updateRunningTaskCounts(for sync: Sync, by delta: Int) {
+        runningTaskCount += delta
+        if sync.isUserInitiated {
+            runningUserInitiatedTaskCount += delta
+        }
+        let count = runningTaskCounts[sync.blogID, default: 0] + delta
+        runningTaskCounts[sync.blogID] = count > 0 ? count : nil
+    }
+
+    private func finish(_ pending: PendingTask, outcome: BlogSyncTaskMetrics.Outcome, startDate: Date) {
+        let finishDate = now()
+        if outcome == .succeeded {
+            lastSuccessDates[FreshnessKey(blogID: pending.sync.blogID, identifier: pending.task.identifier)] = finishDate
+        }
+
+        metricsHandler(BlogSyncTaskMetrics(
+            identifier: pending.task.identifier,
+            blogID: pending.sync.blogID,
+            outcome: outcome,
+            waitTime: startDate.timeIntervalSince(pending.enqueueDate),
+            duration: finishDate.timeIntervalSince(startDate)
+        ))
+
+        pending.sync.finished.insert(pending.task.identifier)
+        if pending.sync.finished.count == pending.sync.identifiers.count, let completion = pending.sync.completion {
+            workQueue.async(execute: completion)
+        }
+    }
+}
+
+private extension BlogSyncScheduler {
+    struct FreshnessKey: Hashable {
+        let blogID: NSManagedObjectID
+        let identifier: String
+    }
+
+    /// The state shared by the tasks of a single `sync(_:forBlog:isUserInitiated:completion:)` call.
+    final class Sync {
+        let blogID: NSManagedObjectID
+        let identifiers: Set<String>
+        let isUserInitiated: Bool
+        let completion: (() -> Void)?
+        var finished: Set<String> = []
+
+        init(blogID: NSManagedObjectID, identifiers: Set<String>, isUserInitiated: Bool, completion: (() -> Void)?) {
+            self.blogID = blogID
+            self.identifiers = identifiers
+            self.isUserInitiated = isUserInitiated
+            self.completion = completion
+        }
+    }
+
+    struct PendingTask {
+        let task: BlogSyncTask
+        let sync: Sync
+        let enqueueDate: Date
+        let sequence: Int
+
+        var isReady: Bool {
+            task.dependencies.allSatisfy { !sync.identifiers.contains($0) || sync.finished.contains($0) }
+        }
+
+        func precedes(_ other: PendingTask) -> Bool {
+            if task.priority != other.task.priority {
+                return task.priority.rawValue > other.task.priority.rawValue
+            }
+            return sequence < other.sequence
+        }
+    }
+}
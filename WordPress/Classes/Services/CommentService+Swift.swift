@@ -57,16 +57,13 @@ extension CommentService {
 
         // iterate over the ancestor comment's descendants and update their visibility for the comment thread.
         //
-        // the hierarchy property stores ancestral info by storing a string version of its comment ID hierarchy,
-        // e.g.: "0000000012.0000000025.00000000035". The idea is to check if the ancestor comment's ID exists in the hierarchy.
+        // the hierarchy key stores ancestral info by packing the comment IDs of the thread path, so a descendant's
+        // key always starts with the ancestor comment's key.
         // as an optimization, skip checking the hierarchy when the comment is the direct child of the ancestor comment.
         context.perform {
             comments.filter { comment in
                 comment.parentID == ancestorComment.commentID
-                || comment.hierarchy
-                    .split(separator: ".")
-                    .compactMap({ Int32($0) })
-                    .contains(ancestorComment.commentID)
+                || (comment.threadRoot == ancestorComment.threadRoot && comment.isDescendant(of: ancestorComment))
             }.forEach { childComment in
                 childComment.visibleOnReader = isVisible
             }
@@ -116,6 +116,12 @@ extern NSUInteger const WPTopLevelHierarchicalCommentsPerPage;
 // A partial set does not count toward the total number of pages.
 - (NSInteger)numberOfHierarchicalPagesSyncedforPost:(ReaderPost *)post;
 
+// Derives the thread order of the post's comments that were stored without one, e.g. by a
+// version of the app that predates hierarchy keys. Does nothing once every comment has one.
+// Runs in the background, then calls the completion block on the main queue with whether any
+// comment was updated.
+- (void)backfillThreadOrderForPost:(ReaderPost *)post completion:(nullable void (^)(BOOL backfilled))completion;
+
 
 /**
     REST Helpers:
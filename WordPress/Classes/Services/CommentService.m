@@ -17,6 +17,33 @@ NSUInteger const WPTopLevelHierarchicalCommentsPerPage = 20;
 NSInteger const  WPNumberOfCommentsToSync = 100;
 static NSTimeInterval const CommentsRefreshTimeoutInSeconds = 60 * 5; // 5 minutes
 
+// A comment that has not been synced yet has a 0 commentID. If 0 is used in the hierarchy,
+// the comment will preceed any other comment in its level of the hierarchy.
+// Instead we'll use the largest segment value to ensure the comment will appear last in a list.
+static uint32_t const UnsyncedCommentHierarchySegment = UINT32_MAX;
+static int32_t const UnsyncedCommentThreadRoot = INT32_MAX;
+
+static void AppendHierarchySegment(NSMutableData *hierarchyKey, uint32_t commentID)
+{
+    uint32_t segment = CFSwapInt32HostToBig(commentID);
+    [hierarchyKey appendBytes:&segment length:sizeof(segment)];
+}
+
+/// Hierarchy keys are compared the way SQLite compares BLOBs: byte by byte, with a shorter
+/// key ordered before any longer key it is a prefix of (i.e. a parent before its replies).
+static NSComparisonResult CompareHierarchyKeys(NSData *lhs, NSData *rhs)
+{
+    NSUInteger length = MIN(lhs.length, rhs.length);
+    int result = length > 0 ? memcmp(lhs.bytes, rhs.bytes, length) : 0;
+    if (result != 0) {
+        return result < 0 ? NSOrderedAscending : NSOrderedDescending;
+    }
+    if (lhs.length == rhs.length) {
+        return NSOrderedSame;
+    }
+    return lhs.length < rhs.length ? NSOrderedAscending : NSOrderedDescending;
+}
+
 @interface CommentService ()
 
 @property (nonnull, strong, nonatomic) CommentServiceRemoteFactory *remoteFactory;
@@ -656,6 +683,31 @@ static NSTimeInterval const CommentsRefreshTimeoutInSeconds = 60 * 5; // 5 minut
     return (NSInteger)page;
 }
 
+- (void)backfillThreadOrderForPost:(ReaderPost *)post completion:(void (^)(BOOL backfilled))completion
+{
+    NSManagedObjectID *postObjectID = post.objectID;
+    __block BOOL backfilled = NO;
+    [self.coreDataStack performAndSaveUsingBlock:^(NSManagedObjectContext *context) {
+        ReaderPost *post = [context existingObjectWithID:postObjectID error:nil];
+        if (!post) {
+            return;
+        }
+
+        NSFetchRequest *countRequest = [[NSFetchRequest alloc] initWithEntityName:NSStringFromClass([Comment class])];
+        countRequest.predicate = [NSPredicate predicateWithFormat:@"post = %@ AND hierarchyKey = nil", post];
+        if ([context countForFetchRequest:countRequest error:nil] == 0) {
+            return;
+        }
+
+        [self backfillHierarchyKeysForPost:post];
+        backfilled = YES;
+    } completion:^{
+        if (completion) {
+            completion(backfilled);
+        }
+    } onQueue:dispatch_get_main_queue()];
+}
+
 #pragma mark - REST Helpers
 
 - (NSString *)sanitizeCommentContent:(NSString *)string isPrivateSite:(BOOL)isPrivateSite
@@ -990,32 +1042,97 @@ static NSTimeInterval const CommentsRefreshTimeoutInSeconds = 60 * 5; // 5 minut
 {
     NSParameterAssert(blog.managedObjectContext != nil);
 
-    NSMutableArray *commentsToKeep = [NSMutableArray array];
+    NSPredicate *blogPredicate = [NSPredicate predicateWithFormat:@"blog = %@", blog];
+    NSMutableDictionary<NSNumber *, Comment *> *existingComments = [self commentsForRemoteComments:comments
+                                                                                matchingPredicate:blogPredicate
+                                                                                        inContext:blog.managedObjectContext];
+    NSMutableSet<NSNumber *> *commentIDsToKeep = [NSMutableSet setWithCapacity:comments.count];
     for (RemoteComment *remoteComment in comments) {
-        Comment *comment = [blog commentWithID:remoteComment.commentID];
+        Comment *comment = remoteComment.commentID ? existingComments[remoteComment.commentID] : nil;
         if (!comment) {
             comment = [self createCommentForBlog:blog];
         }
         [self updateComment:comment withRemoteComment:remoteComment];
-        [commentsToKeep addObject:comment];
+        existingComments[@(comment.commentID)] = comment;
+        [commentIDsToKeep addObject:@(comment.commentID)];
     }
 
     if (purgeExisting) {
-        NSSet *existingComments = blog.comments;
-        if (existingComments.count > 0) {
-            for (Comment *comment in existingComments) {
-                // Don't delete unpublished comments
-                if (![commentsToKeep containsObject:comment] && comment.commentID != 0) {
-                    DDLogInfo(@"Deleting Comment: %@", comment);
-                    [blog.managedObjectContext deleteObject:comment];
-                }
-            }
-        }
+        // Don't delete unpublished comments
+        NSPredicate *predicate = [NSPredicate predicateWithFormat:@"blog = %@ AND commentID != 0 AND NOT (commentID IN %@)", blog, commentIDsToKeep];
+        [self batchDeleteCommentsMatchingPredicate:predicate ownedBy:blog];
     }
 
     [self deleteUnownedCommentsInContext:blog.managedObjectContext];
 }
 
+/// Fetches the existing comments for the given remote comments with a single request.
+///
+/// @return the comments keyed by their comment ID.
+- (NSMutableDictionary<NSNumber *, Comment *> *)commentsForRemoteComments:(NSArray<RemoteComment *> *)remoteComments
+                                                        matchingPredicate:(NSPredicate *)predicate
+                                                                inContext:(NSManagedObjectContext *)context
+{
+    NSMutableArray<NSNumber *> *commentIDs = [NSMutableArray arrayWithCapacity:remoteComments.count];
+    for (RemoteComment *remoteComment in remoteComments) {
+        if (remoteComment.commentID) {
+            [commentIDs addObject:remoteComment.commentID];
+        }
+    }
+
+    NSMutableDictionary<NSNumber *, Comment *> *commentsByID = [NSMutableDictionary dictionaryWithCapacity:commentIDs.count];
+    if (commentIDs.count == 0) {
+        return commentsByID;
+    }
+
+    NSFetchRequest *fetchRequest = [[NSFetchRequest alloc] initWithEntityName:NSStringFromClass([Comment class])];
+    NSPredicate *idsPredicate = [NSPredicate predicateWithFormat:@"commentID IN %@", commentIDs];
+    fetchRequest.predicate = [NSCompoundPredicate andPredicateWithSubpredicates:@[predicate, idsPredicate]];
+    fetchRequest.returnsObjectsAsFaults = NO;
+
+    NSError *error;
+    NSArray *results = [context executeFetchRequest:fetchRequest error:&error];
+    if (error) {
+        DDLogError(@"Error fetching existing comments: %@", error);
+    }
+
+    for (Comment *comment in results) {
+        NSNumber *commentID = @(comment.commentID);
+        if (!commentsByID[commentID]) {
+            commentsByID[commentID] = comment;
+        }
+    }
+    return commentsByID;
+}
+
+/// Deletes the comments matching `predicate` from the persistent store without loading them,
+/// then merges the deletions into the owner's context and the main context.
+/// Does not save context.
+- (void)batchDeleteCommentsMatchingPredicate:(NSPredicate *)predicate ownedBy:(NSManagedObject *)owner
+{
+    NSManagedObjectContext *context = owner.managedObjectContext;
+    if (owner.objectID.isTemporaryID) {
+        // The owner hasn't been saved yet, so there can't be any of its comments in the store.
+        return;
+    }
+
+    NSFetchRequest *fetchRequest = [[NSFetchRequest alloc] initWithEntityName:NSStringFromClass([Comment class])];
+    fetchRequest.predicate = predicate;
+    NSBatchDeleteRequest *deleteRequest = [[NSBatchDeleteRequest alloc] initWithFetchRequest:fetchRequest];
+
+    NSError *error;
+    NSArray<NSManagedObjectID *> *deletedObjectIDs = [context executeBatchDeleteRequest:deleteRequest
+                                                          mergingChangesIntoMainContext:self.coreDataStack.mainContext
+                                                                                  error:&error];
+    if (!deletedObjectIDs) {
+        DDLogError(@"Error deleting comments: %@", error);
+        return;
+    }
+    if (deletedObjectIDs.count > 0) {
+        DDLogInfo(@"Deleted %lu comments", (unsigned long)deletedObjectIDs.count);
+    }
+}
+
 #pragma mark - Post centric methods
 
 - (NSMutableArray *)ancestorsForCommentWithParentID:(NSNumber *)parentID andCurrentAncestors:(NSArray *)currentAncestors
@@ -1038,25 +1155,89 @@ static NSTimeInterval const CommentsRefreshTimeoutInSeconds = 60 * 5; // 5 minut
     return ancestors;
 }
 
-- (NSString *)hierarchyFromAncestors:(NSArray *)ancestors andCommentID:(NSNumber *)commentID
+- (NSData *)hierarchyKeyFromAncestors:(NSArray<NSNumber *> *)ancestors andCommentID:(int32_t)commentID
 {
-    NSArray *arr = [ancestors arrayByAddingObject:commentID];
-    arr = [self formatHierarchyElements:arr];
-    return [arr componentsJoinedByString:@"."];
+    NSMutableData *hierarchyKey = [NSMutableData dataWithCapacity:(ancestors.count + 1) * sizeof(uint32_t)];
+    for (NSNumber *ancestorID in ancestors) {
+        AppendHierarchySegment(hierarchyKey, ancestorID.unsignedIntValue);
+    }
+    AppendHierarchySegment(hierarchyKey, (uint32_t)commentID);
+    return hierarchyKey;
 }
 
-- (NSArray *)formatHierarchyElements:(NSArray *)hierarchy
+// Rebuilds the hierarchy keys of all the post's comments from their parent IDs, ordering
+// siblings by comment ID like the sync does.
+// Does not save context
+- (void)backfillHierarchyKeysForPost:(BasePost *)post
 {
-    NSMutableArray *arr = [NSMutableArray array];
-    for (NSNumber *commentID in hierarchy) {
-        [arr addObject:[self formattedHierarchyElement:commentID]];
+    NSMutableDictionary<NSNumber *, Comment *> *commentsByID = [NSMutableDictionary dictionaryWithCapacity:post.comments.count];
+    for (Comment *comment in post.comments) {
+        if (comment.commentID != 0) {
+            commentsByID[@(comment.commentID)] = comment;
+        }
+    }
+
+    NSMutableSet<NSNumber *> *threadRoots = [NSMutableSet set];
+    for (Comment *comment in post.comments) {
+        // Walk up to the thread root. The depth guard protects against cycles in corrupted data.
+        NSMutableArray<NSNumber *> *ancestors = [NSMutableArray array];
+        Comment *parent = comment.parentID != 0 ? commentsByID[@(comment.parentID)] : nil;
+        while (parent != nil && ancestors.count <= (NSUInteger)commentsByID.count) {
+            [ancestors insertObject:@(parent.commentID) atIndex:0];
+            parent = parent.parentID != 0 ? commentsByID[@(parent.parentID)] : nil;
+        }
+
+        uint32_t segment = comment.commentID != 0 ? (uint32_t)comment.commentID : UnsyncedCommentHierarchySegment;
+        comment.hierarchyKey = [self hierarchyKeyFromAncestors:ancestors andCommentID:(int32_t)segment];
+        if (ancestors.count > 0) {
+            comment.threadRoot = ancestors.firstObject.intValue;
+        } else {
+            comment.threadRoot = comment.commentID != 0 ? comment.commentID : UnsyncedCommentThreadRoot;
+        }
+        [threadRoots addObject:@(comment.threadRoot)];
     }
-    return arr;
+
+    [self updatePositionsInThreads:threadRoots forPost:post];
 }
 
-- (NSString *)formattedHierarchyElement:(NSNumber *)commentID
+// Does not save context
+- (void)updatePositionsInThreads:(NSSet<NSNumber *> *)threadRoots forPost:(BasePost *)post
 {
-    return [NSString stringWithFormat:@"%010u", [commentID integerValue]];
+    if (threadRoots.count == 0 || post.managedObjectContext == nil) {
+        return;
+    }
+
+    NSFetchRequest *fetchRequest = [[NSFetchRequest alloc] initWithEntityName:NSStringFromClass([Comment class])];
+    fetchRequest.predicate = [NSPredicate predicateWithFormat:@"post = %@ AND threadRoot IN %@", post, threadRoots];
+    fetchRequest.returnsObjectsAsFaults = NO;
+
+    NSError *error = nil;
+    NSArray<Comment *> *comments = [post.managedObjectContext executeFetchRequest:fetchRequest error:&error];
+    if (error) {
+        DDLogError(@"Error fetching comment threads %@: %@", threadRoots, error);
+        return;
+    }
+
+    comments = [comments sortedArrayUsingComparator:^NSComparisonResult(Comment *lhs, Comment *rhs) {
+        if (lhs.threadRoot != rhs.threadRoot) {
+            return lhs.threadRoot < rhs.threadRoot ? NSOrderedAscending : NSOrderedDescending;
+        }
+        return CompareHierarchyKeys(lhs.hierarchyKey, rhs.hierarchyKey);
+    }];
+
+    int32_t threadRoot = 0;
+    int32_t position = 0;
+    for (Comment *comment in comments) {
+        if (comment.threadRoot != threadRoot) {
+            threadRoot = comment.threadRoot;
+            position = 0;
+        }
+        // Only touch comments whose position actually changed, so unchanged threads are not saved again.
+        if (comment.position != position) {
+            comment.position = position;
+        }
+        position++;
+    }
 }
 
 - (void)createHierarchicalCommentWithContent:(NSString *)content
@@ -1136,22 +1317,20 @@ static NSTimeInterval const CommentsRefreshTimeoutInSeconds = 60 * 5; // 5 minut
     NSParameterAssert(comment.managedObjectContext != nil);
 
     // Update depth and hierarchy
-    NSNumber *commentID = [NSNumber numberWithInt:comment.commentID];
-
-    if (commentID != 0) {
-        // A new comment will have a 0 commentID. If 0 is used when formatting the hierarchy,
-        // the comment will preceed any other comment in its level of the hierarchy.
-        // Instead we'll pass a number so large as to ensure the comment will appear last in a list.
-        commentID = @9999999;
-    }
+    uint32_t segment = comment.commentID != 0 ? (uint32_t)comment.commentID : UnsyncedCommentHierarchySegment;
+    NSMutableData *hierarchyKey = [NSMutableData dataWithData:parentComment.hierarchyKey ?: [NSData data]];
+    AppendHierarchySegment(hierarchyKey, segment);
+    comment.hierarchyKey = hierarchyKey;
 
     if (parentComment) {
-        comment.hierarchy = [NSString stringWithFormat:@"%@.%@", parentComment.hierarchy, [self formattedHierarchyElement:commentID]];
+        comment.threadRoot = parentComment.threadRoot;
         comment.depth = parentComment.depth + 1;
     } else {
-        comment.hierarchy = [self formattedHierarchyElement:commentID];
+        comment.threadRoot = comment.commentID != 0 ? comment.commentID : UnsyncedCommentThreadRoot;
         comment.depth = 0;
     }
+
+    [self updatePositionsInThreads:[NSSet setWithObject:@(comment.threadRoot)] forPost:comment.post];
 }
 
 - (void)updateHierarchicalComment:(Comment *)comment withRemoteComment:(RemoteComment *)remoteComment
@@ -1180,12 +1359,18 @@ static NSTimeInterval const CommentsRefreshTimeoutInSeconds = 60 * 5; // 5 minut
 
     NSMutableSet<NSNumber *> *visibleCommentIds = [NSMutableSet new];
     NSMutableArray *ancestors = [NSMutableArray array];
-    NSMutableArray *commentsToKeep = [NSMutableArray array];
+    NSMutableSet<NSNumber *> *commentIDsToKeep = [NSMutableSet setWithCapacity:comments.count];
+    NSMutableSet<NSNumber *> *threadRoots = [NSMutableSet set];
     NSString *entityName = NSStringFromClass([Comment class]);
     NSUInteger newCommentCount = 0;
 
+    NSPredicate *postPredicate = [NSPredicate predicateWithFormat:@"post = %@", post];
+    NSMutableDictionary<NSNumber *, Comment *> *existingComments = [self commentsForRemoteComments:comments
+                                                                                matchingPredicate:postPredicate
+                                                                                        inContext:post.managedObjectContext];
+
     for (RemoteComment *remoteComment in comments) {
-        Comment *comment = [post commentWithID:remoteComment.commentID];
+        Comment *comment = remoteComment.commentID ? existingComments[remoteComment.commentID] : nil;
         if (!comment) {
             newCommentCount++;
             comment = [NSEntityDescription insertNewObjectForEntityForName:entityName inManagedObjectContext:post.managedObjectContext];
@@ -1195,7 +1380,9 @@ static NSTimeInterval const CommentsRefreshTimeoutInSeconds = 60 * 5; // 5 minut
 
         // Calculate hierarchy and depth.
         ancestors = [self ancestorsForCommentWithParentID:[NSNumber numberWithInt:comment.parentID] andCurrentAncestors:ancestors];
-        comment.hierarchy = [self hierarchyFromAncestors:ancestors andCommentID:[NSNumber numberWithInt:comment.commentID]];
+        comment.hierarchyKey = [self hierarchyKeyFromAncestors:ancestors andCommentID:comment.commentID];
+        comment.threadRoot = ancestors.count > 0 ? [ancestors.firstObject intValue] : comment.commentID;
+        [threadRoots addObject:@(comment.threadRoot)];
 
         // Comments are shown on the thread when (1) it is approved, and (2) its ancestors are approved.
         // Having the comments sorted hierarchically ascending ensures that each comment's predecessors will be visited first.
@@ -1210,7 +1397,8 @@ static NSTimeInterval const CommentsRefreshTimeoutInSeconds = 60 * 5; // 5 minut
         comment.depth = ancestors.count;
         comment.post = post;
         comment.content = [self sanitizeCommentContent:comment.content isPrivateSite:post.isBlogPrivate];
-        [commentsToKeep addObject:comment];
+        existingComments[@(comment.commentID)] = comment;
+        [commentIDsToKeep addObject:@(comment.commentID)];
     }
 
     // Remove deleted comments
@@ -1218,26 +1406,25 @@ static NSTimeInterval const CommentsRefreshTimeoutInSeconds = 60 * 5; // 5 minut
     // cached and missing from the comments just synced. This provides for a clean slate and
     // helps avoid certain cases where some pages might not be resynced, creating gaps in the content.
     if (page == 1) {
-        [self deleteCommentsMissingFromHierarchicalComments:commentsToKeep forPost:post];
+        [self deleteCommentsMissingFromHierarchicalComments:commentIDsToKeep forPost:post];
         [self deleteUnownedCommentsInContext:post.managedObjectContext];
     }
 
+    [self updatePositionsInThreads:threadRoots forPost:post];
+
     // Make sure the post's comment count is at least the number of comments merged.
-    if ([post.commentCount integerValue] < [commentsToKeep count]) {
-        post.commentCount = @([commentsToKeep count]);
+    if ([post.commentCount integerValue] < [comments count]) {
+        post.commentCount = @([comments count]);
     }
 
     return newCommentCount > 0;
 }
 
 // Does not save context
-- (void)deleteCommentsMissingFromHierarchicalComments:(NSArray *)commentsToKeep forPost:(ReaderPost *)post
+- (void)deleteCommentsMissingFromHierarchicalComments:(NSSet<NSNumber *> *)commentIDsToKeep forPost:(ReaderPost *)post
 {
-    for (Comment *comment in post.comments) {
-        if (![commentsToKeep containsObject:comment]) {
-            [post.managedObjectContext deleteObject:comment];
-        }
-    }
+    NSPredicate *predicate = [NSPredicate predicateWithFormat:@"post = %@ AND NOT (commentID IN %@)", post, commentIDsToKeep];
+    [self batchDeleteCommentsMatchingPredicate:predicate ownedBy:post];
 }
 
 - (NSArray *)topLevelCommentsForPage:(NSUInteger)page forPost:(ReaderPost *)post
@@ -1247,7 +1434,8 @@ static NSTimeInterval const CommentsRefreshTimeoutInSeconds = 60 * 5; // 5 minut
     // Retrieve the starting and ending comments for the specified page.
     NSFetchRequest *fetchRequest = [[NSFetchRequest alloc] initWithEntityName:entityName];
     fetchRequest.predicate = [NSPredicate predicateWithFormat:@"post = %@ AND parentID = 0", post];
-    NSSortDescriptor *sortDescriptor = [NSSortDescriptor sortDescriptorWithKey:@"hierarchy" ascending:YES];
+    // A top-level comment is the root of its own thread, so this sort is backed by the thread index.
+    NSSortDescriptor *sortDescriptor = [NSSortDescriptor sortDescriptorWithKey:@"threadRoot" ascending:YES];
     fetchRequest.sortDescriptors = @[sortDescriptor];
     [fetchRequest setFetchLimit:WPTopLevelHierarchicalCommentsPerPage];
     NSUInteger offset = WPTopLevelHierarchicalCommentsPerPage * (page - 1);
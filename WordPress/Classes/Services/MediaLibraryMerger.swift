@@ -0,0 +1,144 @@
+import CoreData
+import WordPressKit
+
+/// Merges a blog's remote media library into Core Data one page at a time.
+///
+/// The merger indexes the blog's server-side media by `mediaID` with a single dictionary-result fetch,
+/// so each page is matched without fetching or faulting in the rest of the library. Merged media is
+/// turned back into faults once saved, which keeps memory flat regardless of the library size.
+@objc final class MediaLibraryMerger: NSObject {
+    private let blog: Blog
+    private let context: NSManagedObjectContext
+    private let coreDataStack: CoreDataStack
+
+    /// The media that existed before the sync, keyed by `mediaID`.
+    private var existingMediaObjectIDs: [NSNumber: NSManagedObjectID]
+
+    /// The media merged so far, keyed by `mediaID`.
+    private var mergedMediaObjectIDs: [NSNumber: NSManagedObjectID] = [:]
+
+    /// - Parameters:
+    ///   - blog: The blog whose media library is being synced.
+    ///   - coreDataStack: The stack the blog's context belongs to.
+    @objc init(blog: Blog, coreDataStack: CoreDataStack) {
+        guard let context = blog.managedObjectContext else {
+            fatalError("The `Blog` instance is not associated with an `NSManagedObjectContext`")
+        }
+        self.blog = blog
+        self.context = context
+        self.coreDataStack = coreDataStack
+        self.existingMediaObjectIDs = MediaLibraryMerger.serverMediaObjectIDs(of: blog, in: context)
+        super.init()
+    }
+
+    /// Inserts or updates the media from a page of the remote library, then saves the context.
+    ///
+    /// Items already merged by a previous call are skipped, so the complete library passed once
+    /// the sync finishes only adds the items that weren't delivered as a page.
+    @objc func merge(_ remoteMedia: [RemoteMedia]) {
+        let pendingMedia = remoteMedia.filter { remote in
+            remote.mediaID.map { mergedMediaObjectIDs[$0] == nil } ?? true
+        }
+        guard !pendingMedia.isEmpty else {
+            return
+        }
+
+        let existingMedia = fetchExistingMedia(for: pendingMedia)
+        var mergedMedia: [Media] = []
+        for remote in pendingMedia {
+            autoreleasepool {
+                let media = remote.mediaID.flatMap { existingMedia[$0] } ?? Media.makeMedia(blog: blog)
+                MediaHelper.update(media: media, with: remote)
+                mergedMedia.append(media)
+            }
+        }
+
+        let insertedMedia = mergedMedia.filter { $0.objectID.isTemporaryID }
+        if !insertedMedia.isEmpty {
+            try? context.obtainPermanentIDs(for: insertedMedia)
+        }
+        for media in mergedMedia {
+            if let mediaID = media.mediaID {
+                mergedMediaObjectIDs[mediaID] = media.objectID
+            }
+        }
+
+        coreDataStack.saveContextAndWait(context)
+
+        for media in mergedMedia where !media.hasChanges {
+            context.refresh(media, mergeChanges: false)
+        }
+    }
+
+    /// Deletes the server-side media that existed before the sync but wasn't part of the remote library.
+    ///
+    /// Media that isn't being edited is removed with a batch delete; media with unsaved changes is
+    /// deleted through the context since a batch delete can't see those changes.
+    @objc func deleteUnreferencedMedia() {
+        let unreferencedObjectIDs = existingMediaObjectIDs
+            .filter { mergedMediaObjectIDs[$0.key] == nil }
+            .map(\.value)
+
+        do {
+            try context.deleteObjects(withIDs: unreferencedObjectIDs, mergingChangesInto: coreDataStack.mainContext)
+            DDLogInfo("Deleted \(unreferencedObjectIDs.count) unreferenced Media")
+        } catch {
+            DDLogError("Error deleting unreferenced media: \(error)")
+        }
+
+        existingMediaObjectIDs = [:]
+        coreDataStack.saveContextAndWait(context)
+    }
+
+    // MARK: - Fetching
+
+    /// Fetches the existing media matching the given page in a single request.
+    private func fetchExistingMedia(for remoteMedia: [RemoteMedia]) -> [NSNumber: Media] {
+        let objectIDs = remoteMedia.compactMap { $0.mediaID.flatMap { existingMediaObjectIDs[$0] } }
+        guard !objectIDs.isEmpty else {
+            return [:]
+        }
+
+        let request = NSFetchRequest<Media>(entityName: Media.entityName())
+        request.predicate = NSPredicate(format: "SELF IN %@", objectIDs)
+        request.returnsObjectsAsFaults = false
+        let media = (try? context.fetch(request)) ?? []
+        return media.reduce(into: [:]) { result, media in
+            if let mediaID = media.mediaID {
+                result[mediaID] = media
+            }
+        }
+    }
+
+    /// Returns the `objectID` of each server-side media item of the blog, keyed by `mediaID`,
+    /// without materializing any `Media` objects.
+    ///
+    /// Dictionary results only reflect the store, so unsaved media in the context is added on top.
+    private static func serverMediaObjectIDs(of blog: Blog, in context: NSManagedObjectContext) -> [NSNumber: NSManagedObjectID] {
+        let objectIDExpression = NSExpressionDescription()
+        objectIDExpression.name = "objectID"
+        objectIDExpression.expression = NSExpression.expressionForEvaluatedObject()
+        objectIDExpression.expressionResultType = .objectIDAttributeType
+
+        let request = NSFetchRequest<NSDictionary>(entityName: Media.entityName())
+        request.predicate = NSPredicate(format: "blog = %@ AND mediaID > 0", blog)
+        request.resultType = .dictionaryResultType
+        request.propertiesToFetch = [#keyPath(Media.mediaID), objectIDExpression]
+
+        let rows = (try? context.fetch(request)) ?? []
+        var objectIDs: [NSNumber: NSManagedObjectID] = rows.reduce(into: [:]) { result, row in
+            if let mediaID = row[#keyPath(Media.mediaID)] as? NSNumber,
+               let objectID = row["objectID"] as? NSManagedObjectID {
+                result[mediaID] = objectID
+            }
+        }
+
+        let pendingMedia = context.insertedObjects.union(context.updatedObjects).compactMap { $0 as? Media }
+        for media in pendingMedia where media.blog == blog {
+            if let mediaID = media.mediaID, mediaID.intValue > 0 {
+                objectIDs[mediaID] = media.objectID
+            }
+        }
+        return objectIDs
+    }
+}
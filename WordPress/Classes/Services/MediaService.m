@@ -439,21 +439,26 @@ NSErrorDomain const MediaServiceErrorDomain = @"MediaServiceErrorDomain";
             return;
         }
 
-        NSSet *originalLocalMedia = blogInContext.media;
+        MediaLibraryMerger *merger = [[MediaLibraryMerger alloc] initWithBlog:blogInContext coreDataStack:[ContextManager sharedInstance]];
         id<MediaServiceRemote> remote = [self remoteForBlog:blogInContext];
         [remote getMediaLibraryWithPageLoad:^(NSArray *media) {
                                     [self.managedObjectContext performBlock:^{
-                                        void (^completion)(void) = nil;
+                                        [merger merge:media];
                                         if (!onePageLoad) {
                                             onePageLoad = YES;
-                                            completion = success;
+                                            if (success) {
+                                                success();
+                                            }
                                         }
-                                        [self mergeMedia:media forBlog:blogInContext baseMedia:originalLocalMedia deleteUnreferencedMedia:NO completionHandler:completion];
                                     }];
                                 }
                                success:^(NSArray *media) {
                                    [self.managedObjectContext performBlock:^{
-                                       [self mergeMedia:media forBlog:blogInContext baseMedia:originalLocalMedia deleteUnreferencedMedia:YES completionHandler:success];
+                                       [merger merge:media];
+                                       [merger deleteUnreferencedMedia];
+                                       if (success) {
+                                           success();
+                                       }
                                    }];
                                }
                                failure:^(NSError *error) {
@@ -491,41 +496,6 @@ NSErrorDomain const MediaServiceErrorDomain = @"MediaServiceErrorDomain";
     return remote;
 }
 
-- (void)mergeMedia:(NSArray *)media
-           forBlog:(Blog *)blog
-         baseMedia:(NSSet *)originalBlogMedia
-deleteUnreferencedMedia:(BOOL)deleteUnreferencedMedia
- completionHandler:(void (^)(void))completion
-{
-    NSParameterAssert(blog);
-    NSParameterAssert(media);
-    NSMutableSet *mediaToKeep = [NSMutableSet set];
-    for (RemoteMedia *remote in media) {
-        @autoreleasepool {
-            Media *local = [Media existingMediaWithMediaID:remote.mediaID inBlog:blog];
-            if (!local) {
-                local = [Media makeMediaWithBlog:blog];
-            }
-            [MediaHelper updateMedia:local withRemoteMedia:remote];
-            [mediaToKeep addObject:local];
-        }
-    }
-    if (deleteUnreferencedMedia) {
-        NSMutableSet *mediaToDelete = [NSMutableSet setWithSet:originalBlogMedia];
-        [mediaToDelete minusSet:mediaToKeep];
-        for (Media *deleteMedia in mediaToDelete) {
-            // only delete media that is server based
-            if ([deleteMedia.mediaID intValue] > 0) {
-                [self.managedObjectContext deleteObject:deleteMedia];
-            }
-        }
-    }
-    [[ContextManager sharedInstance] saveContext:self.managedObjectContext];
-    if (completion) {
-        completion();
-    }
-}
-
 - (RemoteMedia *)remoteMediaFromMedia:(Media *)media fieldsToUpdate:(NSArray<NSString *> *)fieldsToUpdate
 {
     RemoteMedia *remoteMedia = [[RemoteMedia alloc] init];
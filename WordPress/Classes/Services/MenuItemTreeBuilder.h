@@ -0,0 +1,41 @@
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class MenuItem;
+@class RemoteMenuItem;
+
+/**
+ *  @brief      Converts between the flat, ordered list of MenuItems of a Menu and the nested
+ *              RemoteMenuItem tree used by the API, in time linear to the number of items.
+ */
+@interface MenuItemTreeBuilder : NSObject
+
+/**
+ *  @brief      Builds the RemoteMenuItem tree of the items.
+ *  @details    Items are grouped by parent in a single pass, so each item is visited a constant number
+ *              of times regardless of the size or depth of the menu. Siblings keep their order in `items`.
+ *              Items whose parent isn't part of `items` are left out, along with their descendants.
+ *
+ *  @param      items       The ordered items of a menu.
+ *  @param      factory     Creates the RemoteMenuItem for an item, without its children.
+ *
+ *  @returns    The RemoteMenuItems of the top-level items, with their descendants set as children.
+ */
++ (NSArray<RemoteMenuItem *> *)remoteItemTreeFromMenuItems:(NSOrderedSet<MenuItem *> *)items
+                                          remoteItemFactory:(RemoteMenuItem * (^)(MenuItem *item))factory;
+
+/**
+ *  @brief      Visits a RemoteMenuItem tree in pre-order, which is the order items are listed in a menu.
+ *  @details    Parents are always visited before their children. The traversal doesn't recurse,
+ *              so deeply nested menus can't overflow the stack.
+ *
+ *  @param      remoteItems The top-level RemoteMenuItems.
+ *  @param      block       Called for each item with its parent, or nil for top-level items.
+ */
++ (void)enumerateRemoteItemTree:(NSArray<RemoteMenuItem *> *)remoteItems
+                     usingBlock:(void (^)(RemoteMenuItem *remoteItem, RemoteMenuItem * _Nullable parent))block;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,71 @@
+#import "MenuItemTreeBuilder.h"
+#import "MenuItem.h"
+@import WordPressKit;
+
+@implementation MenuItemTreeBuilder
+
++ (NSArray<RemoteMenuItem *> *)remoteItemTreeFromMenuItems:(NSOrderedSet<MenuItem *> *)items
+                                          remoteItemFactory:(RemoteMenuItem * (^)(MenuItem *item))factory
+{
+    NSMapTable<MenuItem *, RemoteMenuItem *> *remoteItemsByItem = [self identityMapTable];
+    for (MenuItem *item in items) {
+        [remoteItemsByItem setObject:factory(item) forKey:item];
+    }
+
+    NSMutableArray<RemoteMenuItem *> *topLevelItems = [NSMutableArray array];
+    NSMapTable<MenuItem *, NSMutableArray<RemoteMenuItem *> *> *childrenByParent = [self identityMapTable];
+    for (MenuItem *item in items) {
+        RemoteMenuItem *remoteItem = [remoteItemsByItem objectForKey:item];
+        MenuItem *parent = item.parent;
+        if (!parent) {
+            [topLevelItems addObject:remoteItem];
+            continue;
+        }
+        NSMutableArray<RemoteMenuItem *> *siblings = [childrenByParent objectForKey:parent];
+        if (!siblings) {
+            siblings = [NSMutableArray array];
+            [childrenByParent setObject:siblings forKey:parent];
+        }
+        [siblings addObject:remoteItem];
+    }
+
+    for (MenuItem *parent in childrenByParent) {
+        RemoteMenuItem *remoteParent = [remoteItemsByItem objectForKey:parent];
+        remoteParent.children = [[childrenByParent objectForKey:parent] copy];
+    }
+
+    return [topLevelItems copy];
+}
+
++ (void)enumerateRemoteItemTree:(NSArray<RemoteMenuItem *> *)remoteItems
+                     usingBlock:(void (^)(RemoteMenuItem *remoteItem, RemoteMenuItem * _Nullable parent))block
+{
+    // Each entry is a pair of an item and its parent (NSNull for top-level items).
+    // Siblings are pushed in reverse so they're popped in their original order.
+    NSMutableArray<NSArray *> *stack = [NSMutableArray arrayWithCapacity:remoteItems.count];
+    for (RemoteMenuItem *remoteItem in remoteItems.reverseObjectEnumerator) {
+        [stack addObject:@[remoteItem, [NSNull null]]];
+    }
+
+    while (stack.count) {
+        NSArray *entry = stack.lastObject;
+        [stack removeLastObject];
+
+        RemoteMenuItem *remoteItem = entry.firstObject;
+        RemoteMenuItem *parent = entry.lastObject == [NSNull null] ? nil : entry.lastObject;
+        block(remoteItem, parent);
+
+        for (RemoteMenuItem *child in remoteItem.children.reverseObjectEnumerator) {
+            [stack addObject:@[child, remoteItem]];
+        }
+    }
+}
+
++ (NSMapTable *)identityMapTable
+{
+    // Managed objects and remote items are keyed by identity, not by their (mutable) contents.
+    return [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality
+                                 valueOptions:NSPointerFunctionsStrongMemory];
+}
+
+@end
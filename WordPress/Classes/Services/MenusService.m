@@ -3,6 +3,7 @@
 #import "Blog.h"
 #import "Menu.h"
 #import "MenuItem.h"
+#import "MenuItemTreeBuilder.h"
 #import "MenuLocation.h"
 #import "PostService.h"
 #ifdef KEYSTONE
@@ -233,9 +234,7 @@
                              which items are equal to one another, especially when a menuID is unknown.
                              */
                             menu.items = nil;
-                            for (RemoteMenuItem *remoteItem in remoteMenu.items) {
-                                [self addMenuItemFromRemoteMenuItem:remoteItem forMenu:menu];
-                            }
+                            [self addMenuItemsFromRemoteMenuItems:remoteMenu.items forMenu:menu];
                             [[ContextManager sharedInstance] saveContext:self.managedObjectContext
                                                      withCompletionBlock:success
                                                                  onQueue:dispatch_get_main_queue()];
@@ -260,16 +259,40 @@
     menu.name = remoteMenu.name;
     menu.details = remoteMenu.details;
     menu.menuID = remoteMenu.menuID;
-    for (RemoteMenuItem *remoteItem in remoteMenu.items) {
-        [self addMenuItemFromRemoteMenuItem:remoteItem forMenu:menu];
-    }
+    [self addMenuItemsFromRemoteMenuItems:remoteMenu.items forMenu:menu];
     
     return menu;
 }
 
 #pragma mark - MenuItem managed objects via RemoteMenuItem objects
 
-- (MenuItem *)addMenuItemFromRemoteMenuItem:(RemoteMenuItem *)remoteMenuItem forMenu:(Menu *)menu
+- (void)addMenuItemsFromRemoteMenuItems:(nullable NSArray<RemoteMenuItem *> *)remoteMenuItems forMenu:(Menu *)menu
+{
+    if (!remoteMenuItems.count) {
+        return;
+    }
+
+    // Walk the tree in menu order, then relate all the items to the menu at once
+    // instead of appending to the ordered relationship one item at a time.
+    NSMutableOrderedSet<MenuItem *> *items = [NSMutableOrderedSet orderedSet];
+    NSMapTable<RemoteMenuItem *, MenuItem *> *itemsByRemoteItem = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality
+                                                                                         valueOptions:NSPointerFunctionsStrongMemory];
+    [MenuItemTreeBuilder enumerateRemoteItemTree:remoteMenuItems usingBlock:^(RemoteMenuItem *remoteItem, RemoteMenuItem *remoteParent) {
+        MenuItem *item = [self menuItemFromRemoteMenuItem:remoteItem];
+        if (remoteParent) {
+            item.parent = [itemsByRemoteItem objectForKey:remoteParent];
+        }
+        [itemsByRemoteItem setObject:item forKey:remoteItem];
+        [items addObject:item];
+    }];
+
+    if (menu.items.count) {
+        [items insertObjects:menu.items.array atIndexes:[NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, menu.items.count)]];
+    }
+    menu.items = items;
+}
+
+- (MenuItem *)menuItemFromRemoteMenuItem:(RemoteMenuItem *)remoteMenuItem
 {
     NSEntityDescription *entityDescription = [NSEntityDescription entityForName:[MenuItem entityName]
                                                          inManagedObjectContext:self.managedObjectContext];
@@ -285,16 +308,8 @@
     item.typeFamily = remoteMenuItem.typeFamily;
     item.typeLabel = remoteMenuItem.typeLabel;
     item.urlStr = remoteMenuItem.urlStr;
-    item.menu = menu;
     item.classes = remoteMenuItem.classes;
 
-    if (remoteMenuItem.children) {
-        for (RemoteMenuItem *childRemoteItem in remoteMenuItem.children) {
-            MenuItem *childItem = [self addMenuItemFromRemoteMenuItem:childRemoteItem forMenu:menu];
-            childItem.parent = item;
-        }
-    }
-    
     return item;
 }
 
@@ -347,21 +362,13 @@
 
 - (NSArray *)remoteItemsFromMenuItems:(NSOrderedSet<MenuItem *> *)menuItems
 {
-    NSMutableArray *remoteItems = [NSMutableArray arrayWithCapacity:menuItems.count];
-    for (MenuItem *item in menuItems) {
-        // Only add top-level items since MenuItem keeps all associated items under it's children relationship.
-        if (item.parent) {
-            continue;
-        }
-        // Children of item will be added as remoteItem.children.
-        RemoteMenuItem *remoteItem = [self remoteItemFromItem:item withItems:menuItems];
-        [remoteItems addObject:remoteItem];
-    }
-    
-    return [NSArray arrayWithArray:remoteItems];
+    // Only top-level items are returned, their descendants are nested as remoteItem.children.
+    return [MenuItemTreeBuilder remoteItemTreeFromMenuItems:menuItems remoteItemFactory:^RemoteMenuItem *(MenuItem *item) {
+        return [self remoteItemFromItem:item];
+    }];
 }
 
-- (RemoteMenuItem *)remoteItemFromItem:(MenuItem *)item withItems:(NSOrderedSet<MenuItem *> *)items
+- (RemoteMenuItem *)remoteItemFromItem:(MenuItem *)item
 {
     RemoteMenuItem *remoteItem = [[RemoteMenuItem alloc] init];
     remoteItem.itemID = item.itemID;
@@ -392,20 +399,6 @@
     remoteItem.typeLabel = item.typeLabel;
     remoteItem.urlStr = item.urlStr;
     
-    if (item.children.count) {
-        // Find the children of the item and them to remoteItem.children.
-        NSMutableArray *children = [NSMutableArray arrayWithCapacity:item.children.count];
-        for (MenuItem *anItem in items) {
-            if (!anItem.parent) {
-                continue;
-            }
-            if (anItem.parent == item) {
-                [children addObject:[self remoteItemFromItem:anItem withItems:items]];
-            }
-            remoteItem.children = children;
-        }
-    }
-    
     return remoteItem;
 }
 
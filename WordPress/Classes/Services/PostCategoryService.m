@@ -10,6 +10,8 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+static NSString *const BlogMetadataEndpointCategories = @"categories";
+
 @implementation PostCategoryService
 
 - (instancetype)initWithCoreDataStack:(id<CoreDataStack>)coreDataStack
@@ -34,8 +36,20 @@ NS_ASSUME_NONNULL_BEGIN
     id<TaxonomyServiceRemote> remote = [self remoteForBlog:blog];
     NSManagedObjectID *blogID = blog.objectID;
     [remote getCategoriesWithSuccess:^(NSArray *categories) {
+                               BlogMetadataFreshness *freshness = [BlogMetadataFreshness shared];
+                               NSData *fingerprint = [freshness fingerprintForCategories:categories];
+                               if ([freshness isFingerprint:fingerprint mergedForEndpoint:BlogMetadataEndpointCategories blogID:blogID]) {
+                                   dispatch_async(dispatch_get_main_queue(), ^{
+                                       if (success) {
+                                           success();
+                                       }
+                                   });
+                                   return;
+                               }
+
                                NSError * __block error = nil;
                                [self.coreDataStack performAndSaveUsingBlock:^(NSManagedObjectContext *context) {
+                                   context.name = BlogMetadataFreshness.mergeContextName;
                                    Blog *blog = (Blog *)[context existingObjectWithID:blogID error:nil];
                                    if (!blog) {
                                        error = [self serviceErrorNoBlog];
@@ -48,6 +62,7 @@ NS_ASSUME_NONNULL_BEGIN
                                            failure(error);
                                        }
                                    } else {
+                                       [freshness recordFingerprint:fingerprint forEndpoint:BlogMetadataEndpointCategories blogID:blogID];
                                        if (success) {
                                            success();
                                        }
@@ -1,6 +1,7 @@
 #import <Foundation/Foundation.h>
 #import <CoreData/CoreData.h>
 #import "PostService.h"
+#import "CoreDataStack.h"
 
 @class AbstractPost, RemotePost;
 
@@ -19,7 +20,8 @@ NS_ASSUME_NONNULL_BEGIN
                byAuthor:(nullable NSNumber *)authorID
                 forBlog:(Blog *)blog
           purgeExisting:(BOOL)purge
-              inContext:(NSManagedObjectContext *)context;
+              inContext:(NSManagedObjectContext *)context
+          coreDataStack:(id<CoreDataStack>)coreDataStack;
 
 @end
 
@@ -177,14 +177,30 @@
                 forBlog:(Blog *)blog
           purgeExisting:(BOOL)purge
               inContext:(NSManagedObjectContext *)context
+          coreDataStack:(id<CoreDataStack>)coreDataStack
 {
+    NSMutableArray<NSNumber *> *postIDs = [NSMutableArray arrayWithCapacity:remotePosts.count];
+    NSMutableArray<NSUUID *> *foreignIDs = [NSMutableArray array];
+    for (RemotePost *remotePost in remotePosts) {
+        if (remotePost.postID != nil) {
+            [postIDs addObject:remotePost.postID];
+        }
+    }
+    NSMutableDictionary<NSNumber *, AbstractPost *> *postsByID = [[blog lookupPostsWithIDs:postIDs inContext:context] mutableCopy];
+    for (RemotePost *remotePost in remotePosts) {
+        if ((remotePost.postID == nil || postsByID[remotePost.postID] == nil) && remotePost.foreignID != nil) {
+            [foreignIDs addObject:remotePost.foreignID];
+        }
+    }
+    NSDictionary<NSUUID *, AbstractPost *> *postsByForeignID = [blog lookupPostsWithForeignIDs:foreignIDs inContext:context];
+
     NSMutableArray *posts = [NSMutableArray arrayWithCapacity:remotePosts.count];
     for (RemotePost *remotePost in remotePosts) {
-        AbstractPost *post = [blog lookupPostWithID:remotePost.postID inContext:context];
+        AbstractPost *post = remotePost.postID ? postsByID[remotePost.postID] : nil;
         if (post == nil) {
             NSUUID *foreignID = remotePost.foreignID;
             if (foreignID != nil) {
-                post = [blog lookupPostWithForeignID:foreignID inContext:context];
+                post = postsByForeignID[foreignID];
             }
         }
         if (!post) {
@@ -196,6 +212,10 @@
                 post = [blog createPost];
             }
         }
+        if (remotePost.postID != nil) {
+            // Later duplicates of the same post in this batch should update it rather than create another one.
+            postsByID[remotePost.postID] = post;
+        }
         [PostHelper updatePost:post withRemotePost:remotePost inContext:context];
         [posts addObject:post];
     }
@@ -227,19 +247,18 @@
             predicate = [NSCompoundPredicate andPredicateWithSubpredicates:@[predicate, postTypePredicate]];
         }
         request.predicate = predicate;
+        request.resultType = NSManagedObjectIDResultType;
 
         NSError *error;
-        NSArray *existingPosts = [context executeFetchRequest:request error:&error];
+        NSArray<NSManagedObjectID *> *existingPostIDs = [context executeFetchRequest:request error:&error];
         if (error) {
             DDLogError(@"Error fetching existing posts for purging: %@", error);
         } else {
-            NSSet *postsToKeep = [NSSet setWithArray:posts];
-            NSMutableSet *postsToDelete = [NSMutableSet setWithArray:existingPosts];
-            // Delete the posts not being updated.
-            [postsToDelete minusSet:postsToKeep];
-            for (AbstractPost *post in postsToDelete) {
-                DDLogInfo(@"Deleting Post: %@", post);
-                [context deleteObject:post];
+            NSMutableSet<NSManagedObjectID *> *postIDsToDelete = [NSMutableSet setWithArray:existingPostIDs];
+            // Delete the posts not being updated, without materializing them.
+            [postIDsToDelete minusSet:[NSSet setWithArray:[posts valueForKey:@"objectID"]]];
+            if (![context deleteObjectsWithIDs:postIDsToDelete.allObjects mergingChangesIntoMainContext:coreDataStack.mainContext error:&error]) {
+                DDLogError(@"Error purging posts: %@", error);
             }
         }
     }
@@ -108,7 +108,8 @@ const NSUInteger PostServiceDefaultNumberToSync = 40;
                                                byAuthor:options.authorID
                                                 forBlog:blogInContext
                                           purgeExisting:options.purgesLocalSync
-                                              inContext:self.managedObjectContext];
+                                              inContext:self.managedObjectContext
+                                          coreDataStack:[ContextManager sharedInstance]];
 
                 [[ContextManager sharedInstance] saveContext:self.managedObjectContext withCompletionBlock:^{
                     // Call the completion block after context is saved. The callback is called on the context queue because `posts`
@@ -179,19 +179,32 @@ extern NSString * const ReaderPostServiceToggleSiteFollowingState;
 /**
  Delete all `ReaderPosts` beyond the max number to be retained.
 
- The managed object context is not saved.
-
  @param topic the `ReaderAbstractTopic` to delete posts from.
  */
 - (void)deletePostsInExcessOfMaxAllowedForTopic:(ReaderAbstractTopic *)topic;
 
 /**
- Delete posts that are flagged as belonging to a blocked site.
+ Delete all `ReaderPosts` beyond the max number to be retained.
+
+ Pending changes in the context are taken into account. The context is not saved.
+
+ @param topic the `ReaderAbstractTopic` to delete posts from.
+ @param context the context `topic` belongs to.
+ */
+- (void)deletePostsInExcessOfMaxAllowedForTopic:(ReaderAbstractTopic *)topic inContext:(NSManagedObjectContext *)context;
 
- The managed object context is not saved.
+/**
+ Delete posts that are flagged as belonging to a blocked site.
  */
 - (void)deletePostsFromBlockedSites;
 
+/**
+ Delete posts that are flagged as belonging to a blocked site.
+
+ Pending changes in the context are taken into account. The context is not saved.
+ */
+- (void)deletePostsFromBlockedSitesInContext:(NSManagedObjectContext *)context;
+
 #pragma mark - Merging and Deletion
 
 /**
@@ -27,6 +27,9 @@ NSString * const ReaderPostServiceErrorDomain = @"ReaderPostServiceErrorDomain";
 NSString * const ReaderPostServiceToggleSiteFollowingState = @"ReaderPostServiceToggleSiteFollowingState";
 
 static NSString * const ReaderPostGlobalIDKey = @"globalID";
+static NSString * const ReaderPostObjectIDKey = @"objectID";
+static NSString * const ReaderPostInUseKey = @"inUse";
+static NSString * const ReaderPostIsSavedForLaterKey = @"isSavedForLater";
 
 @implementation ReaderPostService
 
@@ -719,11 +722,42 @@ static NSString * const ReaderPostGlobalIDKey = @"globalID";
           forTopic:(NSManagedObjectID *)topicObjectID
    deletingEarlier:(BOOL)deleteEarlier
     callingSuccess:(void (^)(NSInteger count, BOOL hasMore))success
+{
+    // Sanitize the content of every post concurrently before entering the context.
+    // The merge then reads the sanitized content back from the formatter's cache.
+    [RichContentFormatter prepareReaderPostContents:[self contentsOfRemotePosts:remotePosts] completion:^{
+        [self mergePreparedPosts:remotePosts
+                  rankedLessThan:rank
+                        forTopic:topicObjectID
+                 deletingEarlier:deleteEarlier
+                  callingSuccess:success];
+    }];
+}
+
+- (NSDictionary<NSString *, NSString *> *)contentsOfRemotePosts:(NSArray<RemoteReaderPost *> *)remotePosts
+{
+    NSMutableDictionary<NSString *, NSString *> *contents = [NSMutableDictionary dictionaryWithCapacity:remotePosts.count];
+    for (RemoteReaderPost *remotePost in remotePosts) {
+        if (remotePost.globalID && remotePost.content.length > 0) {
+            contents[remotePost.globalID] = remotePost.content;
+        }
+    }
+    return contents;
+}
+
+- (void)mergePreparedPosts:(NSArray *)remotePosts
+            rankedLessThan:(NSNumber *)rank
+                  forTopic:(NSManagedObjectID *)topicObjectID
+           deletingEarlier:(BOOL)deleteEarlier
+            callingSuccess:(void (^)(NSInteger count, BOOL hasMore))success
 {
     NSUInteger __block postsCount = 0;
     BOOL __block hasMore = NO;
 
     [self.coreDataStack performAndSaveUsingBlock:^(NSManagedObjectContext *context) {
+        // Posts ranked below this are deleted once the merged posts are saved.
+        NSNumber *evictionRank = nil;
+
         NSError *error;
         ReaderAbstractTopic *readerTopic = (ReaderAbstractTopic *)[context existingObjectWithID:topicObjectID error:&error];
         if (error || !readerTopic) {
@@ -736,15 +770,21 @@ static NSString * const ReaderPostGlobalIDKey = @"globalID";
 
         postsCount = [remotePosts count];
         if (postsCount == 0) {
-            [self deletePostsRankedLessThan:rank forTopic:readerTopic inContext:context];
+            evictionRank = rank;
         } else {
             NSArray *posts = remotePosts;
             BOOL overlap = NO;
 
+            // Look up the cached copies of the synced posts once.
+            // Overlap detection and the upsert below share the same map.
+            NSMutableDictionary<NSString *, ReaderPost *> *existingPosts = [ReaderPost postsForRemotePosts:posts
+                                                                                                  forTopic:readerTopic
+                                                                                                   context:context];
+
             if (!deleteEarlier) {
                 // Before processing the new posts, check if there is an overlap between
                 // what is currently cached, and what is being synced.
-                overlap = [self checkIfRemotePosts:posts overlapExistingPostsinTopic:readerTopic inContext:context];
+                overlap = [self checkIfRemotePosts:posts overlapExistingPosts:existingPosts inTopic:readerTopic];
 
                 // A strategy to avoid false positives in gap detection is to sync
                 // one extra post. Only remove the extra post if we received a
@@ -758,7 +798,7 @@ static NSString * const ReaderPostGlobalIDKey = @"globalID";
             }
 
             // Create or update the synced posts.
-            NSMutableArray *newPosts = [self makeNewPostsFromRemotePosts:posts forTopic:readerTopic inContext:context];
+            NSMutableArray *newPosts = [self makeNewPostsFromRemotePosts:posts forTopic:readerTopic existingPosts:existingPosts inContext:context];
 
             // When refreshing, some content previously synced may have been deleted remotely.
             // Remove anything we've synced that is missing.
@@ -768,7 +808,7 @@ static NSString * const ReaderPostGlobalIDKey = @"globalID";
             // If deleting earlier, delete every post older than the last post in this batch.
             if (deleteEarlier) {
                 ReaderPost *lastPost = [newPosts lastObject];
-                [self deletePostsRankedLessThan:lastPost.sortRank forTopic:readerTopic inContext:context];
+                evictionRank = lastPost.sortRank;
                 [self removeGapMarkerForTopic:readerTopic inContext:context]; // Paranoia
 
             } else {
@@ -790,6 +830,10 @@ static NSString * const ReaderPostGlobalIDKey = @"globalID";
         }
 
         // Clean up
+        // The eviction takes the pending merged posts into account, so the whole merge is saved once.
+        if (evictionRank) {
+            [self deletePostsRankedLessThan:evictionRank forTopic:readerTopic inContext:context];
+        }
         [self deletePostsInExcessOfMaxAllowedForTopic:readerTopic inContext:context];
         [self deletePostsFromBlockedSitesInContext:context];
 
@@ -802,32 +846,19 @@ static NSString * const ReaderPostGlobalIDKey = @"globalID";
     } onQueue:dispatch_get_main_queue()];
 }
 
-- (BOOL)checkIfRemotePosts:(NSArray *)remotePosts overlapExistingPostsinTopic:(ReaderAbstractTopic *)readerTopic inContext:(NSManagedObjectContext *)context
+- (BOOL)checkIfRemotePosts:(NSArray *)remotePosts
+      overlapExistingPosts:(NSDictionary<NSString *, ReaderPost *> *)existingPosts
+                   inTopic:(ReaderAbstractTopic *)readerTopic
 {
-    // Get global IDs of new posts to use as part of the predicate.
-    NSSet *remoteGlobalIDs = [self globalIDsOfRemotePosts:remotePosts];
-
-    // Fetch matching existing posts.
-    NSFetchRequest *fetchRequest = [NSFetchRequest fetchRequestWithEntityName:NSStringFromClass([ReaderPost class])];
-    fetchRequest.predicate = [NSPredicate predicateWithFormat:@"topic = %@ AND globalID in %@", readerTopic, remoteGlobalIDs];
-
-    NSError *error;
-    NSArray *results = [context executeFetchRequest:fetchRequest error:&error];
-    if (error) {
-        DDLogError(error.localizedDescription);
-        return NO;
-    }
-
-    // For each match, check that the dates are the same.  If at least one date is the same then there is an overlap so return true.
+    // For each cached post in the topic, check that the dates are the same.  If at least one date is the same then there is an overlap so return true.
     // If the dates are different then the existing cached post will be updated. Don't treat this as overlap.
-    for (ReaderPost *post in results) {
-        for (RemoteReaderPost *remotePost in remotePosts) {
-            if (![remotePost.globalID isEqualToString:post.globalID]) {
-                continue;
-            }
-            if ([post.sortDate isEqualToDate:remotePost.sortDate]) {
-                return YES;
-            }
+    for (RemoteReaderPost *remotePost in remotePosts) {
+        ReaderPost *post = remotePost.globalID ? existingPosts[remotePost.globalID] : nil;
+        if (post.topic != readerTopic) {
+            continue;
+        }
+        if ([post.sortDate isEqualToDate:remotePost.sortDate]) {
+            return YES;
         }
     }
 
@@ -845,8 +876,9 @@ static NSString * const ReaderPostGlobalIDKey = @"globalID";
         double gapRank = [gapMarker.sortRank doubleValue];
         // Confirm the overlap includes the gap marker.
         if (lowestRank < gapRank && gapRank < highestRank) {
-            // No need for a gap placeholder. Remove any that existed
-            [self removeGapMarkerForTopic:topic inContext:context];
+            // No need for a gap placeholder. Remove the one that existed
+            DDLogInfo(@"Deleting Gap Marker: %@", gapMarker);
+            [context deleteObject:gapMarker];
         }
     }
 }
@@ -913,6 +945,8 @@ static NSString * const ReaderPostGlobalIDKey = @"globalID";
 {
     NSFetchRequest *fetchRequest = [NSFetchRequest fetchRequestWithEntityName:NSStringFromClass([ReaderPost class])];
     fetchRequest.predicate = [NSPredicate predicateWithFormat:@"topic = %@ AND sortRank < %@", topic, rank];
+    // Only existence matters, so stop counting at the first match.
+    fetchRequest.fetchLimit = 1;
 
     NSError *error;
     NSInteger count = [context countForFetchRequest:fetchRequest error:&error];
@@ -923,16 +957,6 @@ static NSString * const ReaderPostGlobalIDKey = @"globalID";
     return (count > 0);
 }
 
-- (NSSet *)globalIDsOfRemotePosts:(NSArray *)remotePosts
-{
-    NSMutableArray *arr = [NSMutableArray array];
-    for (RemoteReaderPost *post in remotePosts) {
-        [arr addObject:post.globalID];
-    }
-    // return non-mutable array
-    return [NSSet setWithArray:arr];
-}
-
 
 #pragma mark Deletion and Clean up
 
@@ -947,30 +971,12 @@ static NSString * const ReaderPostGlobalIDKey = @"globalID";
 - (void)deletePostsRankedLessThan:(NSNumber *)rank forTopic:(ReaderAbstractTopic *)topic inContext:(NSManagedObjectContext *)context
 {
     // Don't trust the relationships on the topic to be current or correct.
-    NSError *error;
     NSFetchRequest *fetchRequest = [[NSFetchRequest alloc] initWithEntityName:@"ReaderPost"];
+    fetchRequest.predicate = [NSPredicate predicateWithFormat:@"topic = %@ AND sortRank < %@", topic, rank];
 
-    NSPredicate *pred = [NSPredicate predicateWithFormat:@"topic = %@ AND sortRank < %@", topic, rank];
-    [fetchRequest setPredicate:pred];
-
-    NSSortDescriptor *sortDescriptor = [NSSortDescriptor sortDescriptorWithKey:@"sortRank" ascending:NO];
-    [fetchRequest setSortDescriptors:@[sortDescriptor]];
-
-    NSArray *currentPosts = [context executeFetchRequest:fetchRequest error:&error];
-    if (error) {
-        DDLogError(@"%@ error fetching posts: %@", NSStringFromSelector(_cmd), error);
-        return;
-    }
-
-    for (ReaderPost *post in currentPosts) {
-        if (post.isSavedForLater) {
-            // If the missing post is currently being used or has been saved, just remove its topic.
-            post.topic = nil;
-        } else {
-            DDLogInfo(@"Deleting ReaderPost: %@", post);
-            [context deleteObject:post];
-        }
-    }
+    NSArray<NSDictionary *> *posts = [self evictionCandidatesForFetchRequest:fetchRequest inContext:context];
+    // Only saved posts are kept here. Posts that are merely in use are deleted.
+    [self evictPosts:posts keepingInUsePosts:NO inContext:context];
 }
 
 /**
@@ -1011,8 +1017,9 @@ static NSString * const ReaderPostGlobalIDKey = @"globalID";
         return;
     }
 
+    NSSet *batch = [NSSet setWithArray:posts];
     for (ReaderPost *post in currentPosts) {
-        if ([posts containsObject:post]) {
+        if ([batch containsObject:post]) {
             continue;
         }
         // The post was missing from the batch and needs to be cleaned up.
@@ -1042,48 +1049,34 @@ static NSString * const ReaderPostGlobalIDKey = @"globalID";
 
 - (void)deletePostsInExcessOfMaxAllowedForTopic:(ReaderAbstractTopic *)topic inContext:(NSManagedObjectContext *)context
 {
-    // Don't trust the relationships on the topic to be current or correct.
-    NSError *error;
-    NSFetchRequest *fetchRequest = [[NSFetchRequest alloc] initWithEntityName:@"ReaderPost"];
-
-    NSPredicate *pred = [NSPredicate predicateWithFormat:@"topic = %@", topic];
-    [fetchRequest setPredicate:pred];
-
-    NSSortDescriptor *sortDescriptor = [NSSortDescriptor sortDescriptorWithKey:@"sortRank" ascending:NO];
-    [fetchRequest setSortDescriptors:@[sortDescriptor]];
-
     NSUInteger maxPosts = [self maxPostsToSaveForTopic:topic];
-
-    // Specifying a fetchOffset to just get the posts in range doesn't seem to work very well.
-    // Just perform the fetch and remove the excess.
-    NSUInteger count = [context countForFetchRequest:fetchRequest error:&error];
-    if (count <= maxPosts) {
+    if (maxPosts == 0) {
         return;
     }
 
-    NSArray *posts = [context executeFetchRequest:fetchRequest error:&error];
-    if (error) {
-        DDLogError(@"%@ error fetching posts: %@", NSStringFromSelector(_cmd), error);
+    // Don't trust the relationships on the topic to be current or correct.
+    NSFetchRequest *fetchRequest = [[NSFetchRequest alloc] initWithEntityName:@"ReaderPost"];
+    fetchRequest.predicate = [NSPredicate predicateWithFormat:@"topic = %@", topic];
+    fetchRequest.sortDescriptors = @[[NSSortDescriptor sortDescriptorWithKey:@"sortRank" ascending:NO]];
+    // Start at the last post to keep, so the excess is everything after it. The candidates are
+    // fetched straight from the store, which is where the offset is reliable.
+    fetchRequest.fetchOffset = maxPosts - 1;
+
+    NSArray<NSDictionary *> *posts = [self evictionCandidatesForFetchRequest:fetchRequest inContext:context];
+    if (posts.count <= 1) {
         return;
     }
 
-    NSRange range = NSMakeRange(maxPosts, [posts count] - maxPosts);
-    NSArray *postsToDelete = [posts subarrayWithRange:range];
-    for (ReaderPost *post in postsToDelete) {
-        if ([self topicShouldBeClearedFor:post]) {
-            post.topic = nil;
-        } else {
-            DDLogInfo(@"Deleting ReaderPost: %@", post.postTitle);
-            [context deleteObject:post];
-        }
-    }
+    NSMutableArray<NSDictionary *> *postsToEvict = [[posts subarrayWithRange:NSMakeRange(1, posts.count - 1)] mutableCopy];
 
     // If the last remaining post is a gap marker, remove it.
-    ReaderPost *lastPost = [posts objectAtIndex:maxPosts - 1];
-    if ([lastPost isKindOfClass:[ReaderGapMarker class]]) {
-        DDLogInfo(@"Deleting Last GapMarker: %@", lastPost);
-        [context deleteObject:lastPost];
+    NSManagedObjectID *lastPostID = posts.firstObject[ReaderPostObjectIDKey];
+    if ([lastPostID.entity.name isEqualToString:NSStringFromClass([ReaderGapMarker class])]) {
+        DDLogInfo(@"Deleting Last GapMarker: %@", lastPostID);
+        [postsToEvict addObject:posts.firstObject];
     }
+
+    [self evictPosts:postsToEvict keepingInUsePosts:YES inContext:context];
 }
 
 /**
@@ -1100,33 +1093,124 @@ static NSString * const ReaderPostGlobalIDKey = @"globalID";
 
 - (void)deletePostsFromBlockedSitesInContext:(NSManagedObjectContext *)context
 {
-    NSError *error;
     NSFetchRequest *request = [[NSFetchRequest alloc] initWithEntityName:@"ReaderPost"];
     request.predicate = [NSPredicate predicateWithFormat:@"isSiteBlocked = YES"];
-    NSArray *results = [context executeFetchRequest:request error:&error];
-    if (error) {
-        DDLogError(@"%@, error deleting deleting posts from blocked sites: %@", NSStringFromSelector(_cmd), error);
-        return;
+
+    NSArray<NSDictionary *> *posts = [self evictionCandidatesForFetchRequest:request inContext:context];
+    [self evictPosts:posts keepingInUsePosts:YES inContext:context];
+}
+
+- (BOOL)topicShouldBeClearedFor:(ReaderPost *)post
+{
+    return (post.inUse || post.isSavedForLater);
+}
+
+#pragma mark Eviction
+
+/**
+ Fetches the posts matching the request as dictionaries holding only their object ID
+ and the flags needed to decide whether they can be deleted. No post is faulted in.
+
+ Every eviction starts here. The results come from the persistent store, which doesn't know about
+ the pending changes in `context`. When there are pending posts, the stale store rows are replaced
+ by the posts in memory, and the sort and offset of the request are applied in memory too.
+ The context is not saved.
+ */
+- (NSArray<NSDictionary *> *)evictionCandidatesForFetchRequest:(NSFetchRequest *)fetchRequest inContext:(NSManagedObjectContext *)context
+{
+    NSEntityDescription *entity = [NSEntityDescription entityForName:fetchRequest.entityName inManagedObjectContext:context];
+    NSMutableSet<NSManagedObject *> *pendingPosts = [NSMutableSet set];
+    for (NSSet<NSManagedObject *> *objects in @[context.insertedObjects, context.updatedObjects, context.deletedObjects]) {
+        for (NSManagedObject *object in objects) {
+            if ([object.entity isKindOfEntity:entity]) {
+                [pendingPosts addObject:object];
+            }
+        }
     }
 
-    if ([results count] == 0) {
-        return;
+    NSExpressionDescription *objectID = [NSExpressionDescription new];
+    objectID.name = ReaderPostObjectIDKey;
+    objectID.expression = [NSExpression expressionForEvaluatedObject];
+    objectID.expressionResultType = NSObjectIDAttributeType;
+
+    NSMutableArray<NSString *> *keys = [NSMutableArray arrayWithObjects:ReaderPostInUseKey, ReaderPostIsSavedForLaterKey, nil];
+    NSUInteger fetchOffset = fetchRequest.fetchOffset;
+    if (pendingPosts.count > 0) {
+        for (NSSortDescriptor *sortDescriptor in fetchRequest.sortDescriptors) {
+            [keys addObject:sortDescriptor.key];
+        }
+        fetchRequest.fetchOffset = 0;
     }
 
-    for (ReaderPost *post in results) {
-        if ([self topicShouldBeClearedFor:post]) {
-            // If the missing post is currenty being used just remove its topic.
-            post.topic = nil;
-        } else {
-            DDLogInfo(@"Deleting ReaderPost: %@", post.postTitle);
-            [context deleteObject:post];
+    fetchRequest.resultType = NSDictionaryResultType;
+    fetchRequest.includesPendingChanges = NO;
+    fetchRequest.propertiesToFetch = [@[objectID] arrayByAddingObjectsFromArray:keys];
+
+    NSError *error;
+    NSArray<NSDictionary *> *results = [context executeFetchRequest:fetchRequest error:&error];
+    if (error) {
+        DDLogError(@"%@ error fetching posts: %@", NSStringFromSelector(_cmd), error);
+        return @[];
+    }
+    if (pendingPosts.count == 0) {
+        return results;
+    }
+
+    NSSet<NSManagedObjectID *> *pendingPostIDs = [pendingPosts valueForKey:@"objectID"];
+    NSMutableArray<NSDictionary *> *candidates = [NSMutableArray arrayWithCapacity:results.count + pendingPosts.count];
+    for (NSDictionary *result in results) {
+        if (![pendingPostIDs containsObject:result[ReaderPostObjectIDKey]]) {
+            [candidates addObject:result];
         }
     }
+    for (NSManagedObject *post in pendingPosts) {
+        if (post.isDeleted || (fetchRequest.predicate && ![fetchRequest.predicate evaluateWithObject:post])) {
+            continue;
+        }
+        NSMutableDictionary *candidate = [[post dictionaryWithValuesForKeys:keys] mutableCopy];
+        candidate[ReaderPostObjectIDKey] = post.objectID;
+        [candidates addObject:candidate];
+    }
+
+    [candidates sortUsingDescriptors:fetchRequest.sortDescriptors ?: @[]];
+    if (fetchOffset >= candidates.count) {
+        return @[];
+    }
+    return [candidates subarrayWithRange:NSMakeRange(fetchOffset, candidates.count - fetchOffset)];
 }
 
-- (BOOL)topicShouldBeClearedFor:(ReaderPost *)post
+/**
+ Removes the posts returned by `evictionCandidatesForFetchRequest:inContext:`.
+
+ Saved posts, and in use posts when `keepInUsePosts` is YES, only have their topic cleared.
+ The rest are deleted with a batch delete, which is merged into `context` and the main context,
+ except for posts with pending changes, which are deleted through `context`.
+ */
+- (void)evictPosts:(NSArray<NSDictionary *> *)posts keepingInUsePosts:(BOOL)keepInUsePosts inContext:(NSManagedObjectContext *)context
 {
-    return (post.inUse || post.isSavedForLater);
+    NSMutableArray<NSManagedObjectID *> *objectIDsToDelete = [NSMutableArray arrayWithCapacity:posts.count];
+    for (NSDictionary *post in posts) {
+        NSManagedObjectID *objectID = post[ReaderPostObjectIDKey];
+        BOOL keep = [post[ReaderPostIsSavedForLaterKey] boolValue] || (keepInUsePosts && [post[ReaderPostInUseKey] boolValue]);
+        if (keep) {
+            // Protected posts are rare, and batch updates can't change relationships, so detach them one by one.
+            ReaderPost *protectedPost = (ReaderPost *)[context objectWithID:objectID];
+            protectedPost.topic = nil;
+        } else {
+            [objectIDsToDelete addObject:objectID];
+        }
+    }
+
+    if (objectIDsToDelete.count == 0) {
+        return;
+    }
+
+    NSError *error;
+    if (![context deleteObjectsWithIDs:objectIDsToDelete mergingChangesIntoMainContext:self.coreDataStack.mainContext error:&error]) {
+        DDLogError(@"%@ error deleting posts: %@", NSStringFromSelector(_cmd), error);
+        return;
+    }
+    DDLogInfo(@"Deleted %lu ReaderPosts", (unsigned long)objectIDsToDelete.count);
 }
 
 
@@ -1138,20 +1222,17 @@ static NSString * const ReaderPostGlobalIDKey = @"globalID";
 
  @param posts An array of `RemoteReaderPost` objects.
  @param topic The `ReaderAbsractTopic` to assign to the created posts.
+ @param existingPosts The cached posts matching `posts`, keyed by globalID.
  @return An array of `ReaderPost` objects
  */
-- (NSMutableArray *)makeNewPostsFromRemotePosts:(NSArray *)posts forTopic:(ReaderAbstractTopic *)topic inContext:(NSManagedObjectContext *)context
+- (NSMutableArray *)makeNewPostsFromRemotePosts:(NSArray *)posts
+                                       forTopic:(ReaderAbstractTopic *)topic
+                                  existingPosts:(NSMutableDictionary<NSString *, ReaderPost *> *)existingPosts
+                                      inContext:(NSManagedObjectContext *)context
 {
-    NSMutableArray *newPosts = [NSMutableArray array];
-    for (RemoteReaderPost *post in posts) {
-        ReaderPost *newPost = [self createOrReplaceFromRemotePost:post forTopic:topic inContext:context];
-        if (newPost != nil) {
-            [newPosts addObject:newPost];
-        } else {
-            DDLogInfo(@"%@ returned a nil post: %@", NSStringFromSelector(_cmd), post);
-        }
-    }
-    return newPosts;
+    NSParameterAssert(context != nil);
+    NSParameterAssert(topic == nil || topic.managedObjectContext == context);
+    return [[ReaderPost createOrReplaceFromRemotePosts:posts forTopic:topic existingPosts:existingPosts context:context] mutableCopy];
 }
 
 /**
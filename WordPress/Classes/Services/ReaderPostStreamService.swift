@@ -18,42 +18,50 @@ class ReaderPostStreamService {
 
         let remoteService = ReaderPostServiceRemote.withDefaultApi()
         remoteService.fetchPosts(for: [topic.slug], page: nextPageHandle, success: { posts, pageHandle in
-            var shouldBail = false
-            self.coreDataStack.performAndSave({ context in
-                guard let readerTopic = try? context.existingObject(with: topic.objectID) as? ReaderAbstractTopic else {
-                    // if there was an error or the topic was deleted just bail.
-                    shouldBail = true
-                    return
+            // Sanitize the content of every post concurrently before entering the context.
+            let contents = posts.reduce(into: [String: String]()) { contents, post in
+                if let globalID = post.globalID, let content = post.content {
+                    contents[globalID] = content
                 }
+            }
+            RichContentFormatter.prepareReaderPostContents(contents) {
+                var shouldBail = false
+                self.coreDataStack.performAndSave({ context in
+                    guard let readerTopic = try? context.existingObject(with: topic.objectID) as? ReaderAbstractTopic else {
+                        // if there was an error or the topic was deleted just bail.
+                        shouldBail = true
+                        return
+                    }
 
-                self.nextPageHandle = pageHandle
+                    self.nextPageHandle = pageHandle
 
-                if isFirstPage {
-                    self.pageNumber = 1
-                    self.removePosts(forTopic: readerTopic, in: context)
-                } else {
-                    self.pageNumber += 1
-                }
+                    if isFirstPage {
+                        self.pageNumber = 1
+                        self.removePosts(forTopic: readerTopic, in: context)
+                    } else {
+                        self.pageNumber += 1
+                    }
 
-                posts.enumerated().forEach { index, remotePost in
-                    let post = ReaderPost.createOrReplace(fromRemotePost: remotePost, for: readerTopic, context: context)
-                    // To keep the API order
-                    post?.sortRank = NSNumber(value: Date().timeIntervalSinceReferenceDate - Double(((self.pageNumber * Constants.paginationMultiplier) + index)))
-                }
+                    let readerPosts = ReaderPost.createOrReplace(fromRemotePosts: posts, for: readerTopic, context: context)
+                    readerPosts.enumerated().forEach { index, post in
+                        // To keep the API order
+                        post.sortRank = NSNumber(value: Date().timeIntervalSinceReferenceDate - Double(((self.pageNumber * Constants.paginationMultiplier) + index)))
+                    }
 
-                // Clean up
-                let service = ReaderPostService(coreDataStack: self.coreDataStack)
-                service.deletePostsInExcessOfMaxAllowed(for: readerTopic)
-                service.deletePostsFromBlockedSites()
-            }, completion: {
-                if shouldBail {
-                    success(0, false)
-                    return
-                }
+                    // Clean up
+                    let service = ReaderPostService(coreDataStack: self.coreDataStack)
+                    service.deletePostsInExcessOfMaxAllowed(for: readerTopic, in: context)
+                    service.deletePostsFromBlockedSites(in: context)
+                }, completion: {
+                    if shouldBail {
+                        success(0, false)
+                        return
+                    }
 
-                let hasMore = pageHandle != nil
-                success(posts.count, hasMore)
-            }, on: .main)
+                    let hasMore = pageHandle != nil
+                    success(posts.count, hasMore)
+                }, on: .main)
+            }
         }, failure: { error in
             failure(error)
         })
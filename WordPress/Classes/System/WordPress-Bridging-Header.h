@@ -17,6 +17,7 @@
 #import "Media.h"
 #import "MediaService.h"
 #import "MenuItem.h"
+#import "MenuItemTreeIndex.h"
 #import "MenuItemsViewController.h"
 #import "MenusService.h"
 #import "MenusViewController.h"
@@ -84,6 +84,53 @@ public extension NSManagedObjectContext {
         }
     }
 
+    /// Deletes the objects matching a batch delete request straight from the store, without loading them,
+    /// then merges the deletions into this context and `mainContext`.
+    ///
+    /// - Parameter mainContext: The main context of the stack this context belongs to.
+    /// - Returns: The IDs of the deleted objects.
+    ///
+    @objc(executeBatchDeleteRequest:mergingChangesIntoMainContext:error:)
+    @discardableResult
+    func executeBatchDelete(_ request: NSBatchDeleteRequest, mergingChangesInto mainContext: NSManagedObjectContext) throws -> [NSManagedObjectID] {
+        request.resultType = .resultTypeObjectIDs
+        let result = try execute(request) as? NSBatchDeleteResult
+        let deletedObjectIDs = result?.result as? [NSManagedObjectID] ?? []
+        guard !deletedObjectIDs.isEmpty else {
+            return []
+        }
+
+        var contexts = [self]
+        if self != mainContext && persistentStoreCoordinator == mainContext.persistentStoreCoordinator {
+            contexts.append(mainContext)
+        }
+        NSManagedObjectContext.mergeChanges(fromRemoteContextSave: [NSDeletedObjectsKey: deletedObjectIDs], into: contexts)
+        return deletedObjectIDs
+    }
+
+    /// Deletes the objects with the given IDs, batch deleting the ones without unsaved changes.
+    ///
+    /// A batch delete can't see the unsaved changes of this context, so those objects are deleted through
+    /// the context instead, and removed from the store when it's saved.
+    ///
+    /// - Parameter mainContext: The main context of the stack this context belongs to.
+    ///
+    @objc(deleteObjectsWithIDs:mergingChangesIntoMainContext:error:)
+    func deleteObjects(withIDs objectIDs: [NSManagedObjectID], mergingChangesInto mainContext: NSManagedObjectContext) throws {
+        var objectIDsToBatchDelete: [NSManagedObjectID] = []
+        for objectID in objectIDs {
+            if let object = registeredObject(for: objectID), object.hasChanges {
+                delete(object)
+            } else {
+                objectIDsToBatchDelete.append(objectID)
+            }
+        }
+
+        if !objectIDsToBatchDelete.isEmpty {
+            try executeBatchDelete(NSBatchDeleteRequest(objectIDs: objectIDsToBatchDelete), mergingChangesInto: mainContext)
+        }
+    }
+
     /// Retrieves the first entity that matches with a given predicate
     ///
     /// - Parameter predicate: Defines the conditions that any given object should meet.
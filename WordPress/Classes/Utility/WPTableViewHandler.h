@@ -21,12 +21,20 @@
 - (void)tableViewHandlerWillRefreshTableViewPreservingOffset:(nonnull WPTableViewHandler *)tableViewHandler;
 - (void)tableViewHandlerDidRefreshTableViewPreservingOffset:(nonnull WPTableViewHandler *)tableViewHandler;
 
+/**
+ Called after the changes of a fetched results controller transaction were applied to the table view,
+ when the handler coalesces content changes.
+ @param changeCount the number of section and row changes in the transaction.
+ @param reloaded YES if the table view was reloaded rather than updated, due to the number of changes.
+ @param duration the time spent applying the changes.
+ */
+- (void)tableViewHandler:(nonnull WPTableViewHandler *)tableViewHandler didApplyContentChanges:(NSUInteger)changeCount reloaded:(BOOL)reloaded duration:(NSTimeInterval)duration;
+
 
 #pragma mark - Proxied UITableViewDelegate Methods.
 #pragma mark - Configure rows for the table view.
 
 - (CGFloat)tableView:(nonnull UITableView *)tableView heightForRowAtIndexPath:(nonnull NSIndexPath *)indexPath;
-- (CGFloat)tableView:(nonnull UITableView *)tableView heightForRowAtIndexPath:(nonnull NSIndexPath *)indexPath forWidth:(CGFloat)width;
 - (CGFloat)tableView:(nonnull UITableView *)tableView estimatedHeightForRowAtIndexPath:(nonnull NSIndexPath *)indexPath;
 - (void)tableView:(nonnull UITableView *)tableView willDisplayCell:(nonnull UITableViewCell *)cell forRowAtIndexPath:(nonnull NSIndexPath *)indexPath;
 
@@ -108,9 +116,20 @@
 @property (nonatomic) BOOL listensForContentChanges;
 @property (nonatomic) BOOL disableAnimations;
 
+/**
+ Collect the changes of each fetched results controller transaction and apply them to the table view in a single
+ batch of updates, rather than one by one as they're reported. Defaults to NO.
+ */
+@property (nonatomic) BOOL coalescesContentChanges;
+
+/**
+ When coalescing content changes, transactions with more changes than this are applied by reloading the table view,
+ which is cheaper than animating each change. Defaults to 100.
+ */
+@property (nonatomic) NSUInteger coalescedChangesReloadThreshold;
+
 - (nonnull instancetype)initWithTableView:(nonnull UITableView *)tableView;
 - (void)clearCachedRowHeights;
-- (void)refreshCachedRowHeightsForWidth:(CGFloat)width;
 - (void)invalidateCachedRowHeightAtIndexPath:(nonnull NSIndexPath *)indexPath;
 - (void)resetResultsController;
 
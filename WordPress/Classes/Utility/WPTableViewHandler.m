@@ -1,4 +1,5 @@
 #import "WPTableViewHandler.h"
+#import "WPTableViewRowHeightCache.h"
 #ifdef KEYSTONE
 #import "Keystone-Swift.h"
 #else
@@ -12,6 +13,92 @@
 
 static NSString * const DefaultCellIdentifier = @"DefaultCellIdentifier";
 static CGFloat const DefaultCellHeight = 44.0;
+static NSUInteger const DefaultCoalescedChangesReloadThreshold = 100;
+
+/**
+ The section and row changes of a fetched results controller transaction, waiting to be applied to the table view.
+ Deleted and reloaded rows are in the coordinates before the changes, inserted rows in the coordinates after them.
+ Rows are grouped by the animation they're applied with.
+ */
+@interface WPTableViewContentChanges : NSObject
+
+@property (nonatomic, strong, readonly) NSMutableIndexSet *deletedSections;
+@property (nonatomic, strong, readonly) NSMutableIndexSet *insertedSections;
+@property (nonatomic, strong, readonly) NSMutableDictionary<NSNumber *, NSMutableSet<NSIndexPath *> *> *deletedRows;
+@property (nonatomic, strong, readonly) NSMutableDictionary<NSNumber *, NSMutableSet<NSIndexPath *> *> *insertedRows;
+@property (nonatomic, strong, readonly) NSMutableDictionary<NSNumber *, NSMutableSet<NSIndexPath *> *> *reloadedRows;
+@property (nonatomic) UITableViewRowAnimation sectionAnimation;
+@property (nonatomic, readonly) NSUInteger count;
+
+- (void)addIndexPath:(NSIndexPath *)indexPath toRows:(NSMutableDictionary<NSNumber *, NSMutableSet<NSIndexPath *> *> *)rows withRowAnimation:(UITableViewRowAnimation)animation;
+- (void)applyToTableView:(UITableView *)tableView;
+
+@end
+
+@implementation WPTableViewContentChanges {
+    NSUInteger _rowCount;
+}
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self) {
+        _deletedSections = [NSMutableIndexSet indexSet];
+        _insertedSections = [NSMutableIndexSet indexSet];
+        _deletedRows = [NSMutableDictionary dictionary];
+        _insertedRows = [NSMutableDictionary dictionary];
+        _reloadedRows = [NSMutableDictionary dictionary];
+    }
+    return self;
+}
+
+- (void)addIndexPath:(NSIndexPath *)indexPath toRows:(NSMutableDictionary<NSNumber *, NSMutableSet<NSIndexPath *> *> *)rows withRowAnimation:(UITableViewRowAnimation)animation
+{
+    NSMutableSet *indexPaths = rows[@(animation)];
+    if (!indexPaths) {
+        indexPaths = [NSMutableSet set];
+        rows[@(animation)] = indexPaths;
+    }
+    if (![indexPaths containsObject:indexPath]) {
+        [indexPaths addObject:indexPath];
+        _rowCount++;
+    }
+}
+
+- (NSUInteger)count
+{
+    return _rowCount + self.deletedSections.count + self.insertedSections.count;
+}
+
+- (void)applyToTableView:(UITableView *)tableView
+{
+    // A row can't be both reloaded and deleted in the same batch.
+    NSMutableSet<NSIndexPath *> *allDeletedRows = [NSMutableSet set];
+    for (NSSet *indexPaths in self.deletedRows.allValues) {
+        [allDeletedRows unionSet:indexPaths];
+    }
+    for (NSMutableSet *indexPaths in self.reloadedRows.allValues) {
+        [indexPaths minusSet:allDeletedRows];
+    }
+
+    [tableView performBatchUpdates:^{
+        [tableView deleteSections:self.deletedSections withRowAnimation:self.sectionAnimation];
+        [tableView insertSections:self.insertedSections withRowAnimation:self.sectionAnimation];
+        [self.deletedRows enumerateKeysAndObjectsUsingBlock:^(NSNumber *animation, NSSet *indexPaths, BOOL *stop) {
+            [tableView deleteRowsAtIndexPaths:indexPaths.allObjects withRowAnimation:animation.integerValue];
+        }];
+        [self.insertedRows enumerateKeysAndObjectsUsingBlock:^(NSNumber *animation, NSSet *indexPaths, BOOL *stop) {
+            [tableView insertRowsAtIndexPaths:indexPaths.allObjects withRowAnimation:animation.integerValue];
+        }];
+        [self.reloadedRows enumerateKeysAndObjectsUsingBlock:^(NSNumber *animation, NSSet *indexPaths, BOOL *stop) {
+            if (indexPaths.count) {
+                [tableView reloadRowsAtIndexPaths:indexPaths.allObjects withRowAnimation:animation.integerValue];
+            }
+        }];
+    } completion:nil];
+}
+
+@end
 
 @interface WPTableViewHandler ()
 
@@ -20,11 +107,12 @@ static CGFloat const DefaultCellHeight = 44.0;
 @property (nonatomic, strong) NSIndexPath *indexPathSelectedBeforeUpdates;
 @property (nonatomic, strong) NSIndexPath *indexPathSelectedAfterUpdates;
 @property (nonatomic, strong) NSMutableArray *sectionHeaders;
-@property (nonatomic, strong) NSMutableDictionary *cachedRowHeights;
-@property (nonatomic, strong) NSMutableArray *rowsWithInvalidatedHeights;
+@property (nonatomic, strong) WPTableViewRowHeightCache *rowHeightCache;
+@property (nonatomic, strong) NSMutableSet<NSIndexPath *> *rowsWithInvalidatedHeights;
 @property (nonatomic, readwrite) BOOL isScrolling;
 @property (nonatomic, strong) NSArray *fetchedResultsBeforeChange;
 @property (nonatomic, strong) NSArray *fetchedResultsIndexPathsBeforeChange;
+@property (nonatomic, strong) WPTableViewContentChanges *pendingContentChanges;
 
 @end
 
@@ -44,13 +132,14 @@ static CGFloat const DefaultCellHeight = 44.0;
     self = [super init];
     if (self) {
         _sectionHeaders = [NSMutableArray array];
-        _cachedRowHeights = [NSMutableDictionary dictionary];
-        _rowsWithInvalidatedHeights = [NSMutableArray array];
+        _rowHeightCache = [[WPTableViewRowHeightCache alloc] init];
+        _rowsWithInvalidatedHeights = [NSMutableSet set];
         _updateRowAnimation = UITableViewRowAnimationFade;
         _insertRowAnimation = UITableViewRowAnimationFade;
         _deleteRowAnimation = UITableViewRowAnimationFade;
         _moveRowAnimation = UITableViewRowAnimationFade;
         _sectionRowAnimation = UITableViewRowAnimationFade;
+        _coalescedChangesReloadThreshold = DefaultCoalescedChangesReloadThreshold;
         _tableView = tableView;
         _tableView.delegate = self;
         _tableView.dataSource = self;
@@ -80,7 +169,7 @@ static CGFloat const DefaultCellHeight = 44.0;
 
 - (void)clearCachedRowHeights
 {
-    [self.cachedRowHeights removeAllObjects];
+    [self.rowHeightCache removeAllHeights];
 }
 
 - (void)refreshTableView
@@ -223,31 +312,37 @@ static CGFloat const DefaultCellHeight = 44.0;
 
 - (void)cacheRowHeight:(CGFloat)height forIndexPath:(NSIndexPath *)indexPath
 {
-    [self.cachedRowHeights setObject:@(height) forKey:indexPath];
+    [self.rowHeightCache setHeight:height forRowAtIndexPath:indexPath objectID:[self objectIDForRowAtIndexPath:indexPath]];
 }
 
 - (CGFloat)cachedRowHeightForIndexPath:(NSIndexPath *)indexPath
 {
-    return [[self.cachedRowHeights numberForKey:indexPath] floatValue];
+    // Rows whose height is already in place don't need their object looked up.
+    CGFloat height = [self.rowHeightCache heightForRowAtIndexPath:indexPath objectID:nil];
+    if (height) {
+        return height;
+    }
+    return [self.rowHeightCache heightForRowAtIndexPath:indexPath objectID:[self objectIDForRowAtIndexPath:indexPath]];
 }
 
-- (void)refreshCachedRowHeightsForWidth:(CGFloat)width
+/**
+ The objectID of the object displayed at the indexPath, used to keep its cached height across content changes.
+ Returns nil when the rows of the section don't map one to one to the fetched objects, e.g. for subclasses
+ adding rows of their own.
+ */
+- (NSManagedObjectID *)objectIDForRowAtIndexPath:(NSIndexPath *)indexPath
 {
-    if (!self.cacheRowHeights || ![self.delegate respondsToSelector:@selector(tableView:heightForRowAtIndexPath:forWidth:)]) {
-        return;
+    NSArray<id<NSFetchedResultsSectionInfo>> *sections = self.resultsController.sections;
+    if (indexPath.section >= (NSInteger)sections.count) {
+        return nil;
     }
-
-    NSMutableDictionary *cachedRowHeights = [NSMutableDictionary dictionary];
-    for (NSObject<NSFetchRequestResult> *obj in self.resultsController.fetchedObjects) {
-        NSIndexPath *indexPath = [self.resultsController indexPathForObject:obj];
-        if (!indexPath) {
-            continue;
-        }
-        CGFloat height = [self.delegate tableView:self.tableView heightForRowAtIndexPath:indexPath forWidth:width];
-        [cachedRowHeights setObject:@(height) forKey:indexPath];
+    NSUInteger numberOfObjects = sections[indexPath.section].numberOfObjects;
+    if (indexPath.row >= (NSInteger)numberOfObjects
+        || [self tableView:self.tableView numberOfRowsInSection:indexPath.section] != (NSInteger)numberOfObjects) {
+        return nil;
     }
-
-    self.cachedRowHeights = cachedRowHeights;
+    id object = [self.resultsController objectAtIndexPath:indexPath];
+    return [object isKindOfClass:[NSManagedObject class]] ? [(NSManagedObject *)object objectID] : nil;
 }
 
 - (void)clearCachedRowHeightsBelowIndexPath:(NSIndexPath *)indexPath
@@ -255,40 +350,34 @@ static CGFloat const DefaultCellHeight = 44.0;
     if (!self.cacheRowHeights) {
         return;
     }
-
-    NSMutableArray *invalidKeys = [NSMutableArray array];
-
-    for (NSIndexPath *key in [self.cachedRowHeights allKeys]) {
-        if ([key compare:indexPath] == NSOrderedDescending) {
-            [invalidKeys addObject:key];
-        }
-    }
-
-    [self.cachedRowHeights removeObjectForKey:indexPath];
-    [self.cachedRowHeights removeObjectsForKeys:invalidKeys];
+    [self.rowHeightCache invalidateRowsFromIndexPath:indexPath];
 }
 
-- (void)clearCachedRowHeightAtIndexPath:(NSIndexPath *)indexPath
+- (void)clearCachedRowHeightAtIndexPath:(NSIndexPath *)indexPath objectID:(NSManagedObjectID *)objectID
 {
     if (!self.cacheRowHeights) {
         return;
     }
-    [self.cachedRowHeights removeObjectForKey:indexPath];
+    [self.rowHeightCache removeHeightForRowAtIndexPath:indexPath objectID:objectID];
 }
 
 - (void)invalidateCachedRowHeightAtIndexPath:(NSIndexPath *)indexPath
+{
+    [self invalidateCachedRowHeightAtIndexPath:indexPath objectID:[self objectIDForRowAtIndexPath:indexPath]];
+}
+
+- (void)invalidateCachedRowHeightAtIndexPath:(NSIndexPath *)indexPath objectID:(NSManagedObjectID *)objectID
 {
     if (!self.cacheRowHeights) {
         return;
     }
 
-    NSNumber *height = [self.cachedRowHeights objectForKey:indexPath];
-    if (!height) {
+    if (![self.rowHeightCache heightForRowAtIndexPath:indexPath objectID:objectID]) {
         return;
     }
 
     [self.rowsWithInvalidatedHeights addObject:indexPath];
-    [self clearCachedRowHeightAtIndexPath:indexPath];
+    [self clearCachedRowHeightAtIndexPath:indexPath objectID:objectID];
 }
 
 - (void)resetResultsController
@@ -442,6 +531,8 @@ static CGFloat const DefaultCellHeight = 44.0;
     CGFloat height = DefaultCellHeight;
 
     if (self.cacheRowHeights) {
+        // Heights measured at another width, e.g. before a rotation, are kept aside until the table is back to it.
+        self.rowHeightCache.width = CGRectGetWidth(tableView.bounds);
         height = [self cachedRowHeightForIndexPath:indexPath];
         if (height) {
             return height;
@@ -647,6 +738,11 @@ static CGFloat const DefaultCellHeight = 44.0;
     }
 
     self.indexPathSelectedBeforeUpdates = [self.tableView indexPathForSelectedRow];
+    if (self.coalescesContentChanges) {
+        self.pendingContentChanges = [[WPTableViewContentChanges alloc] init];
+        self.pendingContentChanges.sectionAnimation = self.sectionRowAnimation;
+        return;
+    }
     if (self.disableAnimations) {
         [UIView setAnimationsEnabled:NO];
     }
@@ -655,10 +751,16 @@ static CGFloat const DefaultCellHeight = 44.0;
 
 - (void)controllerDidChangeContent:(NSFetchedResultsController *)controller
 {
-    
+    WPTableViewContentChanges *changes = self.pendingContentChanges;
+    self.pendingContentChanges = nil;
+
     // Catch unexpected expections when ending tableView updates to prevent crashes
     NSError *error;
     [WPException objcTryBlock:^{
+        if (changes) {
+            [self applyContentChanges:changes];
+            return;
+        }
         [self.tableView endUpdates];
         if (self.disableAnimations) {
             [UIView setAnimationsEnabled:YES];
@@ -720,13 +822,16 @@ static CGFloat const DefaultCellHeight = 44.0;
         case NSFetchedResultsChangeInsert:
         {
             [self clearCachedRowHeightsBelowIndexPath:newIndexPath];
-            [self.tableView insertRowsAtIndexPaths:@[newIndexPath] withRowAnimation:self.insertRowAnimation];
+            [self insertRowAtIndexPath:newIndexPath withRowAnimation:self.insertRowAnimation];
         }
             break;
         case NSFetchedResultsChangeDelete:
         {
             [self clearCachedRowHeightsBelowIndexPath:indexPath];
-            [self.tableView deleteRowsAtIndexPaths:@[indexPath] withRowAnimation:self.deleteRowAnimation];
+            if ([anObject isKindOfClass:[NSManagedObject class]]) {
+                [self clearCachedRowHeightAtIndexPath:indexPath objectID:[(NSManagedObject *)anObject objectID]];
+            }
+            [self deleteRowAtIndexPath:indexPath withRowAnimation:self.deleteRowAnimation];
             if ([self.indexPathSelectedBeforeUpdates isEqual:indexPath]) {
                 [self deletingSelectedRowAtIndexPath:indexPath];
             }
@@ -739,8 +844,9 @@ static CGFloat const DefaultCellHeight = 44.0;
             && [self.delegate shouldCancelUpdateAnimation];
 
             if (!shouldCancelUpdateAnimation) {
-                [self invalidateCachedRowHeightAtIndexPath:indexPath];
-                [self.tableView reloadRowsAtIndexPaths:@[indexPath] withRowAnimation:self.updateRowAnimation];
+                NSManagedObjectID *objectID = [anObject isKindOfClass:[NSManagedObject class]] ? [(NSManagedObject *)anObject objectID] : nil;
+                [self invalidateCachedRowHeightAtIndexPath:indexPath objectID:objectID];
+                [self reloadRowAtIndexPath:indexPath withRowAnimation:self.updateRowAnimation];
             }
         }
             break;
@@ -751,9 +857,13 @@ static CGFloat const DefaultCellHeight = 44.0;
                 lowerIndexPath = newIndexPath;
             }
             [self clearCachedRowHeightsBelowIndexPath:lowerIndexPath];
+            // Objects usually move because their content changed, which can change their height too.
+            if ([anObject isKindOfClass:[NSManagedObject class]]) {
+                [self clearCachedRowHeightAtIndexPath:newIndexPath objectID:[(NSManagedObject *)anObject objectID]];
+            }
 
-            [self.tableView deleteRowsAtIndexPaths:@[indexPath] withRowAnimation:self.moveRowAnimation];
-            [self.tableView insertRowsAtIndexPaths:@[newIndexPath] withRowAnimation:self.moveRowAnimation];
+            [self deleteRowAtIndexPath:indexPath withRowAnimation:self.moveRowAnimation];
+            [self insertRowAtIndexPath:newIndexPath withRowAnimation:self.moveRowAnimation];
             if ([self.indexPathSelectedBeforeUpdates isEqual:indexPath] && self.indexPathSelectedAfterUpdates == nil) {
                 self.indexPathSelectedAfterUpdates = newIndexPath;
             }
@@ -766,10 +876,81 @@ static CGFloat const DefaultCellHeight = 44.0;
 
 - (void)controller:(NSFetchedResultsController *)controller didChangeSection:(id)sectionInfo atIndex:(NSUInteger)sectionIndex forChangeType:(NSFetchedResultsChangeType)type
 {
+    if (self.cacheRowHeights) {
+        [self.rowHeightCache invalidateAllRows];
+    }
+
     if (type == NSFetchedResultsChangeInsert) {
-        [self.tableView insertSections:[NSIndexSet indexSetWithIndex:sectionIndex] withRowAnimation:self.sectionRowAnimation];
+        if (self.pendingContentChanges) {
+            [self.pendingContentChanges.insertedSections addIndex:sectionIndex];
+        } else {
+            [self.tableView insertSections:[NSIndexSet indexSetWithIndex:sectionIndex] withRowAnimation:self.sectionRowAnimation];
+        }
     } else if (type == NSFetchedResultsChangeDelete) {
-        [self.tableView deleteSections:[NSIndexSet indexSetWithIndex:sectionIndex] withRowAnimation:self.sectionRowAnimation];
+        if (self.pendingContentChanges) {
+            [self.pendingContentChanges.deletedSections addIndex:sectionIndex];
+        } else {
+            [self.tableView deleteSections:[NSIndexSet indexSetWithIndex:sectionIndex] withRowAnimation:self.sectionRowAnimation];
+        }
+    }
+}
+
+
+#pragma mark - Content Changes
+
+- (void)insertRowAtIndexPath:(NSIndexPath *)indexPath withRowAnimation:(UITableViewRowAnimation)animation
+{
+    if (self.pendingContentChanges) {
+        [self.pendingContentChanges addIndexPath:indexPath toRows:self.pendingContentChanges.insertedRows withRowAnimation:animation];
+    } else {
+        [self.tableView insertRowsAtIndexPaths:@[indexPath] withRowAnimation:animation];
+    }
+}
+
+- (void)deleteRowAtIndexPath:(NSIndexPath *)indexPath withRowAnimation:(UITableViewRowAnimation)animation
+{
+    if (self.pendingContentChanges) {
+        [self.pendingContentChanges addIndexPath:indexPath toRows:self.pendingContentChanges.deletedRows withRowAnimation:animation];
+    } else {
+        [self.tableView deleteRowsAtIndexPaths:@[indexPath] withRowAnimation:animation];
+    }
+}
+
+- (void)reloadRowAtIndexPath:(NSIndexPath *)indexPath withRowAnimation:(UITableViewRowAnimation)animation
+{
+    if (self.pendingContentChanges) {
+        [self.pendingContentChanges addIndexPath:indexPath toRows:self.pendingContentChanges.reloadedRows withRowAnimation:animation];
+    } else {
+        [self.tableView reloadRowsAtIndexPaths:@[indexPath] withRowAnimation:animation];
+    }
+}
+
+/**
+ Apply the changes of a whole transaction in a single batch of updates, or with a reload of the
+ table view when there are too many changes for animating them to be worthwhile.
+ */
+- (void)applyContentChanges:(WPTableViewContentChanges *)changes
+{
+    const CFTimeInterval startTime = CACurrentMediaTime();
+    const NSUInteger changeCount = changes.count;
+    const BOOL reloads = changeCount > self.coalescedChangesReloadThreshold;
+
+    if (reloads) {
+        [self.tableView reloadData];
+    } else if (changeCount > 0) {
+        if (self.disableAnimations) {
+            [UIView setAnimationsEnabled:NO];
+        }
+        [changes applyToTableView:self.tableView];
+        if (self.disableAnimations) {
+            [UIView setAnimationsEnabled:YES];
+        }
+    }
+
+    const NSTimeInterval duration = CACurrentMediaTime() - startTime;
+    DDLogDebug(@"TableViewHandler: Applied %lu content changes%@ in %.3fs", (unsigned long)changeCount, reloads ? @" by reloading" : @"", duration);
+    if ([self.delegate respondsToSelector:@selector(tableViewHandler:didApplyContentChanges:reloaded:duration:)]) {
+        [self.delegate tableViewHandler:self didApplyContentChanges:changeCount reloaded:reloads duration:duration];
     }
 }
 
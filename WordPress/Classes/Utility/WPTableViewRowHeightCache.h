@@ -0,0 +1,61 @@
+#import <UIKit/UIKit.h>
+#import <CoreData/CoreData.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Caches the row heights of a table view, for the width the rows were measured at.
+
+ Heights are kept in two layers:
+ - A contiguous array of heights per section, indexed by row, which serves lookups while scrolling.
+   Content changes only invalidate the rows at and below the changed row, by truncating the section's array.
+ - The heights of managed objects keyed by their objectID, which survive content changes and are used
+   to refill the arrays lazily after an invalidation, without measuring the rows again.
+
+ Heights are bucketed by width, so that rotating back and forth reuses the heights measured for each orientation.
+ */
+@interface WPTableViewRowHeightCache : NSObject
+
+/**
+ The width the cached heights were measured at. Changing the width switches to the heights cached for that width, if any.
+ */
+@property (nonatomic) CGFloat width;
+
+/**
+ The number of widths whose heights are kept. The least recently used widths are dropped first. Defaults to 3.
+ */
+@property (nonatomic) NSUInteger maximumWidthCount;
+
+/**
+ The cached height of the row, or 0 if the row has no cached height.
+ @param objectID the objectID of the object displayed by the row, if any.
+ */
+- (CGFloat)heightForRowAtIndexPath:(NSIndexPath *)indexPath objectID:(nullable NSManagedObjectID *)objectID;
+
+- (void)setHeight:(CGFloat)height forRowAtIndexPath:(NSIndexPath *)indexPath objectID:(nullable NSManagedObjectID *)objectID;
+
+/**
+ Forget the height of a row whose content changed.
+ */
+- (void)removeHeightForRowAtIndexPath:(NSIndexPath *)indexPath objectID:(nullable NSManagedObjectID *)objectID;
+
+/**
+ Forget which heights belong to the row and the rows below it in the same section, e.g. after rows were inserted,
+ deleted or moved. The heights remain cached by objectID.
+ */
+- (void)invalidateRowsFromIndexPath:(NSIndexPath *)indexPath;
+
+/**
+ Forget which heights belong to which rows in every section, e.g. after sections were inserted or deleted.
+ The heights remain cached by objectID.
+ */
+- (void)invalidateAllRows;
+
+/**
+ Forget every cached height, for every width.
+ */
+- (void)removeAllHeights;
+
+@end
+
+NS_ASSUME_NONNULL_END
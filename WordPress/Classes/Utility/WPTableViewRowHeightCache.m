@@ -0,0 +1,171 @@
+#import "WPTableViewRowHeightCache.h"
+
+static NSUInteger const DefaultMaximumWidthCount = 3;
+
+@interface WPTableViewRowHeightCache ()
+
+/// The heights of each section for the current width, indexed by row. Zero marks a row without a cached height.
+@property (nonatomic, strong) NSMutableArray<NSMutableData *> *sectionHeights;
+/// The heights of managed objects keyed by objectID, for each width bucket.
+@property (nonatomic, strong) NSMutableDictionary<NSNumber *, NSMutableDictionary<NSManagedObjectID *, NSNumber *> *> *objectHeightsByWidth;
+/// The width buckets, from the least to the most recently used.
+@property (nonatomic, strong) NSMutableArray<NSNumber *> *recentWidths;
+
+@end
+
+@implementation WPTableViewRowHeightCache
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self) {
+        _maximumWidthCount = DefaultMaximumWidthCount;
+        _sectionHeights = [NSMutableArray array];
+        _objectHeightsByWidth = [NSMutableDictionary dictionary];
+        _recentWidths = [NSMutableArray array];
+    }
+    return self;
+}
+
+- (void)setWidth:(CGFloat)width
+{
+    if (lround(width) == lround(_width)) {
+        return;
+    }
+    _width = width;
+
+    // The row arrays only hold the heights of the current width. They'll be refilled
+    // from the heights cached by objectID for the new width, if it was seen before.
+    [self invalidateAllRows];
+    [self objectHeightsForCurrentWidth];
+}
+
+#pragma mark - Heights
+
+- (CGFloat)heightForRowAtIndexPath:(NSIndexPath *)indexPath objectID:(NSManagedObjectID *)objectID
+{
+    if (indexPath.section < (NSInteger)self.sectionHeights.count) {
+        NSMutableData *heights = self.sectionHeights[indexPath.section];
+        if (indexPath.row < (NSInteger)(heights.length / sizeof(CGFloat))) {
+            CGFloat height = ((CGFloat *)heights.mutableBytes)[indexPath.row];
+            if (height > 0) {
+                return height;
+            }
+        }
+    }
+
+    if (!objectID) {
+        return 0;
+    }
+
+    NSNumber *height = [[self objectHeightsForCurrentWidth] objectForKey:objectID];
+    if (!height) {
+        return 0;
+    }
+    [self storeHeight:height.doubleValue forRowAtIndexPath:indexPath];
+    return height.doubleValue;
+}
+
+- (void)setHeight:(CGFloat)height forRowAtIndexPath:(NSIndexPath *)indexPath objectID:(NSManagedObjectID *)objectID
+{
+    if (height <= 0) {
+        [self removeHeightForRowAtIndexPath:indexPath objectID:objectID];
+        return;
+    }
+    [self storeHeight:height forRowAtIndexPath:indexPath];
+    if (objectID) {
+        [[self objectHeightsForCurrentWidth] setObject:@(height) forKey:objectID];
+    }
+}
+
+- (void)removeHeightForRowAtIndexPath:(NSIndexPath *)indexPath objectID:(NSManagedObjectID *)objectID
+{
+    [self storeHeight:0 forRowAtIndexPath:indexPath];
+    if (objectID) {
+        // The content of the object changed, which makes its heights stale for every width.
+        for (NSMutableDictionary *objectHeights in self.objectHeightsByWidth.allValues) {
+            [objectHeights removeObjectForKey:objectID];
+        }
+    }
+}
+
+#pragma mark - Invalidation
+
+- (void)invalidateRowsFromIndexPath:(NSIndexPath *)indexPath
+{
+    if (indexPath.section >= (NSInteger)self.sectionHeights.count) {
+        return;
+    }
+    NSMutableData *heights = self.sectionHeights[indexPath.section];
+    const NSUInteger length = MAX(indexPath.row, 0) * sizeof(CGFloat);
+    if (length < heights.length) {
+        heights.length = length;
+    }
+}
+
+- (void)invalidateAllRows
+{
+    [self.sectionHeights removeAllObjects];
+}
+
+- (void)removeAllHeights
+{
+    [self.sectionHeights removeAllObjects];
+    [self.objectHeightsByWidth removeAllObjects];
+    [self.recentWidths removeAllObjects];
+}
+
+#pragma mark - Private
+
+- (void)storeHeight:(CGFloat)height forRowAtIndexPath:(NSIndexPath *)indexPath
+{
+    if (indexPath.section < 0 || indexPath.row < 0) {
+        return;
+    }
+    while ((NSInteger)self.sectionHeights.count <= indexPath.section) {
+        if (height <= 0) {
+            return;
+        }
+        [self.sectionHeights addObject:[NSMutableData data]];
+    }
+
+    NSMutableData *heights = self.sectionHeights[indexPath.section];
+    const NSUInteger minimumLength = (indexPath.row + 1) * sizeof(CGFloat);
+    if (heights.length < minimumLength) {
+        if (height <= 0) {
+            return;
+        }
+        // Rows skipped over are zero-filled, i.e. without a cached height.
+        heights.length = minimumLength;
+    }
+    ((CGFloat *)heights.mutableBytes)[indexPath.row] = height;
+}
+
+- (NSNumber *)bucketForWidth:(CGFloat)width
+{
+    return @(lround(width));
+}
+
+- (NSMutableDictionary<NSManagedObjectID *, NSNumber *> *)objectHeightsForCurrentWidth
+{
+    NSNumber *bucket = [self bucketForWidth:self.width];
+    NSMutableDictionary *objectHeights = self.objectHeightsByWidth[bucket];
+    if (objectHeights) {
+        if (![self.recentWidths.lastObject isEqualToNumber:bucket]) {
+            [self.recentWidths removeObject:bucket];
+            [self.recentWidths addObject:bucket];
+        }
+        return objectHeights;
+    }
+
+    objectHeights = [NSMutableDictionary dictionary];
+    self.objectHeightsByWidth[bucket] = objectHeights;
+    [self.recentWidths addObject:bucket];
+    while (self.recentWidths.count > MAX(self.maximumWidthCount, 1)) {
+        [self.objectHeightsByWidth removeObjectForKey:self.recentWidths.firstObject];
+        [self.recentWidths removeObjectAtIndex:0];
+    }
+    return objectHeights;
+}
+
+@end
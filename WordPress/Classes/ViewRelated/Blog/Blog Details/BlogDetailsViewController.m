@@ -1764,9 +1764,15 @@ CGFloat const BlogDetailReminderSectionFooterHeight = 1.0;
 /// This method syncs the blog and its metadata, then reloads the table view.
 ///
 - (void)updateTableView:(void(^)(void))completion
+{
+    [self updateTableViewUserInitiated:NO completion:completion];
+}
+
+- (void)updateTableViewUserInitiated:(BOOL)userInitiated completion:(void(^)(void))completion
 {
     __weak __typeof(self) weakSelf = self;
     [self.blogService syncBlogAndAllMetadata:self.blog
+                               userInitiated:userInitiated
                            completionHandler:
      ^{
         [weakSelf configureTableViewData];
@@ -1783,7 +1789,9 @@ CGFloat const BlogDetailReminderSectionFooterHeight = 1.0;
 
 - (void)pulledToRefreshWith:(UIRefreshControl *)refreshControl onCompletion:( void(^)(void))completion {
 
-    [self updateTableView: ^{
+    // The user asked for fresh data, so don't skip the metadata synced recently.
+    [[BlogSyncScheduler shared] invalidateFreshnessForBlog:self.blog.objectID];
+    [self updateTableViewUserInitiated:YES completion:^{
         // WORKAROUND: if we don't dispatch this asynchronously, the refresh end animation is clunky.
         // To recognize if we can remove this, simply remove the dispatch_async call and test pulling
         // down to refresh the site.
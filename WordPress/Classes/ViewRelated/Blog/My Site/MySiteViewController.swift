@@ -417,6 +417,7 @@ final class MySiteViewController: UIViewController, UIScrollViewDelegate, NoSite
                 self?.refreshControl.endRefreshing()
             }
 
+            BlogSyncScheduler.shared.invalidateFreshness(forBlog: blog.objectID)
             syncBlogAndAllMetadata(blog)
 
             /// Update today's prompt if the blog has blogging prompts enabled.
@@ -427,7 +428,8 @@ final class MySiteViewController: UIViewController, UIScrollViewDelegate, NoSite
     }
 
     private func syncBlogAndAllMetadata(_ blog: Blog) {
-        blogService.syncBlogAndAllMetadata(blog) { [weak self] in
+        // The blog is on screen, so its sync goes ahead of the background syncs of other blogs.
+        blogService.syncBlogAndAllMetadata(blog, userInitiated: true) { [weak self] in
             guard let self else {
                 return
             }
@@ -159,6 +159,7 @@ static NSString *RestorableFilterIndexKey = @"restorableFilterIndexKey";
 {
     WPTableViewHandler *tableViewHandler    = [[WPTableViewHandler alloc] initWithTableView:self.tableView];
     tableViewHandler.delegate               = self;
+    tableViewHandler.coalescesContentChanges = YES;
     self.tableViewHandler                   = tableViewHandler;
 }
 
@@ -51,6 +51,7 @@ struct GravatarQuickEditorPresenter {
                     // Purge the cache otherwise the old avatars remain around.
                     await ImageDownloader.shared.clearURLSessionCache()
                     await ImageDownloader.shared.clearMemoryCache()
+                    await ImageDownloader.shared.clearDiskCache()
                     NotificationCenter.default.post(name: .GravatarQEAvatarUpdateNotification,
                                                     object: self,
                                                     userInfo: [GravatarQEAvatarUpdateNotificationKeys.email.rawValue: email])
@@ -69,6 +69,8 @@ final class LightboxImagePageViewController: UIViewController {
             if scrollView.imageView.image == nil {
                 activityIndicator.startAnimating()
             }
+        case .preview(let image):
+            scrollView.configure(with: image)
         case .success(let image):
             activityIndicator.stopAnimating()
             scrollView.configure(with: image)
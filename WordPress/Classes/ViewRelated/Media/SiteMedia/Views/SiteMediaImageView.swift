@@ -104,7 +104,7 @@ final class SiteMediaImageView: UIView {
             case .spinner:
                 makeSpinner().startAnimating()
             }
-        case .success(let image):
+        case .preview(let image), .success(let image):
             self.image = image
             imageView.isHidden = false
         case .failure:
@@ -1,6 +1,7 @@
 #import "MenuItemsViewController.h"
 #import "Menu.h"
 #import "MenuItem.h"
+#import "MenuItemTreeIndex.h"
 #import "MenuItemAbstractView.h"
 #import "MenuItemView.h"
 #import "MenuItemInsertionView.h"
@@ -23,6 +24,7 @@ static CGFloat const ItemOrderingTouchesDetectionInset = 10.0;
 
 @property (nonatomic, strong, readonly) NSMutableSet *itemViews;
 @property (nonatomic, strong, readonly) NSMutableSet *insertionViews;
+@property (nonatomic, strong) MenuItemTreeIndex *treeIndex;
 @property (nonatomic, strong) MenuItemView *itemViewForInsertionToggling;
 @property (nonatomic, assign) BOOL isEditingForItemViewInsertion;
 
@@ -77,6 +79,8 @@ static CGFloat const ItemOrderingTouchesDetectionInset = 10.0;
 
 - (void)removeItem:(MenuItem *)item
 {
+    const NSUInteger itemIndex = [self.treeIndex indexOfItem:item];
+
     // Reassign any children to the parent of the item.
     BOOL parentChildUpdateNeeded = NO;
     if (item.children.count) {
@@ -101,6 +105,7 @@ static CGFloat const ItemOrderingTouchesDetectionInset = 10.0;
     NSManagedObjectContext *managedObjectContext = item.managedObjectContext;
     [managedObjectContext deleteObject:item];
     [managedObjectContext processPendingChanges];
+    [self.treeIndex updateWithOrderedItems:self.menu.items fromIndex:(itemIndex != NSNotFound ? itemIndex : 0)];
     [[ContextManager sharedInstance] saveContext:managedObjectContext];
 }
 
@@ -118,6 +123,7 @@ static CGFloat const ItemOrderingTouchesDetectionInset = 10.0;
     self.isEditingForItemViewInsertion = NO;
     self.itemViewForInsertionToggling = nil;
 
+    self.treeIndex = [[MenuItemTreeIndex alloc] initWithOrderedItems:self.menu.items];
     for (MenuItem *item in self.menu.items) {
         [self addNewItemViewWithItem:item];
     }
@@ -468,7 +474,7 @@ static CGFloat const ItemOrderingTouchesDetectionInset = 10.0;
         if (detectedHorizontalOrderingTouches) {
 
             NSOrderedSet *orderedItems = self.menu.items;
-            NSUInteger selectedItemIndex = [orderedItems indexOfObject:selectedItem];
+            NSUInteger selectedItemIndex = [self.treeIndex indexOfItem:selectedItem];
 
             // check if not first item in order
             if (selectedItemIndex > 0) {
@@ -488,7 +494,8 @@ static CGFloat const ItemOrderingTouchesDetectionInset = 10.0;
 
                     if (newParent) {
                         selectedItem.parent = newParent;
-                        MenuItem *precedingSibling = [selectedItem precedingSiblingInOrderedItems:orderedItems];
+                        [self.treeIndex updateWithOrderedItems:orderedItems fromIndex:selectedItemIndex];
+                        MenuItem *precedingSibling = [self.treeIndex precedingSiblingOfItem:selectedItem];
                         [self announceOrderingChange:newParent parentChanged:YES before:nil after:precedingSibling];
 
                         modelUpdated = YES;
@@ -497,13 +504,14 @@ static CGFloat const ItemOrderingTouchesDetectionInset = 10.0;
                 } else  {
                     if (selectedItem.parent) {
 
-                        MenuItem *lastChildItem = [selectedItem.parent lastDescendantInOrderedItems:orderedItems];
+                        MenuItem *lastChildItem = [self.treeIndex lastChildOfItem:selectedItem.parent];
                         // only the lastChildItem can move up the tree, otherwise it would break the visual child/parent relationship
                         if (selectedItem == lastChildItem) {
                             // try to move up the parent tree
                             MenuItem *parent = selectedItem.parent.parent;
                             selectedItem.parent = parent;
-                            MenuItem *precedingSibling = [selectedItem precedingSiblingInOrderedItems:orderedItems];
+                            [self.treeIndex updateWithOrderedItems:orderedItems fromIndex:selectedItemIndex];
+                            MenuItem *precedingSibling = [self.treeIndex precedingSiblingOfItem:selectedItem];
                             [self announceOrderingChange:parent parentChanged:YES before:nil after:precedingSibling];
 
                             modelUpdated = YES;
@@ -568,7 +576,7 @@ static CGFloat const ItemOrderingTouchesDetectionInset = 10.0;
     MenuItem *otherItem = otherItemView.item;
 
     // can't order a ancestor within a descendant
-    if ([otherItem isDescendantOfItem:item]) {
+    if ([self.treeIndex isItem:otherItem descendantOfItem:item]) {
         return NO;
     }
 
@@ -576,7 +584,8 @@ static CGFloat const ItemOrderingTouchesDetectionInset = 10.0;
 
     NSMutableOrderedSet *orderedItems = [NSMutableOrderedSet orderedSetWithOrderedSet:self.menu.items];
 
-    const BOOL itemIsOrderedBeforeOtherItem = [orderedItems indexOfObject:item] < [orderedItems indexOfObject:otherItem];
+    const NSUInteger itemIndex = [self.treeIndex indexOfItem:item];
+    const BOOL itemIsOrderedBeforeOtherItem = itemIndex < [self.treeIndex indexOfItem:otherItem];
 
     const BOOL orderingTouchesBeforeOtherItem = touchLocation.y < CGRectGetMidY(otherItemView.frame);
     const BOOL orderingTouchesAfterOtherItem = !orderingTouchesBeforeOtherItem; // using additional BOOL for readability
@@ -584,16 +593,10 @@ static CGFloat const ItemOrderingTouchesDetectionInset = 10.0;
     void (^moveItemAndDescendantsOrderingWithOtherItem)(BOOL) = ^ (BOOL afterOtherItem) {
 
         // get the item and its descendants
-        NSMutableArray *movingItems = [NSMutableArray array];
-        for (NSUInteger i = [orderedItems indexOfObject:item]; i < orderedItems.count; i++) {
-            MenuItem *orderedItem = [orderedItems objectAtIndex:i];
-            if (orderedItem != item && ![orderedItem isDescendantOfItem:item]) {
-                break;
-            }
-            [movingItems addObject:orderedItem];
-        }
+        const NSRange movingRange = NSMakeRange(itemIndex, [self.treeIndex subtreeSizeOfItem:item]);
+        NSArray *movingItems = [orderedItems objectsAtIndexes:[NSIndexSet indexSetWithIndexesInRange:movingRange]];
 
-        [orderedItems removeObjectsInArray:movingItems];
+        [orderedItems removeObjectsInRange:movingRange];
 
         // insert the items in new position
         NSUInteger otherItemIndex = [orderedItems indexOfObject:otherItem];
@@ -685,6 +688,7 @@ static CGFloat const ItemOrderingTouchesDetectionInset = 10.0;
         }];
 
         self.menu.items = orderedItems;
+        [self.treeIndex updateWithOrderedItems:orderedItems fromIndex:MIN(itemIndex, [orderedItems indexOfObject:item])];
         [self.delegate itemsViewController:self didUpdateMenuItemsOrdering:self.menu];
     }
 
@@ -693,25 +697,13 @@ static CGFloat const ItemOrderingTouchesDetectionInset = 10.0;
 
 - (MenuItem *)nextAvailableItemForOrderingAfterItem:(MenuItem *)item
 {
-    MenuItem *availableItem = nil;
-    NSUInteger itemIndex = [self.menu.items indexOfObject:item];
-
-    for (NSUInteger i = itemIndex + 1; itemIndex < self.menu.items.count; i++) {
-
-        MenuItem *anItem = [self.menu.items objectAtIndex:i];
-        if (![anItem isDescendantOfItem:item]) {
-            availableItem = anItem;
-            break;
-        }
-    }
-
-    return availableItem;
+    return [self.treeIndex nextItemAfterDescendantsOfItem:item];
 }
 
 - (MenuItem *)nextAvailableItemForOrderingBeforeItem:(MenuItem *)item
 {
-    NSUInteger itemIndex = [self.menu.items indexOfObject:item];
-    if (itemIndex == 0) {
+    NSUInteger itemIndex = [self.treeIndex indexOfItem:item];
+    if (itemIndex == 0 || itemIndex == NSNotFound) {
         return nil;
     }
 
@@ -735,7 +727,7 @@ static CGFloat const ItemOrderingTouchesDetectionInset = 10.0;
         UIView *view = [arrangedViews objectAtIndex:i];
         if ([view isKindOfClass:[MenuItemView class]]) {
             MenuItemView *itemView = (MenuItemView *)view;
-            if ([itemView.item isDescendantOfItem:selectedItemView.item]) {
+            if ([self.treeIndex isItem:itemView.item descendantOfItem:selectedItemView.item]) {
                 itemView.isPlaceholder = showsPlaceholder;
             }
         }
@@ -852,9 +844,9 @@ static CGFloat const ItemOrderingTouchesDetectionInset = 10.0;
             case MenuItemInsertionOrderBelow:
             {
                 if (toggledItem.children.count) {
-                    // Find the last child and insert below it.
-                    MenuItem *lastChild = [toggledItem lastDescendantInOrderedItems:orderedItems];
-                    [orderedItems insertObject:newItem atIndex:[orderedItems indexOfObject:lastChild] + 1];
+                    // Find the last descendant and insert below it.
+                    MenuItem *lastDescendant = [self.treeIndex lastDescendantOfItem:toggledItem];
+                    [orderedItems insertObject:newItem atIndex:[orderedItems indexOfObject:lastDescendant] + 1];
                     requiresOffsetInsertionOrder = YES;
                 } else {
                     [orderedItems insertObject:newItem atIndex:[orderedItems indexOfObject:toggledItem] + 1];
@@ -871,6 +863,7 @@ static CGFloat const ItemOrderingTouchesDetectionInset = 10.0;
 
         // Update the menu items.
         self.menu.items = orderedItems;
+        [self.treeIndex updateWithOrderedItems:orderedItems fromIndex:[orderedItems indexOfObject:newItem]];
 
         // Go ahead and save the context with the new item, we can delete later if needed.
         [[ContextManager sharedInstance] saveContextAndWait:self.menu.managedObjectContext];
@@ -306,7 +306,9 @@ private final class ReaderPostCellView: UIView {
         imageView.isHidden = viewModel.imageURL == nil
 
         if let imageURL = viewModel.imageURL {
-            imageView.setImage(with: imageURL, size: preferredCoverSize)
+            // Featured images can be large originals, so show previews while they download.
+            let options = ImageRequestOptions(size: preferredCoverSize, isProgressiveDecodingEnabled: true)
+            imageView.setImage(with: ImageRequest(url: imageURL, options: options))
         }
 
         if viewModel.isSeen == true {
@@ -42,6 +42,20 @@ final class ReaderCommentsTableViewController: UIViewController, UITableViewData
         } catch {
             wpAssertionFailure("fetch failed", userInfo: ["error": "\(error)"])
         }
+
+        // Comments stored by older versions of the app are sorted by their thread position,
+        // so derive it in the background and fetch again once it's there, rather than waiting for the next sync.
+        CommentService(coreDataStack: ContextManager.shared).backfillThreadOrder(for: post) { [weak self] backfilled in
+            guard backfilled, let self else {
+                return
+            }
+            do {
+                try self.fetchResultsController.performFetch()
+                self.tableView.reloadData()
+            } catch {
+                wpAssertionFailure("fetch failed", userInfo: ["error": "\(error)"])
+            }
+        }
     }
 
     private func setupTableView() {
@@ -140,7 +154,8 @@ final class ReaderCommentsTableViewController: UIViewController, UITableViewData
         let request = NSFetchRequest<Comment>(entityName: Comment.entityName())
         request.predicate = NSPredicate(format: "post = %@ AND status = %@ AND visibleOnReader = YES", post, CommentStatusType.approved.description)
         request.sortDescriptors = [
-            NSSortDescriptor(keyPath: \Comment.hierarchy, ascending: true)
+            NSSortDescriptor(keyPath: \Comment.threadRoot, ascending: true),
+            NSSortDescriptor(keyPath: \Comment.position, ascending: true)
         ]
         request.fetchBatchSize = 40
         return NSFetchedResultsController(fetchRequest: request, managedObjectContext: moc, sectionNameKeyPath: nil, cacheName: nil)
@@ -92,6 +92,10 @@ import AutomatticTracks
     private let cellConfiguration = ReaderCellConfiguration()
 
     private let prefetcher = ImagePrefetcher()
+    /// The last scroll offset and when it was reached, to tell how fast the stream is scrolled.
+    private var lastScrollSample: (offset: CGFloat, time: CFTimeInterval)?
+    /// Rows prefetched while scrolling fast are unlikely to be displayed soon.
+    private var isScrollingFast = false
 
     enum NavigationItemTag: Int {
         case notifications
@@ -1226,12 +1230,14 @@ extension ReaderStreamViewController: WPTableViewHandlerDelegate {
         if decelerate {
             return
         }
+        didStopScrolling()
         if cleanupAndRefreshAfterScrolling {
             cleanupAfterSync()
         }
     }
 
     func scrollViewDidEndDecelerating(_ scrollView: UIScrollView) {
+        didStopScrolling()
         if cleanupAndRefreshAfterScrolling {
             cleanupAfterSync()
         }
@@ -1493,7 +1499,7 @@ extension ReaderStreamViewController: WPTableViewHandlerDelegate {
 
 extension ReaderStreamViewController: UITableViewDataSourcePrefetching {
     func tableView(_ tableView: UITableView, prefetchRowsAt indexPaths: [IndexPath]) {
-        prefetcher.startPrefetching(for: makeImageRequests(for: indexPaths))
+        prefetcher.startPrefetching(for: makeImageRequests(for: indexPaths), priority: isScrollingFast ? .speculative : .nearVisible)
     }
 
     func tableView(_ tableView: UITableView, cancelPrefetchingForRowsAt indexPaths: [IndexPath]) {
@@ -1501,6 +1507,32 @@ extension ReaderStreamViewController: UITableViewDataSourcePrefetching {
 
     }
 
+    fileprivate func updateScrollSpeed(_ scrollView: UIScrollView) {
+        let sample = (offset: scrollView.contentOffset.y, time: CACurrentMediaTime())
+        if let last = lastScrollSample, sample.time > last.time {
+            let speed = abs(sample.offset - last.offset) / CGFloat(sample.time - last.time)
+            isScrollingFast = speed > view.bounds.height * Constants.fastScrollingScreensPerSecond
+        }
+        lastScrollSample = sample
+    }
+
+    /// Raises the priority of the images of the rows about to be displayed, which
+    /// may have been prefetched as speculative while the stream was scrolled fast.
+    fileprivate func didStopScrolling() {
+        isScrollingFast = false
+        lastScrollSample = nil
+
+        guard let indexPaths = tableView.indexPathsForVisibleRows, let first = indexPaths.first, let last = indexPaths.last else {
+            return
+        }
+        let section = last.section
+        let numberOfRows = tableView.numberOfRows(inSection: section)
+        let rowsBelow = (last.row + 1)..<min(numberOfRows, last.row + 1 + Constants.nearVisibleRowCount)
+        let rowsAbove = first.section == section ? max(0, first.row - Constants.nearVisibleRowCount)..<first.row : 0..<0
+        let nearbyIndexPaths = (Array(rowsAbove) + Array(rowsBelow)).map { IndexPath(row: $0, section: section) }
+        prefetcher.setPriority(.nearVisible, for: makeImageRequests(for: nearbyIndexPaths))
+    }
+
     private func makeImageRequests(for indexPaths: [IndexPath]) -> [ImageRequest] {
         guard let window = view.window else { return [] }
         let targetSize = ReaderPostCell.preferredCoverSize(in: window, isCompact: isCompact)
@@ -1508,7 +1540,7 @@ extension ReaderStreamViewController: UITableViewDataSourcePrefetching {
             guard let imageURL = getPost(at: $0)?.featuredImageURLForDisplay() else {
                 return nil
             }
-            return ImageRequest(url: imageURL, options: ImageRequestOptions(size: targetSize))
+            return ImageRequest(url: imageURL, options: ImageRequestOptions(size: targetSize, isProgressiveDecodingEnabled: true))
         }
     }
 }
@@ -1637,6 +1669,7 @@ extension ReaderStreamViewController: UIViewControllerTransitioningDelegate {
 
 extension ReaderStreamViewController: UITableViewDelegate, JPScrollViewDelegate {
     func scrollViewDidScroll(_ scrollView: UIScrollView) {
+        updateScrollSpeed(scrollView)
         layoutEmptyStateView()
         processJetpackBannerVisibility(scrollView)
         titleView.updateAlpha(in: scrollView)
@@ -1644,6 +1677,13 @@ extension ReaderStreamViewController: UITableViewDelegate, JPScrollViewDelegate
     }
 }
 
+private enum Constants {
+    /// The scrolling speed, in screen heights per second, above which prefetched images are speculative.
+    static let fastScrollingScreensPerSecond: CGFloat = 3
+    /// The number of rows above and below the visible ones whose images are prioritized once scrolling stops.
+    static let nearVisibleRowCount = 4
+}
+
 private enum Strings {
     static let postRemoved = NSLocalizedString("reader.savedPostRemovedNotificationTitle", value: "Saved post removed", comment: "Notification title for when saved post is removed")
 }
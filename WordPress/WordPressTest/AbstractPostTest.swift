@@ -36,6 +36,51 @@ class AbstractPostTest: CoreDataTestCase {
         XCTAssertEqual(post.featuredImageURLForDisplay()?.absoluteString, "https://wp.me/awesome.png")
     }
 
+    func testUpdatePathForDisplayImageBasedOnContent() {
+        let post = PostBuilder(mainContext).build()
+        post.content = "<img width=\"300\" src=\"https://wp.me/large.png\"> <img src=\"https://wp.me/small.png\">"
+
+        post.updatePathForDisplayImageBasedOnContent()
+
+        XCTAssertEqual(post.pathForDisplayImage, "https://wp.me/large.png")
+        XCTAssertTrue(post.contentIsIndexed)
+    }
+
+    func testUpdatePathForDisplayImageBasedOnGalleryMedia() {
+        let post = PostBuilder(mainContext).build()
+        let media = MediaBuilder(mainContext).build()
+        media.blog = post.blog
+        media.mediaID = 42
+        media.remoteURL = "https://wp.me/gallery.png"
+        post.content = "[gallery ids=\"41,42\"]"
+
+        post.updatePathForDisplayImageBasedOnContent()
+
+        XCTAssertEqual(post.contentGalleryMediaIDs, [41, 42])
+        XCTAssertEqual(post.pathForDisplayImage, "https://wp.me/gallery.png")
+    }
+
+    func testContentIndexIsOnlyRebuiltWhenContentChanges() {
+        let post = PostBuilder(mainContext).build()
+        post.content = "<img width=\"300\" src=\"https://wp.me/first.png\">"
+        post.updateContentIndexIfNeeded()
+
+        // Tampering with the index shows whether the content is scanned again.
+        post.contentImageToDisplay = "https://wp.me/cached.png"
+        post.updateContentIndexIfNeeded()
+        XCTAssertEqual(post.contentImageToDisplay, "https://wp.me/cached.png")
+
+        // A sync assigning the same content keeps the index.
+        post.content = "<img width=\"300\" src=\"https://wp.me/first.png\">"
+        post.updateContentIndexIfNeeded()
+        XCTAssertEqual(post.contentImageToDisplay, "https://wp.me/cached.png")
+
+        post.content = "<img width=\"300\" src=\"https://wp.me/second.png\">"
+        XCTAssertFalse(post.contentIsIndexed)
+        post.updateContentIndexIfNeeded()
+        XCTAssertEqual(post.contentImageToDisplay, "https://wp.me/second.png")
+    }
+
     func testGetLatestRevisionNeedingSync() {
         // GIVEN a post with no revisions
         let post = PostBuilder(mainContext).build()
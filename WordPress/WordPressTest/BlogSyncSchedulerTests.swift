@@ -0,0 +1,218 @@
+import CoreData
+import XCTest
+@testable import WordPress
+
+final class BlogSyncSchedulerTests: CoreDataTestCase {
+
+    private var blogID: NSManagedObjectID!
+
+    override func setUp() {
+        super.setUp()
+
+        let blog = BlogBuilder(mainContext).build()
+        try? mainContext.obtainPermanentIDs(for: [blog])
+        blogID = blog.objectID
+    }
+
+    func testThatTheNumberOfRunningTasksIsCapped() {
+        let scheduler = BlogSyncScheduler(maxConcurrentTasks: 2)
+        var running = 0
+        var maxRunning = 0
+        let tasks = (0..<6).map { index in
+            makeTask("task-\(index)") { done in
+                running += 1
+                maxRunning = max(maxRunning, running)
+                DispatchQueue.main.asyncAfter(deadline: .now() + 0.01) {
+                    running -= 1
+                    done(true)
+                }
+            }
+        }
+
+        let completed = expectation(description: "All tasks completed")
+        scheduler.sync(tasks, forBlog: blogID) {
+            completed.fulfill()
+        }
+        wait(for: [completed], timeout: 1)
+
+        XCTAssertEqual(maxRunning, 2)
+        XCTAssertEqual(running, 0)
+    }
+
+    func testThatTasksRunAfterTheirDependenciesAndByPriority() {
+        let scheduler = BlogSyncScheduler(maxConcurrentTasks: 1)
+        var order: [String] = []
+        let record: (String) -> BlogSyncTask.Work = { identifier in
+            { done in
+                order.append(identifier)
+                done(true)
+            }
+        }
+        let tasks = [
+            makeTask("editor-settings", priority: .high, dependencies: ["settings"], work: record("editor-settings")),
+            makeTask("post-formats", priority: .low, work: record("post-formats")),
+            makeTask("settings", priority: .normal, work: record("settings")),
+            makeTask("authors", priority: .normal, dependencies: ["not-scheduled"], work: record("authors"))
+        ]
+
+        let completed = expectation(description: "All tasks completed")
+        scheduler.sync(tasks, forBlog: blogID) {
+            completed.fulfill()
+        }
+        wait(for: [completed], timeout: 1)
+
+        XCTAssertEqual(order, ["settings", "editor-settings", "authors", "post-formats"])
+    }
+
+    func testThatFreshTasksAreSkipped() {
+        var now = Date()
+        let scheduler = BlogSyncScheduler(maxConcurrentTasks: 4, now: { now })
+        var runs: [String: Int] = [:]
+        var skipped: [String] = []
+        scheduler.metricsHandler = { metrics in
+            if metrics.outcome == .skipped {
+                skipped.append(metrics.identifier)
+            }
+        }
+        let makeTasks = {
+            [
+                self.makeTask("settings", freshnessInterval: 0) { done in
+                    runs["settings", default: 0] += 1
+                    done(true)
+                },
+                self.makeTask("plans", freshnessInterval: 60) { done in
+                    runs["plans", default: 0] += 1
+                    done(true)
+                },
+                self.makeTask("domains", freshnessInterval: 60) { done in
+                    runs["domains", default: 0] += 1
+                    done(false)
+                }
+            ]
+        }
+
+        for _ in 0..<2 {
+            let completed = expectation(description: "All tasks completed")
+            scheduler.sync(makeTasks(), forBlog: blogID) {
+                completed.fulfill()
+            }
+            wait(for: [completed], timeout: 1)
+            now.addTimeInterval(30)
+        }
+
+        // Failed tasks aren't fresh, and tasks without a freshness interval always run.
+        XCTAssertEqual(runs, ["settings": 2, "plans": 1, "domains": 2])
+
+        now.addTimeInterval(30)
+        let completed = expectation(description: "All tasks completed")
+        scheduler.sync(makeTasks(), forBlog: blogID) {
+            completed.fulfill()
+        }
+        wait(for: [completed], timeout: 1)
+
+        XCTAssertEqual(runs["plans"], 2)
+        XCTAssertEqual(skipped, ["plans"])
+    }
+
+    func testThatTasksThatNeverFinishTimeOut() {
+        let scheduler = BlogSyncScheduler(maxConcurrentTasks: 1, taskTimeout: 0.05)
+        var outcomes: [String: BlogSyncTaskMetrics.Outcome] = [:]
+        scheduler.metricsHandler = { metrics in
+            outcomes[metrics.identifier] = metrics.outcome
+        }
+        var lateDone: ((Bool) -> Void)?
+        let tasks = [
+            makeTask("stuck", priority: .high) { done in
+                lateDone = done
+            },
+            makeTask("settings") { done in
+                done(true)
+            }
+        ]
+
+        let completed = expectation(description: "All tasks completed")
+        scheduler.sync(tasks, forBlog: blogID) {
+            completed.fulfill()
+        }
+        wait(for: [completed], timeout: 1)
+
+        // Calling `done` after the timeout is ignored.
+        lateDone?(true)
+        let flushed = expectation(description: "Late completion handled")
+        scheduler.sync([], forBlog: blogID) {
+            flushed.fulfill()
+        }
+        wait(for: [flushed], timeout: 1)
+
+        XCTAssertEqual(outcomes, ["stuck": .timedOut, "settings": .succeeded])
+    }
+
+    func testThatUserInitiatedSyncsDontWaitForBackgroundSyncs() {
+        let scheduler = BlogSyncScheduler(maxConcurrentTasks: 1)
+        let otherBlog = BlogBuilder(mainContext).build()
+        try? mainContext.obtainPermanentIDs(for: [otherBlog])
+
+        var releaseBackgroundTask: ((Bool) -> Void)?
+        scheduler.sync([makeTask("settings") { done in releaseBackgroundTask = done }], forBlog: otherBlog.objectID, completion: nil)
+        scheduler.sync([makeTask("plans") { done in done(true) }], forBlog: otherBlog.objectID, completion: nil)
+
+        let completed = expectation(description: "User-initiated sync completed")
+        scheduler.sync([makeTask("settings") { done in done(true) }], forBlog: blogID, isUserInitiated: true) {
+            completed.fulfill()
+        }
+        wait(for: [completed], timeout: 1)
+
+        XCTAssertNotNil(releaseBackgroundTask, "The background task should still be running")
+        releaseBackgroundTask?(true)
+    }
+
+    func testThatBlogsTakeTurns() {
+        let scheduler = BlogSyncScheduler(maxConcurrentTasks: 2)
+        let otherBlog = BlogBuilder(mainContext).build()
+        try? mainContext.obtainPermanentIDs(for: [otherBlog])
+
+        var started: [String] = []
+        let record: (String) -> BlogSyncTask.Work = { identifier in
+            { done in
+                started.append(identifier)
+                DispatchQueue.main.asyncAfter(deadline: .now() + 0.05) {
+                    done(true)
+                }
+            }
+        }
+
+        let completed = expectation(description: "All syncs completed")
+        completed.expectedFulfillmentCount = 2
+        scheduler.sync((1...4).map { makeTask("a\($0)", work: record("a\($0)")) }, forBlog: blogID) {
+            completed.fulfill()
+        }
+        scheduler.sync((1...2).map { makeTask("b\($0)", work: record("b\($0)")) }, forBlog: otherBlog.objectID) {
+            completed.fulfill()
+        }
+        wait(for: [completed], timeout: 1)
+
+        // The first blog takes both slots before the other blog is synced. The first slot to free up
+        // goes to the other blog rather than to a third task of the first blog.
+        XCTAssertEqual(Array(started.prefix(3)), ["a1", "a2", "b1"])
+    }
+
+    func testThatEmptySyncCompletes() {
+        let completed = expectation(description: "Sync completed")
+        BlogSyncScheduler(maxConcurrentTasks: 1).sync([], forBlog: blogID) {
+            completed.fulfill()
+        }
+        wait(for: [completed], timeout: 1)
+    }
+
+    // MARK: - Helpers
+
+    private func makeTask(
+        _ identifier: String,
+        priority: BlogSyncTaskPriority = .normal,
+        freshnessInterval: TimeInterval = 0,
+        dependencies: [String] = [],
+        work: @escaping BlogSyncTask.Work
+    ) -> BlogSyncTask {
+        BlogSyncTask(identifier: identifier, priority: priority, freshnessInterval: freshnessInterval, dependencies: dependencies, work: work)
+    }
+}
@@ -1,5 +1,6 @@
 import CoreData
 import XCTest
+import WordPressKit
 @testable import WordPress
 
 final class BlogTests: CoreDataTestCase {
@@ -66,6 +67,59 @@ final class BlogTests: CoreDataTestCase {
         XCTAssertIdentical(blog.lookupPost(withID: post.postID!, in: context)?.managedObjectContext, context)
     }
 
+    func testThatBulkLookupPostsWorks() {
+        let blog = BlogBuilder(mainContext).build()
+        let posts = (1...3).map { index in
+            let post = PostBuilder(mainContext, blog: blog).build()
+            post.postID = NSNumber(value: index)
+            post.foreignID = UUID()
+            return post
+        }
+        let otherBlog = BlogBuilder(mainContext).build()
+        PostBuilder(mainContext, blog: otherBlog).build().postID = 1
+
+        let postsByID = blog.lookupPosts(withIDs: [1, 3, 4], in: mainContext)
+        XCTAssertEqual(postsByID.count, 2)
+        XCTAssertIdentical(postsByID[1], posts[0])
+        XCTAssertIdentical(postsByID[3], posts[2])
+
+        let foreignIDs = posts.compactMap(\.foreignID) + [UUID()]
+        let postsByForeignID = blog.lookupPosts(withForeignIDs: foreignIDs, in: mainContext)
+        XCTAssertEqual(postsByForeignID.count, 3)
+        XCTAssertIdentical(postsByForeignID[foreignIDs[1]], posts[1])
+    }
+
+    func testThatMergingPostsUpdatesMatchesAndPurgesTheRest() {
+        let context = contextManager.newDerivedContext()
+        let blog = BlogBuilder(context).build()
+        let updatedPost = PostBuilder(context, blog: blog).with(status: .publish).build()
+        updatedPost.postID = 1
+        let uploadedPost = PostBuilder(context, blog: blog).with(status: .publish).build()
+        uploadedPost.foreignID = UUID()
+        let purgedPost = PostBuilder(context, blog: blog).with(status: .publish).build()
+        purgedPost.postID = 3
+        purgedPost.postType = "post"
+        contextManager.saveContextAndWait(context)
+
+        let remotePosts = [
+            makeRemotePost(postID: 1),
+            makeRemotePost(postID: 2, foreignID: uploadedPost.foreignID),
+            makeRemotePost(postID: 4),
+            makeRemotePost(postID: 4)
+        ]
+        let posts = PostHelper.mergePosts(remotePosts, ofType: "post", withStatuses: nil, byAuthor: nil, for: blog, purgeExisting: true, in: context, coreDataStack: contextManager) as! [AbstractPost]
+        contextManager.saveContextAndWait(context)
+
+        XCTAssertIdentical(posts[0], updatedPost)
+        XCTAssertIdentical(posts[1], uploadedPost)
+        XCTAssertEqual(uploadedPost.postID, 2)
+        XCTAssertIdentical(posts[2], posts[3])
+        XCTAssertTrue(purgedPost.isDeleted || purgedPost.managedObjectContext == nil)
+
+        let storedIDs = blog.lookupPosts(withIDs: [1, 2, 3, 4], in: mainContext).keys.map(\.intValue)
+        XCTAssertEqual(Set(storedIDs), [1, 2, 4])
+    }
+
     // MARK: - Plugin Management
     func testThatPluginManagementIsDisabledForSimpleSites() {
         let blog = BlogBuilder(mainContext)
@@ -305,4 +359,15 @@ final class BlogTests: CoreDataTestCase {
             try? XCTAssertNotNil(Blog.lookup(withID: 123, in: context))
         }
     }
+
+    // MARK: - Helpers
+
+    private func makeRemotePost(postID: Int, foreignID: UUID? = nil) -> RemotePost {
+        let remotePost = RemotePost()
+        remotePost.postID = NSNumber(value: postID)
+        remotePost.foreignID = foreignID
+        remotePost.type = "post"
+        remotePost.status = "publish"
+        return remotePost
+    }
 }
@@ -42,6 +42,38 @@ final class CommentServiceTests: CoreDataTestCase {
 
         return RemoteLikeUser(dictionary: userDict, commentID: NSNumber(value: 1), siteID: NSNumber(value: 2))
     }
+
+    private func createRemoteComment(id: Int) -> RemoteComment {
+        let remoteComment = RemoteComment()
+        remoteComment.commentID = NSNumber(value: id)
+        remoteComment.content = "Comment \(id)"
+        remoteComment.status = "approve"
+        return remoteComment
+    }
+
+    private func createRemoteComment(id: Int, parentID: Int) -> RemoteComment {
+        let remoteComment = createRemoteComment(id: id)
+        remoteComment.parentID = NSNumber(value: parentID)
+        return remoteComment
+    }
+
+    /// Returns `threads` chains of nested replies, `depth` comments each, in the order the API returns them.
+    private func createRemoteThreads(_ threads: Int, depth: Int) -> [RemoteComment] {
+        (0..<threads).flatMap { thread in
+            (1...depth).map { level in
+                let id = thread * depth + level
+                return createRemoteComment(id: id, parentID: level == 1 ? 0 : id - 1)
+            }
+        }
+    }
+
+    private func insertComments(ids: ClosedRange<Int>, for blog: Blog) {
+        for id in ids {
+            let comment = NSEntityDescription.insertNewObject(forEntityName: Comment.entityName(), into: mainContext) as! Comment
+            comment.commentID = Int32(id)
+            comment.blog = blog
+        }
+    }
 }
 
 // MARK: - Tests
@@ -92,6 +124,152 @@ extension CommentServiceTests {
     }
 }
 
+// MARK: - Merging
+
+extension CommentServiceTests {
+
+    func testMergeCommentsUpdatesExistingAndPurgesMissingComments() throws {
+        // Arrange
+        let blog = BlogBuilder(mainContext).build()
+        insertComments(ids: 1...3, for: blog)
+        let unpublished = NSEntityDescription.insertNewObject(forEntityName: Comment.entityName(), into: mainContext) as! Comment
+        unpublished.blog = blog
+        try mainContext.save()
+
+        // Act
+        service.mergeComments([createRemoteComment(id: 2), createRemoteComment(id: 4)], for: blog, purgeExisting: true)
+
+        // Assert
+        let comments = try XCTUnwrap(blog.comments as? Set<Comment>)
+        expect(comments.map(\.commentID).sorted()) == [0, 2, 4]
+        expect(comments.first { $0.commentID == 2 }?.content) == "Comment 2"
+    }
+
+    func testMergeCommentsWithoutPurgingKeepsExistingComments() throws {
+        // Arrange
+        let blog = BlogBuilder(mainContext).build()
+        insertComments(ids: 1...3, for: blog)
+        try mainContext.save()
+
+        // Act
+        service.mergeComments([createRemoteComment(id: 3), createRemoteComment(id: 4)], for: blog, purgeExisting: false)
+
+        // Assert
+        let comments = try XCTUnwrap(blog.comments as? Set<Comment>)
+        expect(comments.map(\.commentID).sorted()) == [1, 2, 3, 4]
+    }
+
+    func testMergeCommentsPerformance() throws {
+        let blog = BlogBuilder(mainContext).build()
+        insertComments(ids: 1...20_000, for: blog)
+        try mainContext.save()
+
+        // Every other comment is gone on the remote, the rest are updated.
+        let remoteComments = stride(from: 2, through: 20_000, by: 2).map { createRemoteComment(id: $0) }
+
+        measure {
+            service.mergeComments(remoteComments, for: blog, purgeExisting: true)
+        }
+    }
+}
+
+// MARK: - Hierarchical Merging
+
+extension CommentServiceTests {
+
+    func testMergeHierarchicalCommentsOrdersThreadsByPosition() throws {
+        // Arrange
+        let post = ReaderPostBuilder(mainContext).build()
+        let remoteComments = [
+            createRemoteComment(id: 10, parentID: 0),
+            createRemoteComment(id: 12, parentID: 10),
+            createRemoteComment(id: 15, parentID: 12),
+            createRemoteComment(id: 11, parentID: 10),
+            createRemoteComment(id: 20, parentID: 0)
+        ]
+
+        // Act
+        service.mergeHierarchicalComments(remoteComments, forPage: 1, forPost: post)
+
+        // Assert
+        let comments = try XCTUnwrap(post.comments as? Set<Comment>).sorted {
+            ($0.threadRoot, $0.position) < ($1.threadRoot, $1.position)
+        }
+        expect(comments.map(\.commentID)) == [10, 11, 12, 15, 20]
+        expect(comments.map(\.threadRoot)) == [10, 10, 10, 10, 20]
+        expect(comments.map(\.position)) == [0, 1, 2, 3, 0]
+        expect(comments.map(\.depth)) == [0, 1, 1, 2, 0]
+
+        let reply = try XCTUnwrap(comments.first { $0.commentID == 15 })
+        expect(reply.hierarchyKey) == Data([0, 0, 0, 10, 0, 0, 0, 12, 0, 0, 0, 15])
+        expect(reply.isDescendant(of: comments[0])) == true
+        expect(reply.isDescendant(of: comments[1])) == false
+    }
+
+    func testTopLevelCommentsArePagedByThreadRoot() throws {
+        // Arrange
+        let post = ReaderPostBuilder(mainContext).build()
+        service.mergeHierarchicalComments(createRemoteThreads(30, depth: 3), forPage: 1, forPost: post)
+        try mainContext.save()
+
+        // Act
+        let topLevelComments = try XCTUnwrap(service.topLevelComments(30, for: post) as? [Comment])
+
+        // Assert
+        expect(topLevelComments.count) == 20
+        expect(topLevelComments.map(\.commentID)) == (0..<20).map { Int32($0 * 3 + 1) }
+    }
+
+    func testBackfillThreadOrderForMigratedComments() throws {
+        // Arrange comments stored before hierarchy keys existed
+        let post = ReaderPostBuilder(mainContext).build()
+        for (id, parentID) in [(20, 0), (15, 12), (11, 10), (12, 10), (10, 0)] as [(Int32, Int32)] {
+            let comment = Comment(context: mainContext)
+            comment.commentID = id
+            comment.parentID = parentID
+            comment.post = post
+        }
+        try mainContext.save()
+
+        // Act
+        let backfilled = expectation(description: "Thread order backfilled")
+        service.backfillThreadOrder(for: post) { didBackfill in
+            expect(didBackfill) == true
+            backfilled.fulfill()
+        }
+        wait(for: [backfilled], timeout: 1)
+        mainContext.refreshAllObjects()
+
+        // Assert
+        let comments = try XCTUnwrap(post.comments as? Set<Comment>).sorted {
+            ($0.threadRoot, $0.position) < ($1.threadRoot, $1.position)
+        }
+        expect(comments.map(\.commentID)) == [10, 11, 12, 15, 20]
+        expect(comments.map(\.threadRoot)) == [10, 10, 10, 10, 20]
+        expect(comments.map(\.position)) == [0, 1, 2, 3, 0]
+        expect(comments.allSatisfy { $0.hierarchyKey != nil }) == true
+
+        let skipped = expectation(description: "Nothing left to backfill")
+        service.backfillThreadOrder(for: post) { didBackfill in
+            expect(didBackfill) == false
+            skipped.fulfill()
+        }
+        wait(for: [skipped], timeout: 1)
+    }
+
+    func testMergeHierarchicalCommentsPerformance() throws {
+        let post = ReaderPostBuilder(mainContext).build()
+        try mainContext.save()
+
+        // 10k comments in threads of ten nested replies.
+        let remoteComments = createRemoteThreads(1_000, depth: 10)
+
+        measure {
+            service.mergeHierarchicalComments(remoteComments, forPage: 1, forPost: post)
+        }
+    }
+}
+
 // MARK: - Mocks
 
 private class CommentServiceRemoteFactoryMock: CommentServiceRemoteFactory {
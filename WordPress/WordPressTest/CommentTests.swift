@@ -0,0 +1,35 @@
+import CoreData
+import XCTest
+@testable import WordPress
+
+final class CommentTests: CoreDataTestCase {
+
+    func testThatThePreviewOfAShortCommentMatchesItsContent() {
+        let comment = makeComment(content: "<p>Fish &amp; <b>Chips</b></p>\n\n<p>  are   great </p>")
+
+        XCTAssertEqual(comment.contentPreviewForDisplay(), comment.contentForDisplay())
+    }
+
+    func testThatThePreviewOfALongCommentIsTheStartOfItsContent() {
+        // The cut lands in the middle of the last tag, then of the last character reference.
+        let paragraph = "<p>Fish &amp; <b>Chips</b>\n  are   great.</p>"
+        for padding in ["", "<b", "&am"] {
+            let content = String(repeating: "x", count: Comment.contentPreviewPrefixLength - 2) + padding
+                + String(repeating: paragraph, count: 100)
+            let comment = makeComment(content: content)
+
+            let preview = comment.contentPreviewForDisplay()
+            XCTAssertFalse(preview.isEmpty)
+            XCTAssertLessThan(preview.count, comment.contentForDisplay().count)
+            XCTAssertTrue(comment.contentForDisplay().hasPrefix(preview), "Failed with \(padding)")
+        }
+    }
+
+    // MARK: - Helpers
+
+    private func makeComment(content: String) -> Comment {
+        let comment = Comment(context: mainContext)
+        comment.content = content
+        return comment
+    }
+}
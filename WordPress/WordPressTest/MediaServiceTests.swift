@@ -1,5 +1,6 @@
 import Foundation
 @testable import WordPress
+import WordPressKit
 import XCTest
 
 class MediaServiceTests: CoreDataTestCase {
@@ -106,4 +107,41 @@ class MediaServiceTests: CoreDataTestCase {
 
         XCTAssertEqual(failedMediaForUpload.count, 0)
     }
+
+    // MARK: - Tests for MediaLibraryMerger
+
+    func testThatMediaLibraryMergerUpsertsPagesAndDeletesUnreferencedMedia() throws {
+        let blog = BlogBuilder(mainContext).build()
+        let kept = mediaBuilder.with(remoteStatus: .sync).build()
+        kept.mediaID = 1
+        kept.blog = blog
+        let removed = MediaBuilder(mainContext).with(remoteStatus: .sync).build()
+        removed.mediaID = 2
+        removed.blog = blog
+        let local = MediaBuilder(mainContext).with(remoteStatus: .local).build()
+        local.blog = blog
+        try mainContext.save()
+
+        let merger = MediaLibraryMerger(blog: blog, coreDataStack: contextManager)
+        merger.merge([makeRemoteMedia(id: 1, title: "Updated"), makeRemoteMedia(id: 3)])
+        merger.merge([makeRemoteMedia(id: 4)])
+        merger.merge([makeRemoteMedia(id: 1, title: "Updated"), makeRemoteMedia(id: 3), makeRemoteMedia(id: 4), makeRemoteMedia(id: 5)])
+        merger.deleteUnreferencedMedia()
+
+        let request = NSFetchRequest<Media>(entityName: Media.entityName())
+        request.predicate = NSPredicate(format: "blog = %@", blog)
+        let media = try mainContext.fetch(request)
+        XCTAssertEqual(Set(media.compactMap { $0.mediaID?.intValue }), [0, 1, 3, 4, 5])
+        XCTAssertEqual(media.count, 5)
+        XCTAssertEqual(kept.title, "Updated")
+        XCTAssertTrue(removed.isDeleted || removed.managedObjectContext == nil)
+    }
+
+    private func makeRemoteMedia(id: Int, title: String = "Title") -> RemoteMedia {
+        let remoteMedia = RemoteMedia()
+        remoteMedia.mediaID = NSNumber(value: id)
+        remoteMedia.title = title
+        remoteMedia.mimeType = "image/jpeg"
+        return remoteMedia
+    }
 }
@@ -123,8 +123,98 @@ class MenuItemTests: CoreDataTestCase {
         XCTAssertEqual(precedingSiblingForItemF, itemE)
     }
 
+    /// Tests that the tree index answers the same queries as the ordered items helpers.
+    func testTreeIndexQueries() {
+        let items = newMenuItemTree()
+        let (itemA, itemB, itemC, itemD, itemE, itemF) = (items[0], items[1], items[2], items[3], items[4], items[5])
+        let index = MenuItemTreeIndex(orderedItems: NSOrderedSet(array: items))
+
+        XCTAssertTrue(index.isItem(itemB, descendantOf: itemA))
+        XCTAssertTrue(index.isItem(itemC, descendantOf: itemA))
+        XCTAssertTrue(index.isItem(itemF, descendantOf: itemD))
+        XCTAssertFalse(index.isItem(itemF, descendantOf: itemA))
+        XCTAssertFalse(index.isItem(itemA, descendantOf: itemA))
+
+        XCTAssertEqual(index.lastChild(of: itemA), itemB)
+        XCTAssertNil(index.lastChild(of: itemC))
+        XCTAssertEqual(index.lastChild(of: itemD), itemF)
+        XCTAssertEqual(index.lastDescendant(of: itemA), itemC)
+        XCTAssertNil(index.lastDescendant(of: itemC))
+
+        XCTAssertNil(index.precedingSibling(of: itemA))
+        XCTAssertEqual(index.precedingSibling(of: itemD), itemA)
+        XCTAssertEqual(index.precedingSibling(of: itemF), itemE)
+
+        XCTAssertEqual(index.subtreeSize(of: itemA), 3)
+        XCTAssertEqual(index.nextItemAfterDescendants(of: itemA), itemD)
+        XCTAssertNil(index.nextItemAfterDescendants(of: itemD))
+    }
+
+    /// Tests that updating the index after a change matches indexing the items from scratch.
+    func testTreeIndexIncrementalUpdates() {
+        var items = newMenuItemTree()
+        let (itemA, itemB, itemC, itemD, itemE, itemF) = (items[0], items[1], items[2], items[3], items[4], items[5])
+        let index = MenuItemTreeIndex(orderedItems: NSOrderedSet(array: items))
+
+        // Item B moves up to the top-level, keeping Item C as a child.
+        itemB.parent = nil
+        index.update(withOrderedItems: NSOrderedSet(array: items), from: 1)
+        assertIndex(index, matches: items)
+        XCTAssertEqual(index.precedingSibling(of: itemB), itemA)
+        XCTAssertEqual(index.nextItemAfterDescendants(of: itemA), itemB)
+        XCTAssertTrue(index.isItem(itemC, descendantOf: itemB))
+        XCTAssertNil(index.lastChild(of: itemA))
+
+        // Item B and its descendants are ordered after Item E, as a child of Item D.
+        itemB.parent = itemD
+        items = [itemA, itemD, itemE, itemB, itemC, itemF]
+        index.update(withOrderedItems: NSOrderedSet(array: items), from: 1)
+        assertIndex(index, matches: items)
+        XCTAssertEqual(index.precedingSibling(of: itemF), itemB)
+        XCTAssertEqual(index.lastDescendant(of: itemD), itemF)
+        XCTAssertEqual(index.subtreeSize(of: itemD), 5)
+
+        // A new item is inserted as a child of Item A.
+        let itemG = newMenuItem(named: "Item G")
+        itemG.parent = itemA
+        items.insert(itemG, at: 1)
+        index.update(withOrderedItems: NSOrderedSet(array: items), from: 1)
+        assertIndex(index, matches: items)
+        XCTAssertEqual(index.lastChild(of: itemA), itemG)
+        XCTAssertNil(index.precedingSibling(of: itemG))
+        XCTAssertEqual(index.precedingSibling(of: itemD), itemA)
+    }
+
     // MARK: - Private Helpers
 
+    /*
+     Item A
+     -- Item B
+     ---- Item C
+     Item D
+     -- Item E
+     -- Item F
+     */
+    fileprivate func newMenuItemTree() -> [MenuItem] {
+        let items = ["A", "B", "C", "D", "E", "F"].map { newMenuItem(named: "Item \($0)") }
+        items[1].parent = items[0]
+        items[2].parent = items[1]
+        items[4].parent = items[3]
+        items[5].parent = items[3]
+        return items
+    }
+
+    fileprivate func assertIndex(_ index: MenuItemTreeIndex, matches items: [MenuItem], file: StaticString = #file, line: UInt = #line) {
+        let rebuilt = MenuItemTreeIndex(orderedItems: NSOrderedSet(array: items))
+        XCTAssertEqual(index.orderedItems, items, file: file, line: line)
+        for item in items {
+            XCTAssertEqual(index.index(of: item), rebuilt.index(of: item), file: file, line: line)
+            XCTAssertEqual(index.subtreeSize(of: item), rebuilt.subtreeSize(of: item), file: file, line: line)
+            XCTAssertEqual(index.lastChild(of: item), rebuilt.lastChild(of: item), file: file, line: line)
+            XCTAssertEqual(index.precedingSibling(of: item), rebuilt.precedingSibling(of: item), file: file, line: line)
+        }
+    }
+
     fileprivate func newMenuItem(named name: String) -> MenuItem {
         let entityName = MenuItem.classNameWithoutNamespaces()
         let entity = NSEntityDescription.insertNewObject(forEntityName: entityName, into: mainContext)
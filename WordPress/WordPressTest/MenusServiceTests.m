@@ -7,6 +7,12 @@
 #import "WordPressTest-Swift.h"
 
 @import OCMock;
+@import WordPressKit;
+
+@interface MenusService (Testing)
+- (NSArray<RemoteMenuItem *> *)remoteItemsFromMenuItems:(NSOrderedSet<MenuItem *> *)menuItems;
+- (Menu *)menuFromRemoteMenu:(RemoteMenu *)remoteMenu;
+@end
 
 @interface MenusServiceTests : XCTestCase
 @property (nonatomic, strong) id<CoreDataStack> manager;
@@ -216,4 +222,96 @@
                                  failure:^(NSError * __unused error) {}]);
 }
 
+- (void)testThatRemoteItemsFromMenuItemsNestChildrenInOrder
+{
+    NSManagedObjectContext *context = self.manager.mainContext;
+    MenuItem *first = [self insertMenuItemWithID:@1 parent:nil inContext:context];
+    MenuItem *firstChild = [self insertMenuItemWithID:@2 parent:first inContext:context];
+    MenuItem *grandchild = [self insertMenuItemWithID:@3 parent:firstChild inContext:context];
+    MenuItem *secondChild = [self insertMenuItemWithID:@4 parent:first inContext:context];
+    MenuItem *second = [self insertMenuItemWithID:@5 parent:nil inContext:context];
+    NSOrderedSet *items = [NSOrderedSet orderedSetWithArray:@[first, firstChild, grandchild, secondChild, second]];
+
+    MenusService *service = [[MenusService alloc] initWithManagedObjectContext:context];
+    NSArray<RemoteMenuItem *> *remoteItems = [service remoteItemsFromMenuItems:items];
+
+    XCTAssertEqualObjects([remoteItems valueForKey:@"itemID"], (@[@1, @5]));
+    XCTAssertEqualObjects([remoteItems[0].children valueForKey:@"itemID"], (@[@2, @4]));
+    XCTAssertEqualObjects([remoteItems[0].children[0].children valueForKey:@"itemID"], @[@3]);
+    XCTAssertEqual(remoteItems[0].children[1].children.count, 0);
+    XCTAssertEqual(remoteItems[1].children.count, 0);
+    XCTAssertEqualObjects(remoteItems[0].children[0].typeFamily, @"post_type");
+}
+
+- (void)testThatMenuFromRemoteMenuKeepsTreeOrder
+{
+    NSManagedObjectContext *context = self.manager.mainContext;
+    RemoteMenuItem *grandchild = [self remoteMenuItemWithID:@3 children:nil];
+    RemoteMenuItem *firstChild = [self remoteMenuItemWithID:@2 children:@[grandchild]];
+    RemoteMenuItem *secondChild = [self remoteMenuItemWithID:@4 children:nil];
+    RemoteMenuItem *first = [self remoteMenuItemWithID:@1 children:@[firstChild, secondChild]];
+    RemoteMenuItem *second = [self remoteMenuItemWithID:@5 children:nil];
+    RemoteMenu *remoteMenu = [[RemoteMenu alloc] init];
+    remoteMenu.items = @[first, second];
+
+    MenusService *service = [[MenusService alloc] initWithManagedObjectContext:context];
+    Menu *menu = [service menuFromRemoteMenu:remoteMenu];
+
+    XCTAssertEqualObjects([menu.items.array valueForKey:@"itemID"], (@[@1, @2, @3, @4, @5]));
+    XCTAssertNil(menu.items[0].parent);
+    XCTAssertEqual(menu.items[1].parent, menu.items[0]);
+    XCTAssertEqual(menu.items[2].parent, menu.items[1]);
+    XCTAssertEqual(menu.items[3].parent, menu.items[0]);
+    XCTAssertNil(menu.items[4].parent);
+    XCTAssertEqual(menu.items[4].menu, menu);
+}
+
+- (void)testRemoteItemsFromLargeMenuPerformance
+{
+    // 2,000 items: 200 top-level items, each with 3 children having 2 children of their own.
+    NSManagedObjectContext *context = self.manager.mainContext;
+    NSMutableOrderedSet *items = [NSMutableOrderedSet orderedSet];
+    NSInteger itemID = 1;
+    for (NSInteger i = 0; i < 200; i++) {
+        MenuItem *topLevel = [self insertMenuItemWithID:@(itemID++) parent:nil inContext:context];
+        [items addObject:topLevel];
+        for (NSInteger j = 0; j < 3; j++) {
+            MenuItem *child = [self insertMenuItemWithID:@(itemID++) parent:topLevel inContext:context];
+            [items addObject:child];
+            for (NSInteger k = 0; k < 2; k++) {
+                [items addObject:[self insertMenuItemWithID:@(itemID++) parent:child inContext:context]];
+            }
+        }
+    }
+    XCTAssertEqual(items.count, 2000);
+
+    MenusService *service = [[MenusService alloc] initWithManagedObjectContext:context];
+    [self measureBlock:^{
+        NSArray<RemoteMenuItem *> *remoteItems = [service remoteItemsFromMenuItems:items];
+        XCTAssertEqual(remoteItems.count, 200);
+    }];
+}
+
+#pragma mark - Helpers
+
+- (MenuItem *)insertMenuItemWithID:(NSNumber *)itemID parent:(MenuItem *)parent inContext:(NSManagedObjectContext *)context
+{
+    MenuItem *item = [NSEntityDescription insertNewObjectForEntityForName:[MenuItem entityName] inManagedObjectContext:context];
+    item.itemID = itemID;
+    item.name = [NSString stringWithFormat:@"Item %@", itemID];
+    item.type = MenuItemTypePage;
+    item.parent = parent;
+    return item;
+}
+
+- (RemoteMenuItem *)remoteMenuItemWithID:(NSNumber *)itemID children:(NSArray<RemoteMenuItem *> *)children
+{
+    RemoteMenuItem *item = [[RemoteMenuItem alloc] init];
+    item.itemID = itemID;
+    item.name = [NSString stringWithFormat:@"Item %@", itemID];
+    item.type = MenuItemTypePage;
+    item.children = children;
+    return item;
+}
+
 @end
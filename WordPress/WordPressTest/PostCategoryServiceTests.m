@@ -136,6 +136,39 @@
     [self waitForExpectations:@[completion] timeout:1];
 }
 
+- (void)testSyncSkipsMergingUnchangedCategories
+{
+    TaxonomyServiceRemoteREST *remote = self.service.remoteForStubbing;
+    RemotePostCategory *remoteCategory = [RemotePostCategory new];
+    remoteCategory.categoryID = @10;
+    remoteCategory.name = @"Travel";
+    NSMutableArray *remoteCategories = [NSMutableArray arrayWithObject:remoteCategory];
+    OCMStub([remote getCategoriesWithSuccess:([OCMArg invokeBlockWithArgs:remoteCategories, nil])
+                                     failure:[OCMArg isNotNil]]);
+    [self.manager saveContextAndWait:self.manager.mainContext];
+
+    BlogMetadataFreshness *freshness = [BlogMetadataFreshness shared];
+    [self syncCategories];
+    PostCategory *category = [PostCategory lookupWithBlogObjectID:self.blog.objectID categoryID:@10 inContext:self.manager.mainContext];
+    XCTAssertEqualObjects(category.categoryName, @"Travel");
+    XCTAssertTrue([freshness isFingerprint:[freshness fingerprintForCategories:remoteCategories] mergedForEndpoint:@"categories" blogID:self.blog.objectID]);
+
+    // The same payload is merged again once the categories change locally.
+    category.categoryName = @"Local";
+    [self.manager saveContextAndWait:self.manager.mainContext];
+    XCTAssertFalse([freshness isFingerprint:[freshness fingerprintForCategories:remoteCategories] mergedForEndpoint:@"categories" blogID:self.blog.objectID]);
+    [self syncCategories];
+    [self.manager.mainContext refreshObject:category mergeChanges:NO];
+    XCTAssertEqualObjects(category.categoryName, @"Travel");
+
+    RemotePostCategory *newCategory = [RemotePostCategory new];
+    newCategory.categoryID = @11;
+    newCategory.name = @"Food";
+    [remoteCategories addObject:newCategory];
+    [self syncCategories];
+    XCTAssertNotNil([PostCategory lookupWithBlogObjectID:self.blog.objectID categoryID:@11 inContext:self.manager.mainContext]);
+}
+
 - (void)testSyncFailureShouldBeCalledOnce
 {
     TaxonomyServiceRemoteREST *remote = self.service.remoteForStubbing;
@@ -149,4 +182,15 @@
     [self waitForExpectations:@[completion] timeout:1];
 }
 
+#pragma mark - Helpers
+
+- (void)syncCategories
+{
+    XCTestExpectation *completion = [self expectationWithDescription:@"The categories are synced"];
+    [self.service syncCategoriesForBlog:self.blog
+                                success:^{ [completion fulfill]; }
+                                failure:^(NSError * _Nonnull __unused error) { XCTFail(@"The sync should succeed"); }];
+    [self waitForExpectations:@[completion] timeout:1];
+}
+
 @end
@@ -8,9 +8,12 @@
 #import "WordPressTest-Swift.h"
 @import WordPressKit;
 
+extern NSUInteger const ReaderPostServiceMaxPosts;
+
 @interface ReaderPostService()
 
 - (ReaderPost *)createOrReplaceFromRemotePost:(RemoteReaderPost *)remotePost forTopic:(ReaderAbstractTopic *)topic inContext:(NSManagedObjectContext *)context;
+- (BOOL)checkIfRemotePosts:(NSArray *)remotePosts overlapExistingPosts:(NSDictionary<NSString *, ReaderPost *> *)existingPosts inTopic:(ReaderAbstractTopic *)readerTopic;
 
 @end
 
@@ -48,4 +51,136 @@
     XCTAssertEqual([coreDataStack.mainContext countForFetchRequest:[ReaderPost fetchRequest] error:nil], 0, @"The post should have been deleted.");
 }
 
+- (void)testOverlapDetectionUsesPrefetchedPosts {
+    id<CoreDataStack> coreDataStack = [self coreDataStackForTesting];
+    NSManagedObjectContext *context = coreDataStack.mainContext;
+    ReaderPostService *service = [[ReaderPostService alloc] initWithCoreDataStack:coreDataStack];
+
+    ReaderAbstractTopic *topic = [NSEntityDescription insertNewObjectForEntityForName:@"ReaderTagTopic" inManagedObjectContext:context];
+
+    RemoteReaderPost *cachedPost = [self remoteReaderPostForTests];
+    cachedPost.globalID = @"1";
+    cachedPost.sortDate = [NSDate dateWithTimeIntervalSince1970:1000];
+    [ReaderPost createOrReplaceFromRemotePost:cachedPost forTopic:topic context:context];
+
+    RemoteReaderPost *newPost = [self remoteReaderPostForTests];
+    newPost.globalID = @"2";
+    newPost.sortDate = [NSDate dateWithTimeIntervalSince1970:2000];
+
+    RemoteReaderPost *samePost = [self remoteReaderPostForTests];
+    samePost.globalID = @"1";
+    samePost.sortDate = cachedPost.sortDate;
+
+    RemoteReaderPost *updatedPost = [self remoteReaderPostForTests];
+    updatedPost.globalID = @"1";
+    updatedPost.sortDate = [NSDate dateWithTimeIntervalSince1970:3000];
+
+    NSArray *overlapping = @[newPost, samePost];
+    NSDictionary *existingPosts = [ReaderPost postsForRemotePosts:overlapping forTopic:topic context:context];
+    XCTAssertEqual(existingPosts.count, 1);
+    XCTAssertTrue([service checkIfRemotePosts:overlapping overlapExistingPosts:existingPosts inTopic:topic]);
+
+    NSArray *updated = @[newPost, updatedPost];
+    existingPosts = [ReaderPost postsForRemotePosts:updated forTopic:topic context:context];
+    XCTAssertFalse([service checkIfRemotePosts:updated overlapExistingPosts:existingPosts inTopic:topic], @"A post with a new date is an update, not an overlap.");
+}
+
+- (void)testDeletePostsInExcessOfMaxAllowedKeepsSavedPosts {
+    id<CoreDataStack> coreDataStack = [self coreDataStackForTesting];
+    NSManagedObjectContext *context = coreDataStack.mainContext;
+    ReaderPostService *service = [[ReaderPostService alloc] initWithCoreDataStack:coreDataStack];
+    ReaderAbstractTopic *topic = [self insertTopicWithPosts:400 inContext:context];
+
+    ReaderPost *savedPost = [self postWithRank:10 inContext:context];
+    savedPost.isSavedForLater = YES;
+    [context save:nil];
+
+    [service deletePostsInExcessOfMaxAllowedForTopic:topic inContext:context];
+
+    NSFetchRequest *request = [ReaderPost fetchRequest];
+    request.predicate = [NSPredicate predicateWithFormat:@"topic = %@", topic];
+    XCTAssertEqual([context countForFetchRequest:request error:nil], ReaderPostServiceMaxPosts);
+    XCTAssertEqual([context countForFetchRequest:[ReaderPost fetchRequest] error:nil], ReaderPostServiceMaxPosts + 1);
+    XCTAssertNil(savedPost.topic, @"The saved post should only be removed from the topic.");
+    XCTAssertNil([self postWithRank:20 inContext:context], @"Posts ranked lowest should be deleted.");
+    XCTAssertNotNil([self postWithRank:399 inContext:context]);
+}
+
+- (void)testDeletePostsInExcessOfMaxAllowedIncludesUnsavedPosts {
+    id<CoreDataStack> coreDataStack = [self coreDataStackForTesting];
+    NSManagedObjectContext *context = coreDataStack.mainContext;
+    ReaderPostService *service = [[ReaderPostService alloc] initWithCoreDataStack:coreDataStack];
+    ReaderAbstractTopic *topic = [self insertTopicWithPosts:400 inContext:context];
+
+    [service deletePostsInExcessOfMaxAllowedForTopic:topic inContext:context];
+
+    NSFetchRequest *request = [ReaderPost fetchRequest];
+    request.predicate = [NSPredicate predicateWithFormat:@"topic = %@", topic];
+    XCTAssertTrue(context.hasChanges, @"Saving is left to the caller.");
+    XCTAssertEqual([context countForFetchRequest:request error:nil], ReaderPostServiceMaxPosts);
+    XCTAssertNil([self postWithRank:20 inContext:context], @"Unsaved posts should be trimmed too.");
+    XCTAssertNotNil([self postWithRank:399 inContext:context]);
+}
+
+- (void)testDeletePostsInExcessOfMaxAllowedUsesPendingChanges {
+    id<CoreDataStack> coreDataStack = [self coreDataStackForTesting];
+    NSManagedObjectContext *context = coreDataStack.mainContext;
+    ReaderPostService *service = [[ReaderPostService alloc] initWithCoreDataStack:coreDataStack];
+    ReaderAbstractTopic *topic = [self insertTopicWithPosts:400 inContext:context];
+    [context save:nil];
+
+    // Moved to the top of the topic, but not saved yet.
+    ReaderPost *bumpedPost = [self postWithRank:10 inContext:context];
+    bumpedPost.sortRank = @1000;
+
+    [service deletePostsInExcessOfMaxAllowedForTopic:topic inContext:context];
+
+    XCTAssertFalse(bumpedPost.isDeleted);
+    XCTAssertEqualObjects(bumpedPost.sortRank, @1000, @"Pending changes should not be discarded.");
+    XCTAssertNil([self postWithRank:20 inContext:context]);
+    XCTAssertTrue([context save:nil]);
+
+    NSFetchRequest *request = [ReaderPost fetchRequest];
+    request.predicate = [NSPredicate predicateWithFormat:@"topic = %@", topic];
+    XCTAssertEqual([context countForFetchRequest:request error:nil], ReaderPostServiceMaxPosts);
+}
+
+- (void)testDeletePostsInExcessOfMaxAllowedPerformance {
+    id<CoreDataStack> coreDataStack = [self coreDataStackForTesting];
+    NSManagedObjectContext *context = coreDataStack.mainContext;
+    ReaderPostService *service = [[ReaderPostService alloc] initWithCoreDataStack:coreDataStack];
+
+    [self measureMetrics:[[self class] defaultPerformanceMetrics] automaticallyStartMeasuring:NO forBlock:^{
+        ReaderAbstractTopic *topic = [self insertTopicWithPosts:2000 inContext:context];
+        [context save:nil];
+
+        [self startMeasuring];
+        [service deletePostsInExcessOfMaxAllowedForTopic:topic inContext:context];
+        [self stopMeasuring];
+    }];
+}
+
+#pragma mark - Helpers
+
+- (ReaderAbstractTopic *)insertTopicWithPosts:(NSUInteger)count inContext:(NSManagedObjectContext *)context
+{
+    ReaderAbstractTopic *topic = [NSEntityDescription insertNewObjectForEntityForName:@"ReaderTagTopic" inManagedObjectContext:context];
+    [topic setValue:[NSUUID UUID].UUIDString forKey:@"path"];
+
+    for (NSUInteger rank = 0; rank < count; rank++) {
+        ReaderPost *post = [NSEntityDescription insertNewObjectForEntityForName:@"ReaderPost" inManagedObjectContext:context];
+        post.globalID = [NSString stringWithFormat:@"%lu", (unsigned long)rank];
+        post.sortRank = @(rank);
+        post.topic = topic;
+    }
+    return topic;
+}
+
+- (ReaderPost *)postWithRank:(NSUInteger)rank inContext:(NSManagedObjectContext *)context
+{
+    NSFetchRequest *request = [ReaderPost fetchRequest];
+    request.predicate = [NSPredicate predicateWithFormat:@"sortRank = %@", @(rank)];
+    return [context executeFetchRequest:request error:nil].firstObject;
+}
+
 @end
@@ -1,5 +1,6 @@
 import UIKit
 import XCTest
+import WordPressKit
 
 @testable import WordPress
 
@@ -19,4 +20,43 @@ final class ReaderPostTests: CoreDataTestCase {
         XCTAssertEqual(queryItems.first(where: { $0.name == "s" })?.value, Int(50 * UITraitCollection.current.displayScale).description)
         XCTAssertEqual(queryItems.first(where: { $0.name == "d" })?.value, "404")
     }
+
+    func testCreateOrReplaceFromRemotePostsUpdatesExistingPosts() throws {
+        // Arrange
+        let existing = ReaderPost.createOrReplace(fromRemotePost: makeRemotePost(globalID: "1", title: "Old"), for: nil, context: mainContext)
+        try mainContext.save()
+
+        // Act
+        let remotePosts = ["1", "2", "2"].map { makeRemotePost(globalID: $0, title: "New \($0)") }
+        let posts = ReaderPost.createOrReplace(fromRemotePosts: remotePosts, for: nil, context: mainContext)
+
+        // Assert
+        XCTAssertEqual(posts.map(\.globalID), ["1", "2", "2"])
+        XCTAssertTrue(posts[0] === existing)
+        XCTAssertTrue(posts[1] === posts[2])
+        XCTAssertEqual(posts[0].postTitle, "New 1")
+        XCTAssertEqual(try mainContext.count(for: ReaderPost.fetchRequest()), 2)
+    }
+
+    func testCreateOrReplaceFromRemotePostsPerformance() throws {
+        let storedPosts = (0..<5_000).map { makeRemotePost(globalID: "\($0)", title: "Post \($0)") }
+        _ = ReaderPost.createOrReplace(fromRemotePosts: storedPosts, for: nil, context: mainContext)
+        try mainContext.save()
+
+        // Half of the page is already stored, the other half is new.
+        let page = (4_900..<5_100).map { makeRemotePost(globalID: "\($0)", title: "Updated \($0)") }
+
+        measure {
+            _ = ReaderPost.createOrReplace(fromRemotePosts: page, for: nil, context: mainContext)
+        }
+    }
+
+    private func makeRemotePost(globalID: String, title: String) -> RemoteReaderPost {
+        let remotePost = RemoteReaderPost()
+        remotePost.globalID = globalID
+        remotePost.postTitle = title
+        remotePost.content = ""
+        remotePost.sortRank = 1
+        return remotePost
+    }
 }
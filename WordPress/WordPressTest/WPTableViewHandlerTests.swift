@@ -0,0 +1,149 @@
+import CoreData
+import XCTest
+@testable import WordPress
+
+final class WPTableViewHandlerTests: CoreDataTestCase {
+
+    private var tableView: TableViewSpy!
+    private var handler: WPTableViewHandler!
+    private var controller: NSFetchedResultsController<NSFetchRequestResult>!
+
+    override func setUp() {
+        super.setUp()
+
+        tableView = TableViewSpy()
+        handler = WPTableViewHandler(tableView: tableView)
+        handler.coalescesContentChanges = true
+        controller = NSFetchedResultsController(
+            fetchRequest: NSFetchRequest(entityName: Blog.entityName()),
+            managedObjectContext: mainContext,
+            sectionNameKeyPath: nil,
+            cacheName: nil
+        )
+        tableView.reset()
+    }
+
+    override func tearDown() {
+        handler = nil
+        tableView = nil
+        controller = nil
+
+        super.tearDown()
+    }
+
+    func testThatChangesAreAppliedInOneBatch() {
+        applyChanges {
+            handler.controller(controller, didChange: NSObject(), at: nil, for: .insert, newIndexPath: IndexPath(row: 0, section: 0))
+            handler.controller(controller, didChange: NSObject(), at: IndexPath(row: 3, section: 0), for: .delete, newIndexPath: nil)
+            handler.controller(controller, didChange: NSObject(), at: IndexPath(row: 5, section: 0), for: .update, newIndexPath: nil)
+        }
+
+        XCTAssertEqual(tableView.batchUpdateCount, 1)
+        XCTAssertEqual(tableView.insertedRows, [IndexPath(row: 0, section: 0)])
+        XCTAssertEqual(tableView.deletedRows, [IndexPath(row: 3, section: 0)])
+        XCTAssertEqual(tableView.reloadedRows, [IndexPath(row: 5, section: 0)])
+        XCTAssertEqual(tableView.reloadDataCount, 0)
+    }
+
+    func testThatRepeatedChangesToARowAreAppliedOnce() {
+        applyChanges {
+            for _ in 0..<3 {
+                handler.controller(controller, didChange: NSObject(), at: IndexPath(row: 2, section: 0), for: .update, newIndexPath: nil)
+            }
+        }
+
+        XCTAssertEqual(tableView.batchUpdateCount, 1)
+        XCTAssertEqual(tableView.reloadedRows, [IndexPath(row: 2, section: 0)])
+    }
+
+    func testThatDeletedRowsAreNotReloaded() {
+        applyChanges {
+            handler.controller(controller, didChange: NSObject(), at: IndexPath(row: 1, section: 0), for: .update, newIndexPath: nil)
+            handler.controller(controller, didChange: NSObject(), at: IndexPath(row: 1, section: 0), for: .delete, newIndexPath: nil)
+            handler.controller(controller, didChange: NSObject(), at: IndexPath(row: 4, section: 0), for: .update, newIndexPath: nil)
+        }
+
+        XCTAssertEqual(tableView.deletedRows, [IndexPath(row: 1, section: 0)])
+        XCTAssertEqual(tableView.reloadedRows, [IndexPath(row: 4, section: 0)])
+    }
+
+    func testThatTheTableIsReloadedWhenThereAreTooManyChanges() {
+        handler.coalescedChangesReloadThreshold = 3
+
+        applyChanges {
+            for row in 0..<4 {
+                handler.controller(controller, didChange: NSObject(), at: nil, for: .insert, newIndexPath: IndexPath(row: row, section: 0))
+            }
+        }
+
+        XCTAssertEqual(tableView.reloadDataCount, 1)
+        XCTAssertEqual(tableView.batchUpdateCount, 0)
+        XCTAssertTrue(tableView.insertedRows.isEmpty)
+    }
+
+    func testThatTheTableIsUpdatedAtTheThreshold() {
+        handler.coalescedChangesReloadThreshold = 3
+
+        applyChanges {
+            handler.controller(controller, didChange: NSObject(), atSectionIndex: 1, for: .insert)
+            for row in 0..<2 {
+                handler.controller(controller, didChange: NSObject(), at: nil, for: .insert, newIndexPath: IndexPath(row: row, section: 1))
+            }
+        }
+
+        XCTAssertEqual(tableView.reloadDataCount, 0)
+        XCTAssertEqual(tableView.batchUpdateCount, 1)
+        XCTAssertEqual(tableView.insertedSections, IndexSet(integer: 1))
+    }
+
+    // MARK: - Helpers
+
+    private func applyChanges(_ changes: () -> Void) {
+        handler.controllerWillChangeContent(controller)
+        changes()
+        handler.controllerDidChangeContent(controller)
+    }
+}
+
+private final class TableViewSpy: UITableView {
+    private(set) var batchUpdateCount = 0
+    private(set) var reloadDataCount = 0
+    private(set) var insertedSections = IndexSet()
+    private(set) var insertedRows: [IndexPath] = []
+    private(set) var deletedRows: [IndexPath] = []
+    private(set) var reloadedRows: [IndexPath] = []
+
+    func reset() {
+        batchUpdateCount = 0
+        reloadDataCount = 0
+    }
+
+    override func performBatchUpdates(_ updates: (() -> Void)?, completion: ((Bool) -> Void)? = nil) {
+        batchUpdateCount += 1
+        updates?()
+        completion?(true)
+    }
+
+    override func reloadData() {
+        reloadDataCount += 1
+    }
+
+    override func insertSections(_ sections: IndexSet, with animation: UITableView.RowAnimation) {
+        insertedSections.formUnion(sections)
+    }
+
+    override func deleteSections(_ sections: IndexSet, with animation: UITableView.RowAnimation) {
+    }
+
+    override func insertRows(at indexPaths: [IndexPath], with animation: UITableView.RowAnimation) {
+        insertedRows += indexPaths
+    }
+
+    override func deleteRows(at indexPaths: [IndexPath], with animation: UITableView.RowAnimation) {
+        deletedRows += indexPaths
+    }
+
+    override func reloadRows(at indexPaths: [IndexPath], with animation: UITableView.RowAnimation) {
+        reloadedRows += indexPaths
+    }
+}
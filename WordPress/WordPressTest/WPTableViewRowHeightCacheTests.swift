@@ -0,0 +1,77 @@
+import CoreData
+import XCTest
+@testable import WordPress
+
+final class WPTableViewRowHeightCacheTests: CoreDataTestCase {
+
+    func testThatHeightsAreCachedByRow() {
+        let cache = WPTableViewRowHeightCache()
+        cache.setHeight(80, forRowAt: IndexPath(row: 3, section: 1), objectID: nil)
+
+        XCTAssertEqual(cache.heightForRow(at: IndexPath(row: 3, section: 1), objectID: nil), 80)
+        XCTAssertEqual(cache.heightForRow(at: IndexPath(row: 2, section: 1), objectID: nil), 0)
+        XCTAssertEqual(cache.heightForRow(at: IndexPath(row: 3, section: 0), objectID: nil), 0)
+    }
+
+    func testThatInvalidatedRowsAreRefilledByObjectID() {
+        let cache = WPTableViewRowHeightCache()
+        let objectIDs = makeObjectIDs(count: 3)
+        for (row, objectID) in objectIDs.enumerated() {
+            cache.setHeight(CGFloat(100 + row), forRowAt: IndexPath(row: row, section: 0), objectID: objectID)
+        }
+
+        // A row is inserted at the top: every row moves down one position.
+        cache.invalidateRows(from: IndexPath(row: 0, section: 0))
+
+        XCTAssertEqual(cache.heightForRow(at: IndexPath(row: 0, section: 0), objectID: nil), 0)
+        XCTAssertEqual(cache.heightForRow(at: IndexPath(row: 1, section: 0), objectID: objectIDs[0]), 100)
+        XCTAssertEqual(cache.heightForRow(at: IndexPath(row: 3, section: 0), objectID: objectIDs[2]), 102)
+        XCTAssertEqual(cache.heightForRow(at: IndexPath(row: 3, section: 0), objectID: nil), 102)
+    }
+
+    func testThatRemovedHeightsAreForgottenForEveryWidth() {
+        let cache = WPTableViewRowHeightCache()
+        let objectID = makeObjectIDs(count: 1)[0]
+        let indexPath = IndexPath(row: 0, section: 0)
+
+        cache.width = 320
+        cache.setHeight(120, forRowAt: indexPath, objectID: objectID)
+        cache.width = 640
+        cache.setHeight(60, forRowAt: indexPath, objectID: objectID)
+        cache.removeHeightForRow(at: indexPath, objectID: objectID)
+        cache.width = 320
+
+        XCTAssertEqual(cache.heightForRow(at: indexPath, objectID: objectID), 0)
+    }
+
+    func testThatHeightsAreBucketedByWidth() {
+        let cache = WPTableViewRowHeightCache()
+        cache.maximumWidthCount = 2
+        let objectID = makeObjectIDs(count: 1)[0]
+        let indexPath = IndexPath(row: 0, section: 0)
+
+        cache.width = 320
+        cache.setHeight(120, forRowAt: indexPath, objectID: objectID)
+        cache.width = 640
+        XCTAssertEqual(cache.heightForRow(at: indexPath, objectID: objectID), 0)
+        cache.setHeight(60, forRowAt: indexPath, objectID: objectID)
+
+        // Rotating back reuses the heights measured for the width.
+        cache.width = 320
+        XCTAssertEqual(cache.heightForRow(at: indexPath, objectID: objectID), 120)
+
+        // The least recently used width is dropped.
+        cache.width = 1024
+        cache.setHeight(40, forRowAt: indexPath, objectID: objectID)
+        cache.width = 640
+        XCTAssertEqual(cache.heightForRow(at: indexPath, objectID: objectID), 0)
+        cache.width = 1024
+        XCTAssertEqual(cache.heightForRow(at: indexPath, objectID: objectID), 40)
+    }
+
+    // MARK: - Helpers
+
+    private func makeObjectIDs(count: Int) -> [NSManagedObjectID] {
+        (0..<count).map { _ in BlogBuilder(mainContext).build().objectID }
+    }
+}
@@ -4,3 +4,11 @@
 
 #import "WordPress-Bridging-Header.h"
 #import "TestingAppDelegate.h"
+#import "WPTableViewRowHeightCache.h"
+
+@interface CommentService ()
+
+- (void)mergeComments:(nonnull NSArray *)comments forBlog:(nonnull Blog *)blog purgeExisting:(BOOL)purgeExisting;
+- (BOOL)mergeHierarchicalComments:(nonnull NSArray *)comments forPage:(NSUInteger)page forPost:(nonnull ReaderPost *)post;
+
+@end